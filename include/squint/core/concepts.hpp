@@ -15,6 +15,7 @@
 #include "squint/core/memory.hpp"
 #include "squint/util/sequence_utils.hpp"
 
+#include <complex>
 #include <concepts>
 #include <cstddef>
 #include <ratio>
@@ -109,6 +110,45 @@ concept floating_point = std::is_floating_point_v<T>;
 template <typename T>
 concept arithmetic = std::is_arithmetic_v<T>;
 
+/**
+ * @brief Type trait to check if a type is a complex number with a floating-point representation.
+ * @tparam T The type to check.
+ */
+template <typename T> struct is_complex : std::false_type {};
+template <typename T>
+    requires std::is_floating_point_v<T>
+struct is_complex<std::complex<T>> : std::true_type {};
+
+/**
+ * @brief Helper variable template for is_complex.
+ * @tparam T The type to check.
+ */
+template <typename T> inline constexpr bool is_complex_v = is_complex<T>::value;
+
+/**
+ * @concept complex_number
+ * @brief Concept for std::complex types with a floating-point representation.
+ *
+ * @tparam T The type to check.
+ */
+template <typename T>
+concept complex_number = is_complex_v<T>;
+
+/**
+ * @brief Type trait to check if a type is a dual number (see dual.hpp).
+ * @tparam T The type to check.
+ */
+template <typename T> struct is_dual : std::false_type {};
+
+/**
+ * @concept dual_number
+ * @brief Concept for dual numbers used in forward-mode automatic differentiation.
+ *
+ * @tparam T The type to check.
+ */
+template <typename T>
+concept dual_number = is_dual<T>::value;
+
 /**
  * @concept quantitative
  * @brief Concept for quantity types.
@@ -121,7 +161,8 @@ template <typename T>
 concept quantitative = requires(T t) {
     typename T::value_type;
     typename T::dimension_type;
-    requires arithmetic<typename T::value_type>;
+    requires arithmetic<typename T::value_type> || complex_number<typename T::value_type> ||
+                 dual_number<typename T::value_type>;
     { T::error_checking() } -> std::same_as<error_checking>;
 };
 
@@ -129,12 +170,12 @@ concept quantitative = requires(T t) {
  * @concept scalar
  * @brief Concept for scalar-like types.
  *
- * This concept includes both arithmetic types and quantitative types.
+ * This concept includes arithmetic types, complex types, dual numbers and quantitative types.
  *
  * @tparam T The type to check.
  */
 template <typename T>
-concept scalar = arithmetic<T> || quantitative<T>;
+concept scalar = arithmetic<T> || complex_number<T> || dual_number<T> || quantitative<T>;
 
 /**
  * @concept dimensionless_quantity
@@ -149,12 +190,12 @@ concept dimensionless_quantity = quantitative<T> && dimensionless<typename T::di
  * @concept dimensionless_scalar
  * @brief Concept for dimensionless scalar types.
  *
- * This concept includes both arithmetic types and dimensionless quantity types.
+ * This concept includes arithmetic types, complex types and dimensionless quantity types.
  *
  * @tparam T The type to check.
  */
 template <typename T>
-concept dimensionless_scalar = arithmetic<T> || dimensionless_quantity<T>;
+concept dimensionless_scalar = arithmetic<T> || complex_number<T> || dimensionless_quantity<T>;
 
 /**
  * @concept compile_time_shape
@@ -0,0 +1,246 @@
+/**
+ * @file dual.hpp
+ * @brief Dual numbers for forward-mode automatic differentiation.
+ *
+ * A dual<T, N> holds a value and its gradient with respect to N independent variables. Arithmetic
+ * and the elementary functions propagate gradients by the chain rule, so evaluating a function on
+ * dual numbers yields its value and its derivatives in a single pass. Dual numbers can be used as
+ * tensor elements and as the value type of quantities.
+ */
+#ifndef SQUINT_CORE_DUAL_HPP
+#define SQUINT_CORE_DUAL_HPP
+
+#include "squint/core/concepts.hpp"
+
+#include <array>
+#include <cmath>
+#include <compare>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+
+namespace squint {
+
+/**
+ * @brief A value together with its gradient with respect to N variables.
+ *
+ * The gradient is stored contiguously after the value, so operations update all derivative lanes
+ * with one loop that the compiler can vectorize.
+ *
+ * @tparam T The floating-point type of the value and derivatives.
+ * @tparam N The number of independent variables.
+ */
+template <floating_point T, std::size_t N> class dual {
+  public:
+    using value_type = T; ///< The type of the value and derivatives.
+
+    /// @brief Constructs zero.
+    constexpr dual() = default;
+
+    /**
+     * @brief Constructs a constant, whose derivatives are zero.
+     * @param value The value.
+     */
+    constexpr dual(T value) : value_(value) {} // NOLINT(google-explicit-constructor)
+
+    /**
+     * @brief Constructs a value with the given gradient.
+     * @param value The value.
+     * @param gradient The derivatives with respect to each variable.
+     */
+    constexpr dual(T value, const std::array<T, N> &gradient) : value_(value), gradient_(gradient) {}
+
+    /**
+     * @brief Constructs independent variable number index, whose derivative with respect to itself is one.
+     * @param value The value of the variable.
+     * @param index The index of the variable, less than N.
+     */
+    static constexpr auto variable(T value, std::size_t index) -> dual {
+        dual result(value);
+        result.gradient_[index] = T{1};
+        return result;
+    }
+
+    /// @brief Returns the number of derivative lanes.
+    static constexpr auto size() -> std::size_t { return N; }
+
+    /// @brief Returns the value.
+    [[nodiscard]] constexpr auto value() const -> const T & { return value_; }
+    /// @brief Returns the value.
+    [[nodiscard]] constexpr auto value() -> T & { return value_; }
+    /// @brief Returns the gradient.
+    [[nodiscard]] constexpr auto gradient() const -> const std::array<T, N> & { return gradient_; }
+    /// @brief Returns the gradient.
+    [[nodiscard]] constexpr auto gradient() -> std::array<T, N> & { return gradient_; }
+    /// @brief Returns the derivative with respect to variable i.
+    [[nodiscard]] constexpr auto derivative(std::size_t i) const -> T { return gradient_[i]; }
+
+    constexpr auto operator+=(const dual &other) -> dual & {
+        value_ += other.value_;
+        for (std::size_t i = 0; i < N; ++i) {
+            gradient_[i] += other.gradient_[i];
+        }
+        return *this;
+    }
+
+    constexpr auto operator-=(const dual &other) -> dual & {
+        value_ -= other.value_;
+        for (std::size_t i = 0; i < N; ++i) {
+            gradient_[i] -= other.gradient_[i];
+        }
+        return *this;
+    }
+
+    constexpr auto operator*=(const dual &other) -> dual & {
+        for (std::size_t i = 0; i < N; ++i) {
+            gradient_[i] = gradient_[i] * other.value_ + value_ * other.gradient_[i];
+        }
+        value_ *= other.value_;
+        return *this;
+    }
+
+    constexpr auto operator/=(const dual &other) -> dual & {
+        const T inverse = T{1} / other.value_;
+        value_ *= inverse;
+        for (std::size_t i = 0; i < N; ++i) {
+            gradient_[i] = (gradient_[i] - value_ * other.gradient_[i]) * inverse;
+        }
+        return *this;
+    }
+
+    constexpr auto operator+=(T s) -> dual & {
+        value_ += s;
+        return *this;
+    }
+
+    constexpr auto operator-=(T s) -> dual & {
+        value_ -= s;
+        return *this;
+    }
+
+    constexpr auto operator*=(T s) -> dual & {
+        value_ *= s;
+        for (auto &d : gradient_) {
+            d *= s;
+        }
+        return *this;
+    }
+
+    constexpr auto operator/=(T s) -> dual & { return *this *= T{1} / s; }
+
+    constexpr auto operator-() const -> dual {
+        dual result(-value_);
+        for (std::size_t i = 0; i < N; ++i) {
+            result.gradient_[i] = -gradient_[i];
+        }
+        return result;
+    }
+
+    /// @brief Compares values, ignoring derivatives.
+    constexpr auto operator==(const dual &other) const -> bool { return value_ == other.value_; }
+    /// @brief Orders by value, ignoring derivatives.
+    constexpr auto operator<=>(const dual &other) const { return value_ <=> other.value_; }
+
+  private:
+    T value_{};
+    std::array<T, N> gradient_{};
+};
+
+/// @brief Marks dual numbers for the dual_number concept.
+template <typename T, std::size_t N> struct is_dual<dual<T, N>> : std::true_type {};
+
+template <typename T, std::size_t N> constexpr auto operator+(dual<T, N> a, const dual<T, N> &b) { return a += b; }
+template <typename T, std::size_t N> constexpr auto operator-(dual<T, N> a, const dual<T, N> &b) { return a -= b; }
+template <typename T, std::size_t N> constexpr auto operator*(dual<T, N> a, const dual<T, N> &b) { return a *= b; }
+template <typename T, std::size_t N> constexpr auto operator/(dual<T, N> a, const dual<T, N> &b) { return a /= b; }
+// The scalar is non-deduced so that int literals such as 2 * x convert to T.
+template <typename T, std::size_t N>
+constexpr auto operator+(dual<T, N> a, std::type_identity_t<T> s) { return a += s; }
+template <typename T, std::size_t N>
+constexpr auto operator-(dual<T, N> a, std::type_identity_t<T> s) { return a -= s; }
+template <typename T, std::size_t N>
+constexpr auto operator*(dual<T, N> a, std::type_identity_t<T> s) { return a *= s; }
+template <typename T, std::size_t N>
+constexpr auto operator/(dual<T, N> a, std::type_identity_t<T> s) { return a /= s; }
+template <typename T, std::size_t N>
+constexpr auto operator+(std::type_identity_t<T> s, dual<T, N> a) { return a += s; }
+template <typename T, std::size_t N>
+constexpr auto operator-(std::type_identity_t<T> s, const dual<T, N> &a) { return -a + s; }
+template <typename T, std::size_t N>
+constexpr auto operator*(std::type_identity_t<T> s, dual<T, N> a) { return a *= s; }
+template <typename T, std::size_t N>
+constexpr auto operator/(std::type_identity_t<T> s, const dual<T, N> &a) {
+    return dual<T, N>(s) / a;
+}
+
+namespace detail {
+
+/**
+ * @brief Applies the chain rule: returns f(x) with derivative f'(x) times the gradient of x.
+ */
+template <typename T, std::size_t N> constexpr auto chain(const dual<T, N> &x, T value, T slope) -> dual<T, N> {
+    dual<T, N> result(value);
+    for (std::size_t i = 0; i < N; ++i) {
+        result.gradient()[i] = slope * x.gradient()[i];
+    }
+    return result;
+}
+
+} // namespace detail
+
+/// @brief Square root of a dual number.
+template <typename T, std::size_t N> auto sqrt(const dual<T, N> &x) -> dual<T, N> {
+    const T root = std::sqrt(x.value());
+    return detail::chain(x, root, T{1} / (2 * root));
+}
+
+/// @brief Exponential of a dual number.
+template <typename T, std::size_t N> auto exp(const dual<T, N> &x) -> dual<T, N> {
+    const T e = std::exp(x.value());
+    return detail::chain(x, e, e);
+}
+
+/// @brief Natural logarithm of a dual number.
+template <typename T, std::size_t N> auto log(const dual<T, N> &x) -> dual<T, N> {
+    return detail::chain(x, std::log(x.value()), T{1} / x.value());
+}
+
+/// @brief Sine of a dual number.
+template <typename T, std::size_t N> auto sin(const dual<T, N> &x) -> dual<T, N> {
+    return detail::chain(x, std::sin(x.value()), std::cos(x.value()));
+}
+
+/// @brief Cosine of a dual number.
+template <typename T, std::size_t N> auto cos(const dual<T, N> &x) -> dual<T, N> {
+    return detail::chain(x, std::cos(x.value()), -std::sin(x.value()));
+}
+
+/// @brief Tangent of a dual number.
+template <typename T, std::size_t N> auto tan(const dual<T, N> &x) -> dual<T, N> {
+    const T t = std::tan(x.value());
+    return detail::chain(x, t, T{1} + t * t);
+}
+
+/// @brief Dual number raised to a constant power.
+template <typename T, std::size_t N> auto pow(const dual<T, N> &x, std::type_identity_t<T> p) -> dual<T, N> {
+    const T power = std::pow(x.value(), p);
+    return detail::chain(x, power, p * std::pow(x.value(), p - 1));
+}
+
+/// @brief Absolute value of a dual number; the derivative at zero is taken from the positive side.
+template <typename T, std::size_t N> auto abs(const dual<T, N> &x) -> dual<T, N> {
+    return x.value() < 0 ? -x : x;
+}
+
+/// @brief Writes the value and gradient of a dual number to a stream.
+template <typename T, std::size_t N> auto operator<<(std::ostream &os, const dual<T, N> &x) -> std::ostream & {
+    os << x.value() << " [";
+    for (std::size_t i = 0; i < N; ++i) {
+        os << (i == 0 ? "" : ", ") << x.derivative(i);
+    }
+    return os << "]";
+}
+
+} // namespace squint
+
+#endif // SQUINT_CORE_DUAL_HPP
@@ -2,6 +2,10 @@
 #define SQUINT_GEOMETRY_HPP
 
 // NOLINTBEGIN
+#include "squint/geometry/bounding_volumes.hpp"
+#include "squint/geometry/kd_tree.hpp"
+#include "squint/geometry/mesh.hpp"
+#include "squint/geometry/registration.hpp"
 #include "squint/geometry/projections.hpp"
 #include "squint/geometry/transformations.hpp"
 // NOLINTEND
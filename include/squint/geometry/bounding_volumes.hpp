@@ -0,0 +1,440 @@
+/**
+ * @file bounding_volumes.hpp
+ * @brief Bounding volumes, view frustums and batched visibility culling.
+ *
+ * This file provides axis-aligned bounding boxes, bounding spheres and view frustums in the
+ * squint::geometry namespace. Frustum planes can be extracted from any projection (or
+ * view-projection) matrix, including the matrices produced by ortho() and perspective().
+ *
+ * In addition to the per-object tests, batched culling functions test thousands of volumes per
+ * call. The batched functions take N×3 tensors of centers/extents; column-major storage of an
+ * N×3 tensor is a structure-of-arrays layout, and the volumes are processed in blocks of 64 with
+ * branch-free inner loops so that the compiler can vectorize them. The result is a bitmask with
+ * one bit per volume.
+ */
+#ifndef SQUINT_GEOMETRY_BOUNDING_VOLUMES_HPP
+#define SQUINT_GEOMETRY_BOUNDING_VOLUMES_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/quantity/quantity_types.hpp"
+#include "squint/tensor/tensor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace squint::geometry {
+
+/**
+ * @brief Depth range of the clip space produced by a projection matrix.
+ *
+ * The projections in squint::geometry map depth to [0, w] (zero_to_one). Matrices following the
+ * OpenGL convention map depth to [-w, w] (negative_one_to_one).
+ */
+enum class clip_depth : uint8_t { zero_to_one, negative_one_to_one };
+
+/**
+ * @brief Bitmask with one bit per tested volume.
+ *
+ * Bit i of the mask is stored in word i / 64 at position i % 64.
+ */
+using cull_mask = std::vector<std::uint64_t>;
+
+/**
+ * @brief Tests a single bit of a culling mask.
+ * @param mask The mask returned by one of the batched culling functions.
+ * @param i The index of the volume.
+ * @return True if the bit for volume i is set.
+ */
+inline auto test_bit(const cull_mask &mask, std::size_t i) -> bool { return ((mask[i / 64] >> (i % 64)) & 1U) != 0; }
+
+/**
+ * @brief Axis-aligned bounding box.
+ * @tparam T The underlying scalar type for the length quantities.
+ */
+template <floating_point T> struct aabb {
+    tensor<length_t<T>, shape<3>> min; ///< The minimum corner.
+    tensor<length_t<T>, shape<3>> max; ///< The maximum corner.
+
+    /**
+     * @brief Returns the center of the box.
+     */
+    [[nodiscard]] auto center() const -> tensor<length_t<T>, shape<3>> {
+        tensor<length_t<T>, shape<3>> result;
+        for (std::size_t i = 0; i < 3; ++i) {
+            result(i) = (min(i) + max(i)) / T{2};
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the half extents of the box.
+     */
+    [[nodiscard]] auto extents() const -> tensor<length_t<T>, shape<3>> {
+        tensor<length_t<T>, shape<3>> result;
+        for (std::size_t i = 0; i < 3; ++i) {
+            result(i) = (max(i) - min(i)) / T{2};
+        }
+        return result;
+    }
+
+    /**
+     * @brief Checks if a point lies inside or on the boundary of the box.
+     * @param point The point to test.
+     */
+    [[nodiscard]] auto contains(const tensor<length_t<T>, shape<3>> &point) const -> bool {
+        for (std::size_t i = 0; i < 3; ++i) {
+            if (point(i) < min(i) || point(i) > max(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checks if two boxes overlap.
+     * @param other The other box.
+     */
+    [[nodiscard]] auto intersects(const aabb &other) const -> bool {
+        for (std::size_t i = 0; i < 3; ++i) {
+            if (other.max(i) < min(i) || other.min(i) > max(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Grows the box to contain a point.
+     * @param point The point to include.
+     */
+    void expand(const tensor<length_t<T>, shape<3>> &point) {
+        for (std::size_t i = 0; i < 3; ++i) {
+            min(i) = point(i) < min(i) ? point(i) : min(i);
+            max(i) = point(i) > max(i) ? point(i) : max(i);
+        }
+    }
+};
+
+/**
+ * @brief Bounding sphere.
+ * @tparam T The underlying scalar type for the length quantities.
+ */
+template <floating_point T> struct bounding_sphere {
+    tensor<length_t<T>, shape<3>> center; ///< The center of the sphere.
+    length_t<T> radius;                   ///< The radius of the sphere.
+
+    /**
+     * @brief Checks if a point lies inside or on the boundary of the sphere.
+     * @param point The point to test.
+     */
+    [[nodiscard]] auto contains(const tensor<length_t<T>, shape<3>> &point) const -> bool {
+        T d2{};
+        for (std::size_t i = 0; i < 3; ++i) {
+            T d = (point(i) - center(i)).value();
+            d2 += d * d;
+        }
+        return d2 <= radius.value() * radius.value();
+    }
+
+    /**
+     * @brief Checks if two spheres overlap.
+     * @param other The other sphere.
+     */
+    [[nodiscard]] auto intersects(const bounding_sphere &other) const -> bool {
+        T d2{};
+        for (std::size_t i = 0; i < 3; ++i) {
+            T d = (other.center(i) - center(i)).value();
+            d2 += d * d;
+        }
+        T r = (radius + other.radius).value();
+        return d2 <= r * r;
+    }
+};
+
+/**
+ * @brief View frustum described by six inward facing planes.
+ *
+ * Each plane is stored as a unit normal n and an offset d such that n·p + d is the signed
+ * distance of the point p from the plane; points with a non-negative distance to all six planes
+ * are inside the frustum. The planes are ordered left, right, bottom, top, near, far.
+ *
+ * @tparam T The underlying scalar type for the length quantities.
+ */
+template <floating_point T> class frustum {
+  public:
+    static constexpr std::size_t num_planes = 6;
+
+    frustum() = default;
+
+    /**
+     * @brief Constructs a frustum from plane normals and offsets.
+     * @param normals A 6x3 tensor where each row is an inward facing unit normal.
+     * @param offsets The signed plane offsets.
+     */
+    frustum(const tensor<T, shape<6, 3>> &normals, const tensor<length_t<T>, shape<6>> &offsets)
+        : normals_(normals), offsets_(offsets) {}
+
+    /**
+     * @brief Extracts the frustum planes from a projection or view-projection matrix.
+     *
+     * The planes are obtained from sums and differences of the matrix rows (Gribb-Hartmann) and
+     * normalized.
+     *
+     * @param matrix The 4x4 projection matrix.
+     * @param unit_length The unit length used when building the matrix (default is 1).
+     * @param depth The clip space depth range of the matrix.
+     * @return The frustum in the space the matrix is applied to.
+     */
+    static auto from_matrix(const tensor<T, shape<4, 4>> &matrix, length_t<T> unit_length = length_t<T>{1},
+                            clip_depth depth = clip_depth::zero_to_one) -> frustum {
+        // Each plane is row3 + sign * row_axis, except for the near plane in [0, w] depth.
+        constexpr std::array<std::size_t, num_planes> axis = {0, 0, 1, 1, 2, 2};
+        constexpr std::array<T, num_planes> sign = {T{1}, T{-1}, T{1}, T{-1}, T{1}, T{-1}};
+        frustum result;
+        for (std::size_t p = 0; p < num_planes; ++p) {
+            std::array<T, 4> plane{};
+            T w_weight = (p == 4 && depth == clip_depth::zero_to_one) ? T{0} : T{1};
+            for (std::size_t j = 0; j < 4; ++j) {
+                plane[j] = w_weight * matrix(3, j) + sign[p] * matrix(axis[p], j);
+            }
+            T length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            for (std::size_t j = 0; j < 3; ++j) {
+                result.normals_(p, j) = plane[j] / length;
+            }
+            result.offsets_(p) = unit_length * (plane[3] / length);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the 6x3 tensor of plane normals.
+     */
+    [[nodiscard]] auto normals() const -> const tensor<T, shape<6, 3>> & { return normals_; }
+
+    /**
+     * @brief Returns the plane offsets.
+     */
+    [[nodiscard]] auto offsets() const -> const tensor<length_t<T>, shape<6>> & { return offsets_; }
+
+    /**
+     * @brief Computes the signed distance of a point from one of the planes.
+     * @param plane The plane index.
+     * @param point The point.
+     */
+    [[nodiscard]] auto distance(std::size_t plane, const tensor<length_t<T>, shape<3>> &point) const -> length_t<T> {
+        return normals_(plane, 0) * point(0) + normals_(plane, 1) * point(1) + normals_(plane, 2) * point(2) +
+               offsets_(plane);
+    }
+
+    /**
+     * @brief Checks if a point is inside the frustum.
+     * @param point The point to test.
+     */
+    [[nodiscard]] auto contains(const tensor<length_t<T>, shape<3>> &point) const -> bool {
+        for (std::size_t p = 0; p < num_planes; ++p) {
+            if (distance(p, point).value() < T{0}) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checks if a bounding sphere is at least partially inside the frustum.
+     * @param sphere The sphere to test.
+     */
+    [[nodiscard]] auto intersects(const bounding_sphere<T> &sphere) const -> bool {
+        for (std::size_t p = 0; p < num_planes; ++p) {
+            if ((distance(p, sphere.center) + sphere.radius).value() < T{0}) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checks if a box is at least partially inside the frustum.
+     *
+     * The test is conservative: a box is only rejected when it lies entirely behind one of the
+     * planes.
+     *
+     * @param box The box to test.
+     */
+    [[nodiscard]] auto intersects(const aabb<T> &box) const -> bool {
+        auto c = box.center();
+        auto e = box.extents();
+        for (std::size_t p = 0; p < num_planes; ++p) {
+            T r = std::abs(normals_(p, 0)) * e(0).value() + std::abs(normals_(p, 1)) * e(1).value() +
+                  std::abs(normals_(p, 2)) * e(2).value();
+            if (distance(p, c).value() + r < T{0}) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    tensor<T, shape<6, 3>> normals_;
+    tensor<length_t<T>, shape<6>> offsets_;
+};
+
+namespace detail {
+
+// Returns a pointer to the raw values of a tensor of lengths.
+template <typename Tensor> auto raw_lengths(const Tensor &t) {
+    using value_type = typename Tensor::value_type::value_type;
+    return reinterpret_cast<const value_type *>(t.data());
+}
+
+// Checks that a batch tensor has the given number of rows and columns (cols == 1 means a vector).
+template <typename Tensor> void check_batch_shape(const Tensor &t, std::size_t rows, std::size_t cols) {
+    if constexpr (Tensor::error_checking() == error_checking::enabled) {
+        auto shape = t.shape();
+        bool ok = cols == 1 ? (shape.size() == 1 && shape[0] == rows)
+                            : (shape.size() == 2 && shape[0] == rows && shape[1] == cols);
+        if (!ok) {
+            throw std::invalid_argument("Batched volume tensors have incompatible shapes");
+        }
+    }
+}
+
+// Gathers up to 64 rows of an N×3 tensor into structure-of-arrays blocks.
+template <typename U>
+void load_block(const U *data, std::size_t row_stride, std::size_t col_stride, std::size_t begin, std::size_t count,
+                std::array<std::array<U, 64>, 3> &out) {
+    for (std::size_t c = 0; c < 3; ++c) {
+        const U *col = data + c * col_stride + begin * row_stride;
+        if (row_stride == 1) {
+            for (std::size_t i = 0; i < count; ++i) {
+                out[c][i] = col[i];
+            }
+        } else {
+            for (std::size_t i = 0; i < count; ++i) {
+                out[c][i] = col[i * row_stride];
+            }
+        }
+        for (std::size_t i = count; i < 64; ++i) {
+            out[c][i] = U{};
+        }
+    }
+}
+
+// Packs 64 visibility flags into one mask word.
+inline auto pack_block(const std::array<std::uint8_t, 64> &visible, std::size_t count) -> std::uint64_t {
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        word |= static_cast<std::uint64_t>(visible[i]) << i;
+    }
+    return word;
+}
+
+} // namespace detail
+
+/**
+ * @brief Tests a batch of axis-aligned boxes against a frustum.
+ *
+ * The boxes are given by their centers and half extents as N×3 tensors. Column-major tensors are
+ * read as structure-of-arrays without any gathering overhead.
+ *
+ * @param f The frustum.
+ * @param centers An N×3 tensor of box centers.
+ * @param extents An N×3 tensor of box half extents.
+ * @return A mask with bit i set if box i is at least partially inside the frustum.
+ * @throws std::invalid_argument if the shapes are incompatible and error checking is enabled.
+ */
+template <floating_point T, host_tensor C, host_tensor E>
+    requires std::is_same_v<typename C::value_type, length_t<T>> && std::is_same_v<typename E::value_type, length_t<T>>
+auto cull_aabbs(const frustum<T> &f, const C &centers, const E &extents) -> cull_mask {
+    const std::size_t n = centers.shape()[0];
+    detail::check_batch_shape(centers, n, 3);
+    detail::check_batch_shape(extents, n, 3);
+    const T *c_data = detail::raw_lengths(centers);
+    const T *e_data = detail::raw_lengths(extents);
+    auto c_strides = centers.strides();
+    auto e_strides = extents.strides();
+
+    cull_mask mask((n + 63) / 64, 0);
+    std::array<std::array<T, 64>, 3> c{};
+    std::array<std::array<T, 64>, 3> e{};
+    std::array<std::uint8_t, 64> visible{};
+    for (std::size_t block = 0; block < mask.size(); ++block) {
+        const std::size_t begin = block * 64;
+        const std::size_t count = std::min<std::size_t>(64, n - begin);
+        detail::load_block(c_data, c_strides[0], c_strides[1], begin, count, c);
+        detail::load_block(e_data, e_strides[0], e_strides[1], begin, count, e);
+        visible.fill(1);
+        for (std::size_t p = 0; p < frustum<T>::num_planes; ++p) {
+            const T nx = f.normals()(p, 0);
+            const T ny = f.normals()(p, 1);
+            const T nz = f.normals()(p, 2);
+            const T ax = std::abs(nx);
+            const T ay = std::abs(ny);
+            const T az = std::abs(nz);
+            const T d = f.offsets()(p).value();
+            for (std::size_t i = 0; i < 64; ++i) {
+                T s = nx * c[0][i] + ny * c[1][i] + nz * c[2][i] + d;
+                T r = ax * e[0][i] + ay * e[1][i] + az * e[2][i];
+                visible[i] &= static_cast<std::uint8_t>(s + r >= T{0});
+            }
+        }
+        mask[block] = detail::pack_block(visible, count);
+    }
+    return mask;
+}
+
+/**
+ * @brief Tests a batch of bounding spheres against a frustum.
+ *
+ * @param f The frustum.
+ * @param centers An N×3 tensor of sphere centers.
+ * @param radii A tensor of N sphere radii.
+ * @return A mask with bit i set if sphere i is at least partially inside the frustum.
+ * @throws std::invalid_argument if the shapes are incompatible and error checking is enabled.
+ */
+template <floating_point T, host_tensor C, host_tensor R>
+    requires std::is_same_v<typename C::value_type, length_t<T>> && std::is_same_v<typename R::value_type, length_t<T>>
+auto cull_spheres(const frustum<T> &f, const C &centers, const R &radii) -> cull_mask {
+    const std::size_t n = centers.shape()[0];
+    detail::check_batch_shape(centers, n, 3);
+    detail::check_batch_shape(radii, n, 1);
+    const T *c_data = detail::raw_lengths(centers);
+    const T *r_data = detail::raw_lengths(radii);
+    auto c_strides = centers.strides();
+    const std::size_t r_stride = radii.strides()[0];
+
+    cull_mask mask((n + 63) / 64, 0);
+    std::array<std::array<T, 64>, 3> c{};
+    std::array<T, 64> r{};
+    std::array<std::uint8_t, 64> visible{};
+    for (std::size_t block = 0; block < mask.size(); ++block) {
+        const std::size_t begin = block * 64;
+        const std::size_t count = std::min<std::size_t>(64, n - begin);
+        detail::load_block(c_data, c_strides[0], c_strides[1], begin, count, c);
+        for (std::size_t i = 0; i < 64; ++i) {
+            r[i] = i < count ? r_data[(begin + i) * r_stride] : T{};
+        }
+        visible.fill(1);
+        for (std::size_t p = 0; p < frustum<T>::num_planes; ++p) {
+            const T nx = f.normals()(p, 0);
+            const T ny = f.normals()(p, 1);
+            const T nz = f.normals()(p, 2);
+            const T d = f.offsets()(p).value();
+            for (std::size_t i = 0; i < 64; ++i) {
+                T s = nx * c[0][i] + ny * c[1][i] + nz * c[2][i] + d;
+                visible[i] &= static_cast<std::uint8_t>(s + r[i] >= T{0});
+            }
+        }
+        mask[block] = detail::pack_block(visible, count);
+    }
+    return mask;
+}
+
+} // namespace squint::geometry
+
+#endif // SQUINT_GEOMETRY_BOUNDING_VOLUMES_HPP
@@ -0,0 +1,424 @@
+/**
+ * @file kd_tree.hpp
+ * @brief Spatial index for nearest-neighbour and radius queries over point tensors.
+ *
+ * This file provides a k-d tree built from an N×3 tensor of length quantities. The points are
+ * copied into a reordered column-major N×3 tensor so that every node covers a contiguous range
+ * of rows, and the leaves are scanned as structure-of-arrays. Every node stores its bounding box,
+ * which is used to prune the search.
+ *
+ * The tree is built in parallel (the upper levels of the recursion run on separate threads) and
+ * the batched query functions distribute the queries across threads. Distances are returned as
+ * length quantities and indices refer to the rows of the tensor the tree was built from.
+ */
+#ifndef SQUINT_GEOMETRY_KD_TREE_HPP
+#define SQUINT_GEOMETRY_KD_TREE_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/layout.hpp"
+#include "squint/quantity/quantity_types.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace squint::geometry {
+
+/**
+ * @brief Result of a single nearest-neighbour or radius query.
+ * @tparam T The underlying scalar type for the length quantities.
+ */
+template <floating_point T> struct neighbors {
+    tensor<std::size_t, dynamic, dynamic> indices; ///< Indices of the neighbours in the original tensor.
+    tensor<length_t<T>, dynamic, dynamic> distances; ///< Distances to the neighbours, in ascending order.
+};
+
+/**
+ * @brief Result of a batched k-nearest-neighbour query.
+ *
+ * Row i of both tensors holds the neighbours of query i sorted by distance.
+ *
+ * @tparam T The underlying scalar type for the length quantities.
+ */
+template <floating_point T> struct knn_result {
+    tensor<std::size_t, dynamic, dynamic> indices;   ///< M×k tensor of neighbour indices.
+    tensor<length_t<T>, dynamic, dynamic> distances; ///< M×k tensor of neighbour distances.
+};
+
+/**
+ * @brief k-d tree over a set of 3D points.
+ * @tparam T The underlying scalar type for the length quantities.
+ */
+template <floating_point T> class kd_tree {
+  public:
+    using point_type = tensor<length_t<T>, shape<3>>;
+
+    /**
+     * @brief Builds a tree from an N×3 tensor of points.
+     * @param points The points, one per row.
+     * @param leaf_size The maximum number of points in a leaf.
+     * @throws std::invalid_argument if the points tensor is not N×3 or leaf_size is zero.
+     */
+    template <host_tensor P>
+        requires std::is_same_v<std::remove_const_t<typename P::value_type>, length_t<T>>
+    explicit kd_tree(const P &points, std::size_t leaf_size = 16) : leaf_size_(leaf_size) {
+        if (points.rank() != 2 || points.shape()[1] != 3) {
+            throw std::invalid_argument("kd_tree requires an N×3 tensor of points");
+        }
+        if (leaf_size_ == 0) {
+            throw std::invalid_argument("kd_tree leaf size must be positive");
+        }
+        const std::size_t n = points.shape()[0];
+        const T *data = reinterpret_cast<const T *>(points.data());
+        const auto &strides = points.strides();
+        std::array<std::vector<T>, 3> coords;
+        for (std::size_t c = 0; c < 3; ++c) {
+            coords[c].resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                coords[c][i] = data[i * strides[0] + c * strides[1]];
+            }
+        }
+        permutation_.resize(n);
+        std::iota(permutation_.begin(), permutation_.end(), std::size_t{0});
+        if (n > 0) {
+            nodes_.resize(count_nodes(n));
+            std::size_t depth = 0;
+            while ((std::size_t{1} << depth) < hardware_threads()) {
+                ++depth;
+            }
+            build(coords, 0, 0, n, depth);
+        }
+        // Store the points in tree order so that every node is a contiguous block of rows.
+        points_ = tensor<length_t<T>, dynamic, dynamic>({n, 3});
+        T *out = reinterpret_cast<T *>(points_.data());
+        for (std::size_t c = 0; c < 3; ++c) {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[c * n + i] = coords[c][permutation_[i]];
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of points in the tree.
+     */
+    [[nodiscard]] auto size() const -> std::size_t { return permutation_.size(); }
+
+    /**
+     * @brief Returns the points in tree order as a column-major N×3 tensor.
+     */
+    [[nodiscard]] auto points() const -> const tensor<length_t<T>, dynamic, dynamic> & { return points_; }
+
+    /**
+     * @brief Returns the original index of each point in tree order.
+     */
+    [[nodiscard]] auto permutation() const -> const std::vector<std::size_t> & { return permutation_; }
+
+    /**
+     * @brief Finds the k nearest neighbours of a point.
+     * @param query The query point.
+     * @param k The number of neighbours.
+     * @return The neighbours sorted by distance.
+     * @throws std::invalid_argument if k is larger than the number of points.
+     */
+    [[nodiscard]] auto nearest(const point_type &query, std::size_t k) const -> neighbors<T> {
+        check_k(k);
+        std::vector<std::pair<T, std::size_t>> heap;
+        std::vector<std::pair<std::size_t, T>> stack;
+        std::array<T, 3> q = {query(0).value(), query(1).value(), query(2).value()};
+        search_knn(q, k, heap, stack);
+        neighbors<T> result{tensor<std::size_t, dynamic, dynamic>({k}), tensor<length_t<T>, dynamic, dynamic>({k})};
+        for (std::size_t j = 0; j < k; ++j) {
+            result.indices(j) = permutation_[heap[j].second];
+            result.distances(j) = length_t<T>(std::sqrt(heap[j].first));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Finds all points within a radius of a point.
+     * @param query The query point.
+     * @param radius The search radius.
+     * @return The neighbours sorted by distance.
+     */
+    [[nodiscard]] auto within_radius(const point_type &query, length_t<T> radius) const -> neighbors<T> {
+        std::vector<std::pair<T, std::size_t>> found;
+        std::vector<std::size_t> stack;
+        std::array<T, 3> q = {query(0).value(), query(1).value(), query(2).value()};
+        search_radius(q, radius.value(), found, stack);
+        return make_neighbors(found);
+    }
+
+    /**
+     * @brief Finds the k nearest neighbours of every row of an M×3 tensor of queries.
+     *
+     * The queries are distributed across threads.
+     *
+     * @param queries The query points, one per row.
+     * @param k The number of neighbours per query.
+     * @return M×k tensors of indices and distances.
+     * @throws std::invalid_argument if the queries are not M×3 or k is larger than the number of points.
+     */
+    template <host_tensor Q>
+        requires std::is_same_v<std::remove_const_t<typename Q::value_type>, length_t<T>>
+    [[nodiscard]] auto knn(const Q &queries, std::size_t k) const -> knn_result<T> {
+        check_queries(queries);
+        check_k(k);
+        const std::size_t m = queries.shape()[0];
+        knn_result<T> result{tensor<std::size_t, dynamic, dynamic>({m, k}),
+                             tensor<length_t<T>, dynamic, dynamic>({m, k})};
+        const T *data = reinterpret_cast<const T *>(queries.data());
+        const auto &strides = queries.strides();
+        parallel_for(0, m, 64, [&](std::size_t begin, std::size_t end) {
+            std::vector<std::pair<T, std::size_t>> heap;
+            std::vector<std::pair<std::size_t, T>> stack;
+            for (std::size_t i = begin; i < end; ++i) {
+                std::array<T, 3> q = {data[i * strides[0]], data[i * strides[0] + strides[1]],
+                                      data[i * strides[0] + 2 * strides[1]]};
+                search_knn(q, k, heap, stack);
+                for (std::size_t j = 0; j < k; ++j) {
+                    result.indices(i, j) = permutation_[heap[j].second];
+                    result.distances(i, j) = length_t<T>(std::sqrt(heap[j].first));
+                }
+            }
+        });
+        return result;
+    }
+
+    /**
+     * @brief Finds all points within a radius of every row of an M×3 tensor of queries.
+     *
+     * The queries are distributed across threads.
+     *
+     * @param queries The query points, one per row.
+     * @param radius The search radius.
+     * @return The neighbours of each query sorted by distance.
+     * @throws std::invalid_argument if the queries are not M×3.
+     */
+    template <host_tensor Q>
+        requires std::is_same_v<std::remove_const_t<typename Q::value_type>, length_t<T>>
+    [[nodiscard]] auto within_radius(const Q &queries, length_t<T> radius) const -> std::vector<neighbors<T>> {
+        check_queries(queries);
+        const std::size_t m = queries.shape()[0];
+        std::vector<neighbors<T>> result(m);
+        const T *data = reinterpret_cast<const T *>(queries.data());
+        const auto &strides = queries.strides();
+        parallel_for(0, m, 64, [&](std::size_t begin, std::size_t end) {
+            std::vector<std::pair<T, std::size_t>> found;
+            std::vector<std::size_t> stack;
+            for (std::size_t i = begin; i < end; ++i) {
+                std::array<T, 3> q = {data[i * strides[0]], data[i * strides[0] + strides[1]],
+                                      data[i * strides[0] + 2 * strides[1]]};
+                search_radius(q, radius.value(), found, stack);
+                result[i] = make_neighbors(found);
+            }
+        });
+        return result;
+    }
+
+  private:
+    struct node {
+        std::array<T, 3> lo;
+        std::array<T, 3> hi;
+        std::size_t begin;
+        std::size_t end;
+        std::size_t right; // index of the right child, 0 for leaves; the left child follows the node
+    };
+
+    // Number of nodes in a subtree holding n points. Splits are at the middle index, so the shape
+    // of the tree only depends on n, which lets subtrees be built concurrently into fixed slots.
+    [[nodiscard]] auto count_nodes(std::size_t n) const -> std::size_t {
+        if (n <= leaf_size_) {
+            return 1;
+        }
+        return 1 + count_nodes(n / 2) + count_nodes(n - n / 2);
+    }
+
+    void build(const std::array<std::vector<T>, 3> &coords, std::size_t index, std::size_t begin, std::size_t end,
+               std::size_t parallel_depth) {
+        node &nd = nodes_[index];
+        nd.begin = begin;
+        nd.end = end;
+        nd.right = 0;
+        for (std::size_t c = 0; c < 3; ++c) {
+            auto [lo, hi] = std::minmax_element(
+                permutation_.begin() + static_cast<std::ptrdiff_t>(begin),
+                permutation_.begin() + static_cast<std::ptrdiff_t>(end),
+                [&](std::size_t a, std::size_t b) { return coords[c][a] < coords[c][b]; });
+            nd.lo[c] = coords[c][*lo];
+            nd.hi[c] = coords[c][*hi];
+        }
+        const std::size_t n = end - begin;
+        if (n <= leaf_size_) {
+            return;
+        }
+        std::size_t axis = 0;
+        for (std::size_t c = 1; c < 3; ++c) {
+            if (nd.hi[c] - nd.lo[c] > nd.hi[axis] - nd.lo[axis]) {
+                axis = c;
+            }
+        }
+        const std::size_t mid = begin + n / 2;
+        std::nth_element(permutation_.begin() + static_cast<std::ptrdiff_t>(begin),
+                         permutation_.begin() + static_cast<std::ptrdiff_t>(mid),
+                         permutation_.begin() + static_cast<std::ptrdiff_t>(end),
+                         [&](std::size_t a, std::size_t b) { return coords[axis][a] < coords[axis][b]; });
+        const std::size_t left = index + 1;
+        const std::size_t right = left + count_nodes(n / 2);
+        nd.right = right;
+        if (parallel_depth > 0 && n > 4096) {
+            std::thread worker([&] { build(coords, left, begin, mid, parallel_depth - 1); });
+            build(coords, right, mid, end, parallel_depth - 1);
+            worker.join();
+        } else {
+            build(coords, left, begin, mid, 0);
+            build(coords, right, mid, end, 0);
+        }
+    }
+
+    [[nodiscard]] auto box_distance2(const node &nd, const std::array<T, 3> &q) const -> T {
+        T d2{};
+        for (std::size_t c = 0; c < 3; ++c) {
+            T d = std::max({nd.lo[c] - q[c], T{0}, q[c] - nd.hi[c]});
+            d2 += d * d;
+        }
+        return d2;
+    }
+
+    // Computes the squared distances from a query to the points of a leaf.
+    void leaf_distances(const node &nd, const std::array<T, 3> &q, std::vector<T> &d2) const {
+        const std::size_t n = size();
+        const T *x = reinterpret_cast<const T *>(points_.data());
+        const T *y = x + n;
+        const T *z = y + n;
+        const std::size_t count = nd.end - nd.begin;
+        d2.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            T dx = x[nd.begin + i] - q[0];
+            T dy = y[nd.begin + i] - q[1];
+            T dz = z[nd.begin + i] - q[2];
+            d2[i] = dx * dx + dy * dy + dz * dz;
+        }
+    }
+
+    void search_knn(const std::array<T, 3> &q, std::size_t k, std::vector<std::pair<T, std::size_t>> &heap,
+                    std::vector<std::pair<std::size_t, T>> &stack) const {
+        heap.clear();
+        stack.clear();
+        if (k == 0) {
+            return;
+        }
+        thread_local std::vector<T> d2;
+        T worst = std::numeric_limits<T>::infinity();
+        stack.emplace_back(0, box_distance2(nodes_[0], q));
+        while (!stack.empty()) {
+            auto [index, box_d2] = stack.back();
+            stack.pop_back();
+            if (box_d2 > worst) {
+                continue;
+            }
+            const node &nd = nodes_[index];
+            if (nd.right == 0) {
+                leaf_distances(nd, q, d2);
+                for (std::size_t i = 0; i < d2.size(); ++i) {
+                    if (heap.size() < k) {
+                        heap.emplace_back(d2[i], nd.begin + i);
+                        std::push_heap(heap.begin(), heap.end());
+                    } else if (d2[i] < heap.front().first) {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.back() = {d2[i], nd.begin + i};
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                }
+                if (heap.size() == k) {
+                    worst = heap.front().first;
+                }
+                continue;
+            }
+            const std::size_t left = index + 1;
+            T left_d2 = box_distance2(nodes_[left], q);
+            T right_d2 = box_distance2(nodes_[nd.right], q);
+            // Push the farther child first so that the nearer one is searched first.
+            if (left_d2 <= right_d2) {
+                stack.emplace_back(nd.right, right_d2);
+                stack.emplace_back(left, left_d2);
+            } else {
+                stack.emplace_back(left, left_d2);
+                stack.emplace_back(nd.right, right_d2);
+            }
+        }
+        std::sort_heap(heap.begin(), heap.end());
+    }
+
+    void search_radius(const std::array<T, 3> &q, T radius, std::vector<std::pair<T, std::size_t>> &found,
+                       std::vector<std::size_t> &stack) const {
+        found.clear();
+        stack.clear();
+        if (nodes_.empty()) {
+            return;
+        }
+        thread_local std::vector<T> d2;
+        const T r2 = radius * radius;
+        stack.push_back(0);
+        while (!stack.empty()) {
+            const node &nd = nodes_[stack.back()];
+            const std::size_t index = stack.back();
+            stack.pop_back();
+            if (box_distance2(nd, q) > r2) {
+                continue;
+            }
+            if (nd.right == 0) {
+                leaf_distances(nd, q, d2);
+                for (std::size_t i = 0; i < d2.size(); ++i) {
+                    if (d2[i] <= r2) {
+                        found.emplace_back(d2[i], nd.begin + i);
+                    }
+                }
+                continue;
+            }
+            stack.push_back(nd.right);
+            stack.push_back(index + 1);
+        }
+        std::sort(found.begin(), found.end());
+    }
+
+    [[nodiscard]] auto make_neighbors(const std::vector<std::pair<T, std::size_t>> &found) const -> neighbors<T> {
+        neighbors<T> result{tensor<std::size_t, dynamic, dynamic>({found.size()}),
+                            tensor<length_t<T>, dynamic, dynamic>({found.size()})};
+        for (std::size_t j = 0; j < found.size(); ++j) {
+            result.indices(j) = permutation_[found[j].second];
+            result.distances(j) = length_t<T>(std::sqrt(found[j].first));
+        }
+        return result;
+    }
+
+    void check_k(std::size_t k) const {
+        if (k > size()) {
+            throw std::invalid_argument("kd_tree: k is larger than the number of points");
+        }
+    }
+
+    template <typename Q> void check_queries(const Q &queries) const {
+        if (queries.rank() != 2 || queries.shape()[1] != 3) {
+            throw std::invalid_argument("kd_tree queries must be an M×3 tensor of points");
+        }
+    }
+
+    std::size_t leaf_size_;
+    std::vector<node> nodes_;
+    std::vector<std::size_t> permutation_;
+    tensor<length_t<T>, dynamic, dynamic> points_;
+};
+
+} // namespace squint::geometry
+
+#endif // SQUINT_GEOMETRY_KD_TREE_HPP
@@ -0,0 +1,441 @@
+/**
+ * @file mesh.hpp
+ * @brief Batched vector and triangle-mesh kernels over N×3 tensors.
+ *
+ * This file provides batched cross products and normalization over the rows of N×3 tensors, and
+ * per-face normals, areas and centroids as well as area-weighted vertex normals for triangle
+ * meshes. Meshes can be given either as a V×3 tensor of vertex positions with an F×3 tensor of
+ * vertex indices, or as three F×3 tensors holding the corners of each triangle.
+ *
+ * The kernels run over contiguous chunks of rows on several threads. Column-major N×3 tensors
+ * are read as structure-of-arrays with unit stride, which lets the inner loops vectorize. The
+ * results are dynamic column-major tensors with value types derived from the inputs, for example
+ * the area of a mesh with vertices in length_t is returned in area_t.
+ */
+#ifndef SQUINT_GEOMETRY_MESH_HPP
+#define SQUINT_GEOMETRY_MESH_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/tensor/tensor_op_compatibility.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace squint::geometry {
+
+namespace detail {
+
+// Minimum number of rows processed by one thread.
+inline constexpr std::size_t mesh_grain = 8192;
+
+// Read-only view of the rows of an N×3 tensor as raw values of its underlying arithmetic type.
+template <typename Tensor> struct row_reader {
+    using value_type = blas_type_t<std::remove_const_t<typename Tensor::value_type>>;
+
+    explicit row_reader(const Tensor &t)
+        : data(reinterpret_cast<const value_type *>(t.data())), row_stride(t.strides()[0]),
+          col_stride(t.strides()[1]) {}
+
+    [[nodiscard]] auto operator()(std::size_t i, std::size_t c) const -> value_type {
+        return data[i * row_stride + c * col_stride];
+    }
+
+    [[nodiscard]] auto row(std::size_t i) const -> std::array<value_type, 3> {
+        return {data[i * row_stride], data[i * row_stride + col_stride], data[i * row_stride + 2 * col_stride]};
+    }
+
+    const value_type *data;
+    std::size_t row_stride;
+    std::size_t col_stride;
+};
+
+// Checks that a tensor is N×3 (or N when cols is 1) with the given number of rows.
+template <typename Tensor> void check_rows(const Tensor &t, std::size_t rows, std::size_t cols) {
+    if constexpr (Tensor::error_checking() == error_checking::enabled) {
+        const auto &shape = t.shape();
+        bool ok = cols == 1 ? (shape.size() == 1 && shape[0] == rows)
+                            : (shape.size() == 2 && shape[0] == rows && shape[1] == cols);
+        if (!ok) {
+            throw std::invalid_argument("Batched tensors must be N×3 with matching numbers of rows");
+        }
+    }
+}
+
+// Writes rows into a column-major N×3 tensor of raw values.
+template <typename U> struct row_writer {
+    U *data;
+    std::size_t rows;
+
+    void operator()(std::size_t i, const std::array<U, 3> &v) const {
+        data[i] = v[0];
+        data[rows + i] = v[1];
+        data[2 * rows + i] = v[2];
+    }
+};
+
+template <typename U> auto cross3(const std::array<U, 3> &a, const std::array<U, 3> &b) -> std::array<U, 3> {
+    return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+}
+
+template <typename U> auto sub3(const std::array<U, 3> &a, const std::array<U, 3> &b) -> std::array<U, 3> {
+    return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+
+// Scales a vector to unit length; zero vectors are left unchanged.
+template <typename U> auto unit3(const std::array<U, 3> &a) -> std::array<U, 3> {
+    U len = std::sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+    U inv = len > U{0} ? U{1} / len : U{0};
+    return {a[0] * inv, a[1] * inv, a[2] * inv};
+}
+
+// Corner positions of indexed triangles. With error checking, every face index is validated up front,
+// before any kernel reads a vertex through it.
+template <typename Vertices, typename Faces> struct indexed_triangles {
+    indexed_triangles(const Vertices &vertices, const Faces &faces)
+        : positions(vertices), indices(faces.data()), row_stride(faces.strides()[0]), col_stride(faces.strides()[1]),
+          count(faces.shape()[0]) {
+        check_rows(faces, count, 3);
+        if constexpr (Vertices::error_checking() == error_checking::enabled) {
+            if (vertices.rank() != 2 || vertices.shape()[1] != 3) {
+                throw std::invalid_argument("Vertex positions must be stored in a V×3 tensor");
+            }
+        }
+        if constexpr (Vertices::error_checking() == error_checking::enabled ||
+                      Faces::error_checking() == error_checking::enabled) {
+            const std::size_t num_vertices = vertices.shape()[0];
+            for (std::size_t f = 0; f < count; ++f) {
+                for (std::size_t k = 0; k < 3; ++k) {
+                    if (!valid_index(indices[f * row_stride + k * col_stride], num_vertices)) {
+                        throw std::out_of_range("Face index out of range");
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename I> static auto valid_index(I index, std::size_t num_vertices) -> bool {
+        if constexpr (std::is_signed_v<I>) {
+            if (index < 0) {
+                return false;
+            }
+        }
+        return static_cast<std::size_t>(index) < num_vertices;
+    }
+
+    [[nodiscard]] auto vertex(std::size_t f, std::size_t k) const -> std::size_t {
+        return static_cast<std::size_t>(indices[f * row_stride + k * col_stride]);
+    }
+
+    [[nodiscard]] auto corners(std::size_t f) const {
+        return std::array{positions.row(vertex(f, 0)), positions.row(vertex(f, 1)), positions.row(vertex(f, 2))};
+    }
+
+    row_reader<Vertices> positions;
+    const std::remove_const_t<typename Faces::value_type> *indices;
+    std::size_t row_stride;
+    std::size_t col_stride;
+    std::size_t count;
+};
+
+// Corner positions of triangles given as three N×3 tensors.
+template <typename A, typename B, typename C> struct triangle_soup {
+    triangle_soup(const A &first, const B &second, const C &third)
+        : a(first), b(second), c(third), count(first.shape()[0]) {
+        check_rows(first, count, 3);
+        check_rows(second, count, 3);
+        check_rows(third, count, 3);
+    }
+
+    [[nodiscard]] auto corners(std::size_t f) const { return std::array{a.row(f), b.row(f), c.row(f)}; }
+
+    row_reader<A> a;
+    row_reader<B> b;
+    row_reader<C> c;
+    std::size_t count;
+};
+
+template <typename Triangles> auto face_normals_impl(const Triangles &tris) {
+    using U = typename decltype(tris.corners(0))::value_type::value_type;
+    tensor<U, dynamic, dynamic> result({tris.count, 3});
+    row_writer<U> out{result.data(), tris.count};
+    parallel_for(0, tris.count, mesh_grain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t f = begin; f < end; ++f) {
+            auto p = tris.corners(f);
+            out(f, unit3(cross3(sub3(p[1], p[0]), sub3(p[2], p[0]))));
+        }
+    });
+    return result;
+}
+
+template <typename R, typename Triangles> auto face_areas_impl(const Triangles &tris) {
+    using U = typename decltype(tris.corners(0))::value_type::value_type;
+    tensor<R, dynamic, dynamic> result({tris.count});
+    U *out = reinterpret_cast<U *>(result.data());
+    parallel_for(0, tris.count, mesh_grain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t f = begin; f < end; ++f) {
+            auto p = tris.corners(f);
+            auto n = cross3(sub3(p[1], p[0]), sub3(p[2], p[0]));
+            out[f] = U{0.5} * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        }
+    });
+    return result;
+}
+
+template <typename R, typename Triangles> auto face_centroids_impl(const Triangles &tris) {
+    using U = typename decltype(tris.corners(0))::value_type::value_type;
+    tensor<R, dynamic, dynamic> result({tris.count, 3});
+    row_writer<U> out{reinterpret_cast<U *>(result.data()), tris.count};
+    parallel_for(0, tris.count, mesh_grain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t f = begin; f < end; ++f) {
+            auto p = tris.corners(f);
+            out(f, {(p[0][0] + p[1][0] + p[2][0]) / U{3}, (p[0][1] + p[1][1] + p[2][1]) / U{3},
+                    (p[0][2] + p[1][2] + p[2][2]) / U{3}});
+        }
+    });
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief Computes the cross products of corresponding rows of two N×3 tensors.
+ * @param a The first N×3 tensor.
+ * @param b The second N×3 tensor.
+ * @return An N×3 tensor whose row i is the cross product of row i of a and b.
+ * @throws std::invalid_argument if the shapes are incompatible and error checking is enabled.
+ */
+template <host_tensor T1, host_tensor T2> auto batched_cross(const T1 &a, const T2 &b) {
+    using result_value_type = std::remove_const_t<decltype(std::declval<typename T1::value_type>() *
+                                                           std::declval<typename T2::value_type>())>;
+    using U = blas_type_t<result_value_type>;
+    const std::size_t n = a.shape()[0];
+    detail::check_rows(a, n, 3);
+    detail::check_rows(b, n, 3);
+    detail::row_reader<T1> ra(a);
+    detail::row_reader<T2> rb(b);
+    tensor<result_value_type, dynamic, dynamic> result({n, 3});
+    U *out = reinterpret_cast<U *>(result.data());
+    parallel_for(0, n, detail::mesh_grain, [&](std::size_t begin, std::size_t end) {
+        if (ra.row_stride == 1 && rb.row_stride == 1) {
+            // Unit-stride columns: plain loops over structure-of-arrays data
+            const auto *ax = ra.data;
+            const auto *ay = ra.data + ra.col_stride;
+            const auto *az = ra.data + 2 * ra.col_stride;
+            const auto *bx = rb.data;
+            const auto *by = rb.data + rb.col_stride;
+            const auto *bz = rb.data + 2 * rb.col_stride;
+            for (std::size_t i = begin; i < end; ++i) {
+                out[i] = ay[i] * bz[i] - az[i] * by[i];
+                out[n + i] = az[i] * bx[i] - ax[i] * bz[i];
+                out[2 * n + i] = ax[i] * by[i] - ay[i] * bx[i];
+            }
+        } else {
+            detail::row_writer<U> write{out, n};
+            for (std::size_t i = begin; i < end; ++i) {
+                write(i, detail::cross3<U>({ra(i, 0), ra(i, 1), ra(i, 2)}, {rb(i, 0), rb(i, 1), rb(i, 2)}));
+            }
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Scales every row of an N×3 tensor to unit length.
+ *
+ * Rows with zero length are returned as zero vectors.
+ *
+ * @param a The N×3 tensor.
+ * @return A dimensionless N×3 tensor of unit vectors.
+ * @throws std::invalid_argument if the tensor is not N×3 and error checking is enabled.
+ */
+template <host_tensor T> auto batched_normalize(const T &a) {
+    using U = blas_type_t<std::remove_const_t<typename T::value_type>>;
+    const std::size_t n = a.shape()[0];
+    detail::check_rows(a, n, 3);
+    detail::row_reader<T> ra(a);
+    tensor<U, dynamic, dynamic> result({n, 3});
+    U *out = result.data();
+    parallel_for(0, n, detail::mesh_grain, [&](std::size_t begin, std::size_t end) {
+        if (ra.row_stride == 1) {
+            const U *x = ra.data;
+            const U *y = ra.data + ra.col_stride;
+            const U *z = ra.data + 2 * ra.col_stride;
+            for (std::size_t i = begin; i < end; ++i) {
+                U len = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+                U inv = len > U{0} ? U{1} / len : U{0};
+                out[i] = x[i] * inv;
+                out[n + i] = y[i] * inv;
+                out[2 * n + i] = z[i] * inv;
+            }
+        } else {
+            detail::row_writer<U> write{out, n};
+            for (std::size_t i = begin; i < end; ++i) {
+                write(i, detail::unit3(ra.row(i)));
+            }
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Computes the unit normals of indexed triangles.
+ *
+ * Normals follow the counter-clockwise winding of the corners.
+ *
+ * @param vertices A V×3 tensor of vertex positions.
+ * @param faces An F×3 tensor of integer vertex indices.
+ * @return A dimensionless F×3 tensor of unit normals.
+ * @throws std::out_of_range if a face index is not a vertex (when error checking is enabled).
+ */
+template <host_tensor V, host_tensor F>
+    requires std::is_integral_v<std::remove_const_t<typename F::value_type>>
+auto face_normals(const V &vertices, const F &faces) {
+    return detail::face_normals_impl(detail::indexed_triangles<V, F>(vertices, faces));
+}
+
+/**
+ * @brief Computes the unit normals of triangles given by their corners.
+ * @param a An N×3 tensor of first corners.
+ * @param b An N×3 tensor of second corners.
+ * @param c An N×3 tensor of third corners.
+ * @return A dimensionless N×3 tensor of unit normals.
+ */
+template <host_tensor A, host_tensor B, host_tensor C> auto face_normals(const A &a, const B &b, const C &c) {
+    return detail::face_normals_impl(detail::triangle_soup<A, B, C>(a, b, c));
+}
+
+/**
+ * @brief Computes the areas of indexed triangles.
+ * @param vertices A V×3 tensor of vertex positions.
+ * @param faces An F×3 tensor of integer vertex indices.
+ * @return A tensor of F areas, with the square of the vertex value type (area_t for lengths).
+ * @throws std::out_of_range if a face index is not a vertex (when error checking is enabled).
+ */
+template <host_tensor V, host_tensor F>
+    requires std::is_integral_v<std::remove_const_t<typename F::value_type>>
+auto face_areas(const V &vertices, const F &faces) {
+    using value_type = std::remove_const_t<typename V::value_type>;
+    using area_type = decltype(std::declval<value_type>() * std::declval<value_type>());
+    return detail::face_areas_impl<area_type>(detail::indexed_triangles<V, F>(vertices, faces));
+}
+
+/**
+ * @brief Computes the areas of triangles given by their corners.
+ * @param a An N×3 tensor of first corners.
+ * @param b An N×3 tensor of second corners.
+ * @param c An N×3 tensor of third corners.
+ * @return A tensor of N areas, with the square of the corner value type (area_t for lengths).
+ */
+template <host_tensor A, host_tensor B, host_tensor C> auto face_areas(const A &a, const B &b, const C &c) {
+    using value_type = std::remove_const_t<typename A::value_type>;
+    using area_type = decltype(std::declval<value_type>() * std::declval<value_type>());
+    return detail::face_areas_impl<area_type>(detail::triangle_soup<A, B, C>(a, b, c));
+}
+
+/**
+ * @brief Computes the centroids of indexed triangles.
+ * @param vertices A V×3 tensor of vertex positions.
+ * @param faces An F×3 tensor of integer vertex indices.
+ * @return An F×3 tensor of centroids with the vertex value type.
+ * @throws std::out_of_range if a face index is not a vertex (when error checking is enabled).
+ */
+template <host_tensor V, host_tensor F>
+    requires std::is_integral_v<std::remove_const_t<typename F::value_type>>
+auto face_centroids(const V &vertices, const F &faces) {
+    using value_type = std::remove_const_t<typename V::value_type>;
+    return detail::face_centroids_impl<value_type>(detail::indexed_triangles<V, F>(vertices, faces));
+}
+
+/**
+ * @brief Computes the centroids of triangles given by their corners.
+ * @param a An N×3 tensor of first corners.
+ * @param b An N×3 tensor of second corners.
+ * @param c An N×3 tensor of third corners.
+ * @return An N×3 tensor of centroids with the corner value type.
+ */
+template <host_tensor A, host_tensor B, host_tensor C> auto face_centroids(const A &a, const B &b, const C &c) {
+    using value_type = std::remove_const_t<typename A::value_type>;
+    return detail::face_centroids_impl<value_type>(detail::triangle_soup<A, B, C>(a, b, c));
+}
+
+/**
+ * @brief Computes area-weighted vertex normals of an indexed triangle mesh.
+ *
+ * The normal of each vertex is the normalized sum of the (area scaled) normals of the faces that
+ * use it. The face contributions are computed in parallel and then gathered per vertex through
+ * a vertex-to-face adjacency list, so the result does not depend on the number of threads.
+ * Vertices that are not used by any face get a zero normal.
+ *
+ * @param vertices A V×3 tensor of vertex positions.
+ * @param faces An F×3 tensor of integer vertex indices.
+ * @return A dimensionless V×3 tensor of unit normals.
+ * @throws std::out_of_range if a face index is not a vertex.
+ */
+template <host_tensor V, host_tensor F>
+    requires std::is_integral_v<std::remove_const_t<typename F::value_type>>
+auto vertex_normals(const V &vertices, const F &faces) {
+    using U = blas_type_t<std::remove_const_t<typename V::value_type>>;
+    detail::indexed_triangles<V, F> tris(vertices, faces);
+    const std::size_t num_vertices = vertices.shape()[0];
+    const std::size_t num_faces = tris.count;
+
+    // Vertex-to-face adjacency in compressed row form. It is counted before any vertex is read, and
+    // checks the indices even without error checking since they are used to index the adjacency.
+    std::vector<std::size_t> offsets(num_vertices + 1, 0);
+    for (std::size_t f = 0; f < num_faces; ++f) {
+        for (std::size_t k = 0; k < 3; ++k) {
+            std::size_t v = tris.vertex(f, k);
+            if (v >= num_vertices) {
+                throw std::out_of_range("Face index out of range");
+            }
+            ++offsets[v + 1];
+        }
+    }
+
+    // Unnormalized face normals; their length is twice the face area.
+    std::vector<std::array<U, 3>> weighted(num_faces);
+    parallel_for(0, num_faces, detail::mesh_grain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t f = begin; f < end; ++f) {
+            auto p = tris.corners(f);
+            weighted[f] = detail::cross3(detail::sub3(p[1], p[0]), detail::sub3(p[2], p[0]));
+        }
+    });
+    for (std::size_t v = 0; v < num_vertices; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<std::size_t> adjacency(offsets.back());
+    std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t f = 0; f < num_faces; ++f) {
+        for (std::size_t k = 0; k < 3; ++k) {
+            adjacency[fill[tris.vertex(f, k)]++] = f;
+        }
+    }
+
+    tensor<U, dynamic, dynamic> result({num_vertices, 3});
+    detail::row_writer<U> out{result.data(), num_vertices};
+    parallel_for(0, num_vertices, detail::mesh_grain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t v = begin; v < end; ++v) {
+            std::array<U, 3> n{};
+            for (std::size_t j = offsets[v]; j < offsets[v + 1]; ++j) {
+                const auto &w = weighted[adjacency[j]];
+                n[0] += w[0];
+                n[1] += w[1];
+                n[2] += w[2];
+            }
+            out(v, detail::unit3(n));
+        }
+    });
+    return result;
+}
+
+} // namespace squint::geometry
+
+#endif // SQUINT_GEOMETRY_MESH_HPP
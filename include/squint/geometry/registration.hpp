@@ -0,0 +1,355 @@
+/**
+ * @file registration.hpp
+ * @brief Rigid and similarity registration of corresponding point sets.
+ *
+ * This file provides kabsch() and umeyama(), which find the rotation, translation and (for
+ * umeyama) uniform scale that best align a set of points to a set of corresponding points in the
+ * least squares sense. The centroids and the 3x3 cross-covariance are accumulated in a single
+ * pass over the data, split across threads, and the rotation is obtained from a fixed-size 3x3
+ * singular value decomposition.
+ */
+#ifndef SQUINT_GEOMETRY_REGISTRATION_HPP
+#define SQUINT_GEOMETRY_REGISTRATION_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/quantity/quantity_types.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace squint::geometry {
+
+/**
+ * @brief Rigid (or similarity) transform mapping p to scale * rotation * p + translation.
+ * @tparam T The underlying scalar type for the length quantities.
+ */
+template <floating_point T> struct rigid_transform {
+    tensor<T, shape<3, 3>> rotation;           ///< The rotation matrix.
+    tensor<length_t<T>, shape<3>> translation; ///< The translation.
+    T scale{1};                                ///< The uniform scale factor (1 for rigid transforms).
+
+    /**
+     * @brief Applies the transform to a point.
+     * @param point The point to transform.
+     * @return The transformed point.
+     */
+    [[nodiscard]] auto apply(const tensor<length_t<T>, shape<3>> &point) const -> tensor<length_t<T>, shape<3>> {
+        tensor<length_t<T>, shape<3>> result;
+        for (std::size_t i = 0; i < 3; ++i) {
+            result(i) = translation(i) + scale * (rotation(i, 0) * point(0) + rotation(i, 1) * point(1) +
+                                                  rotation(i, 2) * point(2));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the transform as a 4x4 transformation matrix.
+     * @param unit_length The unit length for the translation (default is 1).
+     * @return A 4x4 matrix compatible with translate(), rotate() and scale().
+     */
+    [[nodiscard]] auto matrix(length_t<T> unit_length = length_t<T>{1}) const -> tensor<T, shape<4, 4>> {
+        auto result = tensor<T, shape<4, 4>>::eye();
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                result(i, j) = scale * rotation(i, j);
+            }
+            result(i, 3) = translation(i) / unit_length;
+        }
+        return result;
+    }
+};
+
+namespace detail {
+
+// Moments gathered in the single pass over the point sets. Points are shifted by the first pair
+// to reduce cancellation when the clouds are far from the origin.
+template <typename A> struct registration_moments {
+    std::size_t count = 0;
+    std::array<A, 3> sum_p{};
+    std::array<A, 3> sum_q{};
+    std::array<A, 9> sum_pq{}; // column-major sum of p q^T
+    A sum_p2{};
+
+    auto operator+(const registration_moments &other) const -> registration_moments {
+        registration_moments result = *this;
+        result.count += other.count;
+        for (std::size_t i = 0; i < 3; ++i) {
+            result.sum_p[i] += other.sum_p[i];
+            result.sum_q[i] += other.sum_q[i];
+        }
+        for (std::size_t i = 0; i < 9; ++i) {
+            result.sum_pq[i] += other.sum_pq[i];
+        }
+        result.sum_p2 += other.sum_p2;
+        return result;
+    }
+};
+
+// Singular value decomposition of a 3x3 column-major matrix, H = U diag(s) V^T, with singular
+// values in descending order. V is obtained from a cyclic Jacobi eigendecomposition of H^T H and
+// U from H V, completing the basis with cross products when H is rank deficient.
+template <typename A> struct svd3_result {
+    std::array<A, 9> u;
+    std::array<A, 3> s;
+    std::array<A, 9> v;
+};
+
+template <typename A> auto svd3(const std::array<A, 9> &h) -> svd3_result<A> {
+    auto at = [](const std::array<A, 9> &m, std::size_t i, std::size_t j) -> A { return m[i + 3 * j]; };
+    std::array<A, 9> b{};
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            b[i + 3 * j] = at(h, 0, i) * at(h, 0, j) + at(h, 1, i) * at(h, 1, j) + at(h, 2, i) * at(h, 2, j);
+        }
+    }
+    std::array<A, 9> v = {A{1}, A{0}, A{0}, A{0}, A{1}, A{0}, A{0}, A{0}, A{1}};
+    constexpr std::array<std::pair<std::size_t, std::size_t>, 3> pairs = {{{0, 1}, {0, 2}, {1, 2}}};
+    for (int sweep = 0; sweep < 32; ++sweep) {
+        A off = b[3] * b[3] + b[6] * b[6] + b[7] * b[7];
+        A diag = b[0] * b[0] + b[4] * b[4] + b[8] * b[8];
+        if (off <= std::numeric_limits<A>::epsilon() * std::numeric_limits<A>::epsilon() * diag) {
+            break;
+        }
+        for (auto [p, q] : pairs) {
+            A bpq = b[p + 3 * q];
+            if (bpq == A{0}) {
+                continue;
+            }
+            A theta = (b[q + 3 * q] - b[p + 3 * p]) / (A{2} * bpq);
+            A t = std::copysign(A{1}, theta) / (std::abs(theta) + std::sqrt(theta * theta + A{1}));
+            A c = A{1} / std::sqrt(t * t + A{1});
+            A s = t * c;
+            // B <- J^T B J and V <- V J for the rotation J in the (p, q) plane
+            for (std::size_t k = 0; k < 3; ++k) {
+                A bkp = b[k + 3 * p];
+                A bkq = b[k + 3 * q];
+                b[k + 3 * p] = c * bkp - s * bkq;
+                b[k + 3 * q] = s * bkp + c * bkq;
+            }
+            for (std::size_t k = 0; k < 3; ++k) {
+                A bpk = b[p + 3 * k];
+                A bqk = b[q + 3 * k];
+                b[p + 3 * k] = c * bpk - s * bqk;
+                b[q + 3 * k] = s * bpk + c * bqk;
+            }
+            for (std::size_t k = 0; k < 3; ++k) {
+                A vkp = v[k + 3 * p];
+                A vkq = v[k + 3 * q];
+                v[k + 3 * p] = c * vkp - s * vkq;
+                v[k + 3 * q] = s * vkp + c * vkq;
+            }
+        }
+    }
+    // Sort the eigenpairs in descending order
+    std::array<std::size_t, 3> order = {0, 1, 2};
+    std::sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j) { return b[i * 4] > b[j * 4]; });
+    svd3_result<A> result{};
+    for (std::size_t j = 0; j < 3; ++j) {
+        result.s[j] = std::sqrt(std::max(b[order[j] * 4], A{0}));
+        for (std::size_t k = 0; k < 3; ++k) {
+            result.v[k + 3 * j] = v[k + 3 * order[j]];
+        }
+    }
+    // U columns from H v_j / s_j, completed to a right-handed orthonormal basis when needed. The
+    // tolerance is relative to s_0 so the rank does not depend on the units of the points; a zero H
+    // gives a zero tolerance and rank 0, so U falls back to the identity.
+    const A tolerance = std::numeric_limits<A>::epsilon() * A{64} * result.s[0];
+    std::size_t rank = 0;
+    for (std::size_t j = 0; j < 3; ++j) {
+        std::array<A, 3> u{};
+        for (std::size_t i = 0; i < 3; ++i) {
+            u[i] = at(h, i, 0) * result.v[3 * j] + at(h, i, 1) * result.v[1 + 3 * j] +
+                   at(h, i, 2) * result.v[2 + 3 * j];
+        }
+        // Orthogonalize against previous columns to clean up rounding
+        for (std::size_t k = 0; k < j; ++k) {
+            A d = u[0] * result.u[3 * k] + u[1] * result.u[1 + 3 * k] + u[2] * result.u[2 + 3 * k];
+            for (std::size_t i = 0; i < 3; ++i) {
+                u[i] -= d * result.u[i + 3 * k];
+            }
+        }
+        A len = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+        if (result.s[j] <= tolerance || len <= tolerance) {
+            break;
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            result.u[i + 3 * j] = u[i] / len;
+        }
+        ++rank;
+    }
+    if (rank == 0) {
+        result.u = {A{1}, A{0}, A{0}, A{0}, A{1}, A{0}, A{0}, A{0}, A{1}};
+    } else if (rank == 1) {
+        // Any unit vector orthogonal to the first column
+        std::array<A, 3> a = {result.u[0], result.u[1], result.u[2]};
+        std::array<A, 3> e = std::abs(a[0]) < A{0.9} ? std::array<A, 3>{A{1}, A{0}, A{0}}
+                                                     : std::array<A, 3>{A{0}, A{1}, A{0}};
+        std::array<A, 3> w = {a[1] * e[2] - a[2] * e[1], a[2] * e[0] - a[0] * e[2], a[0] * e[1] - a[1] * e[0]};
+        A len = std::sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+        for (std::size_t i = 0; i < 3; ++i) {
+            result.u[i + 3] = w[i] / len;
+        }
+    }
+    if (rank < 3) {
+        result.u[6] = result.u[1] * result.u[5] - result.u[2] * result.u[4];
+        result.u[7] = result.u[2] * result.u[3] - result.u[0] * result.u[5];
+        result.u[8] = result.u[0] * result.u[4] - result.u[1] * result.u[3];
+    }
+    return result;
+}
+
+template <typename T, typename P, typename Q> auto register_points(const P &p, const Q &q, bool with_scale) {
+    // Accumulate in double precision for float inputs so that large clouds do not lose accuracy
+    using A = std::conditional_t<(sizeof(T) < sizeof(double)), double, T>;
+    const std::size_t n = p.shape()[0];
+    if (p.rank() != 2 || q.rank() != 2 || p.shape()[1] != 3 || q.shape()[1] != 3 || q.shape()[0] != n) {
+        throw std::invalid_argument("Registration requires two N×3 tensors of corresponding points");
+    }
+    if (n == 0) {
+        throw std::invalid_argument("Registration requires at least one pair of points");
+    }
+    const T *pd = reinterpret_cast<const T *>(p.data());
+    const T *qd = reinterpret_cast<const T *>(q.data());
+    const auto &ps = p.strides();
+    const auto &qs = q.strides();
+    const std::array<A, 3> p0 = {A(pd[0]), A(pd[ps[1]]), A(pd[2 * ps[1]])};
+    const std::array<A, 3> q0 = {A(qd[0]), A(qd[qs[1]]), A(qd[2 * qs[1]])};
+
+    auto moments = parallel_reduce(
+        0, n, 16384, registration_moments<A>{},
+        [&](std::size_t begin, std::size_t end) {
+            registration_moments<A> m;
+            m.count = end - begin;
+            for (std::size_t i = begin; i < end; ++i) {
+                A px = A(pd[i * ps[0]]) - p0[0];
+                A py = A(pd[i * ps[0] + ps[1]]) - p0[1];
+                A pz = A(pd[i * ps[0] + 2 * ps[1]]) - p0[2];
+                A qx = A(qd[i * qs[0]]) - q0[0];
+                A qy = A(qd[i * qs[0] + qs[1]]) - q0[1];
+                A qz = A(qd[i * qs[0] + 2 * qs[1]]) - q0[2];
+                m.sum_p[0] += px;
+                m.sum_p[1] += py;
+                m.sum_p[2] += pz;
+                m.sum_q[0] += qx;
+                m.sum_q[1] += qy;
+                m.sum_q[2] += qz;
+                m.sum_pq[0] += px * qx;
+                m.sum_pq[1] += py * qx;
+                m.sum_pq[2] += pz * qx;
+                m.sum_pq[3] += px * qy;
+                m.sum_pq[4] += py * qy;
+                m.sum_pq[5] += pz * qy;
+                m.sum_pq[6] += px * qz;
+                m.sum_pq[7] += py * qz;
+                m.sum_pq[8] += pz * qz;
+                m.sum_p2 += px * px + py * py + pz * pz;
+            }
+            return m;
+        },
+        [](const registration_moments<A> &a, const registration_moments<A> &b) { return a + b; });
+
+    const A inv_n = A{1} / static_cast<A>(n);
+    std::array<A, 3> mean_p{};
+    std::array<A, 3> mean_q{};
+    for (std::size_t i = 0; i < 3; ++i) {
+        mean_p[i] = moments.sum_p[i] * inv_n;
+        mean_q[i] = moments.sum_q[i] * inv_n;
+    }
+    // Cross-covariance H = E[(p - mean_p)(q - mean_q)^T]
+    std::array<A, 9> h{};
+    for (std::size_t j = 0; j < 3; ++j) {
+        for (std::size_t i = 0; i < 3; ++i) {
+            h[i + 3 * j] = moments.sum_pq[i + 3 * j] * inv_n - mean_p[i] * mean_q[j];
+        }
+    }
+    A var_p = moments.sum_p2 * inv_n - (mean_p[0] * mean_p[0] + mean_p[1] * mean_p[1] + mean_p[2] * mean_p[2]);
+
+    // R = V diag(1, 1, d) U^T with d correcting for reflections
+    auto svd = svd3(h);
+    auto det3 = [](const std::array<A, 9> &m) {
+        return m[0] * (m[4] * m[8] - m[7] * m[5]) - m[3] * (m[1] * m[8] - m[7] * m[2]) +
+               m[6] * (m[1] * m[5] - m[4] * m[2]);
+    };
+    const A d = det3(svd.u) * det3(svd.v) < A{0} ? A{-1} : A{1};
+    const std::array<A, 3> sign = {A{1}, A{1}, d};
+    rigid_transform<T> result;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            A r{};
+            for (std::size_t k = 0; k < 3; ++k) {
+                r += svd.v[i + 3 * k] * sign[k] * svd.u[j + 3 * k];
+            }
+            result.rotation(i, j) = static_cast<T>(r);
+        }
+    }
+    A c{1};
+    if (with_scale && var_p > A{0}) {
+        c = (svd.s[0] + svd.s[1] + d * svd.s[2]) / var_p;
+    }
+    result.scale = static_cast<T>(c);
+    // t = mean_q - c R mean_p, undoing the shift by the first pair
+    for (std::size_t i = 0; i < 3; ++i) {
+        A rp{};
+        for (std::size_t k = 0; k < 3; ++k) {
+            rp += A(result.rotation(i, k)) * (mean_p[k] + p0[k]);
+        }
+        result.translation(i) = length_t<T>(static_cast<T>(mean_q[i] + q0[i] - c * rp));
+    }
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief Finds the rigid transform that best aligns corresponding points (Kabsch algorithm).
+ *
+ * Minimizes the sum of squared distances between rotation * P_i + translation and Q_i. The
+ * rotation is proper (no reflections).
+ *
+ * @param p An N×3 tensor of source points.
+ * @param q An N×3 tensor of corresponding target points.
+ * @return The rigid transform mapping p onto q.
+ * @throws std::invalid_argument if the tensors are not N×3 with the same number of rows, or are empty.
+ */
+template <host_tensor P, host_tensor Q>
+    requires quantitative<std::remove_const_t<typename P::value_type>> &&
+             std::is_same_v<std::remove_const_t<typename P::value_type>, std::remove_const_t<typename Q::value_type>>
+auto kabsch(const P &p, const Q &q) {
+    using T = typename std::remove_const_t<typename P::value_type>::value_type;
+    static_assert(std::is_same_v<std::remove_const_t<typename P::value_type>, length_t<T>>,
+                  "kabsch requires tensors of lengths");
+    return detail::register_points<T>(p, q, false);
+}
+
+/**
+ * @brief Finds the similarity transform that best aligns corresponding points (Umeyama's method).
+ *
+ * Like kabsch(), but also estimates a uniform scale factor.
+ *
+ * @param p An N×3 tensor of source points.
+ * @param q An N×3 tensor of corresponding target points.
+ * @return The transform mapping p onto q.
+ * @throws std::invalid_argument if the tensors are not N×3 with the same number of rows, or are empty.
+ */
+template <host_tensor P, host_tensor Q>
+    requires quantitative<std::remove_const_t<typename P::value_type>> &&
+             std::is_same_v<std::remove_const_t<typename P::value_type>, std::remove_const_t<typename Q::value_type>>
+auto umeyama(const P &p, const Q &q) {
+    using T = typename std::remove_const_t<typename P::value_type>::value_type;
+    static_assert(std::is_same_v<std::remove_const_t<typename P::value_type>, length_t<T>>,
+                  "umeyama requires tensors of lengths");
+    return detail::register_points<T>(p, q, true);
+}
+
+} // namespace squint::geometry
+
+#endif // SQUINT_GEOMETRY_REGISTRATION_HPP
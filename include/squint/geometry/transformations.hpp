@@ -5,6 +5,16 @@
 #include "squint/core/layout.hpp"
 #include "squint/quantity/quantity_types.hpp"
 #include "squint/tensor/tensor.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 
 namespace squint::geometry {
 
@@ -82,6 +92,265 @@ template <transformation_matrix T, dimensionless_scalar U> void scale(T &matrix,
     matrix(2, 2) *= s(2);
 }
 
+/**
+ * @brief Concept for matrices whose upper-left 3x3 block is a rotation.
+ *
+ * This concept is satisfied by fixed 3x3 and 4x4 tensors with floating-point values.
+ *
+ * @tparam T The type to check against the concept.
+ */
+template <typename T>
+concept rotation_block_matrix =
+    fixed_tensor<T> && floating_point<std::remove_const_t<typename T::value_type>> &&
+    (std::is_same_v<typename T::shape_type, shape<3, 3>> || std::is_same_v<typename T::shape_type, shape<4, 4>>);
+
+/**
+ * @brief Methods for restoring orthonormality of a rotation matrix.
+ *
+ * gram_schmidt orthonormalizes the columns in order and rebuilds the third column with a cross
+ * product. polar computes the closest orthogonal matrix (the orthogonal polar factor) with a
+ * scaled Newton iteration, which spreads the correction over all columns. Both methods return a
+ * rotation: for a reflection (negative determinant) the third column is reversed.
+ */
+enum class orthonormalization : uint8_t { gram_schmidt, polar };
+
+namespace detail {
+
+// 3x3 matrices stored column-major as nine lanes of L values, so that each operation below is a
+// loop over L independent matrices.
+template <typename U, std::size_t L> using matrix3_lanes = std::array<std::array<U, L>, 9>;
+
+// Returns a unit vector orthogonal to the unit vector (x, y, z), built from the coordinate axis it
+// is least aligned with.
+template <typename U> auto orthogonal_unit(U x, U y, U z) -> std::array<U, 3> {
+    std::array<U, 3> v{};
+    if (std::abs(x) <= std::abs(y) && std::abs(x) <= std::abs(z)) {
+        v = {U{0}, z, -y};
+    } else if (std::abs(y) <= std::abs(z)) {
+        v = {-z, U{0}, x};
+    } else {
+        v = {y, -x, U{0}};
+    }
+    U n = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    return {v[0] / n, v[1] / n, v[2] / n};
+}
+
+// Columns whose length is zero, or lost to cancellation, are replaced by an arbitrary orthonormal
+// completion of the columns before them, so rank-deficient input still yields a rotation.
+template <typename U, std::size_t L> void gram_schmidt_lanes(matrix3_lanes<U, L> &m, std::size_t lanes) {
+    const U tolerance = U{16} * std::numeric_limits<U>::epsilon();
+    for (std::size_t l = 0; l < lanes; ++l) {
+        auto usable = [](U n) { return n > std::numeric_limits<U>::min() && std::isfinite(n); };
+        U n0 = std::sqrt(m[0][l] * m[0][l] + m[1][l] * m[1][l] + m[2][l] * m[2][l]);
+        U scale = std::sqrt(m[3][l] * m[3][l] + m[4][l] * m[4][l] + m[5][l] * m[5][l]);
+        U x0 = U{1};
+        U y0 = U{0};
+        U z0 = U{0};
+        if (usable(n0)) {
+            x0 = m[0][l] / n0;
+            y0 = m[1][l] / n0;
+            z0 = m[2][l] / n0;
+        } else if (usable(scale)) {
+            // Keep the direction of the second column.
+            const auto axis = orthogonal_unit(m[3][l] / scale, m[4][l] / scale, m[5][l] / scale);
+            x0 = axis[0];
+            y0 = axis[1];
+            z0 = axis[2];
+        }
+        U d = x0 * m[3][l] + y0 * m[4][l] + z0 * m[5][l];
+        U x1 = m[3][l] - d * x0;
+        U y1 = m[4][l] - d * y0;
+        U z1 = m[5][l] - d * z0;
+        U n1 = std::sqrt(x1 * x1 + y1 * y1 + z1 * z1);
+        if (!usable(n1) || !(n1 > tolerance * scale)) {
+            const auto axis = orthogonal_unit(x0, y0, z0);
+            x1 = axis[0];
+            y1 = axis[1];
+            z1 = axis[2];
+        } else {
+            x1 /= n1;
+            y1 /= n1;
+            z1 /= n1;
+        }
+        m[0][l] = x0;
+        m[1][l] = y0;
+        m[2][l] = z0;
+        m[3][l] = x1;
+        m[4][l] = y1;
+        m[5][l] = z1;
+        m[6][l] = y0 * z1 - z0 * y1;
+        m[7][l] = z0 * x1 - x0 * z1;
+        m[8][l] = x0 * y1 - y0 * x1;
+    }
+}
+
+// Frobenius-scaled Newton iteration X <- (g X + X^-T / g) / 2 for the orthogonal polar factor,
+// with g = sqrt(|X^-1| / |X|), which converges in a few steps for any nonsingular matrix. The
+// inverse transpose is the cofactor matrix divided by the determinant. A polar factor with a
+// negative determinant has its third column reversed, so that, as with Gram-Schmidt, the result is
+// a rotation. Lanes that are (near) singular, or whose result is not orthonormal, are orthonormalized
+// with Gram-Schmidt instead, starting again from their input.
+template <typename U, std::size_t L> void polar_lanes(matrix3_lanes<U, L> &m, std::size_t lanes) {
+    constexpr int max_iterations = 20;
+    const U tolerance = U{16} * std::numeric_limits<U>::epsilon();
+    const matrix3_lanes<U, L> input = m;
+    std::array<bool, L> singular{};
+    std::array<U, L> det{};
+    for (int iteration = 0; iteration < max_iterations; ++iteration) {
+        matrix3_lanes<U, L> c;
+        U change{};
+        for (std::size_t l = 0; l < L; ++l) {
+            c[0][l] = m[4][l] * m[8][l] - m[7][l] * m[5][l];
+            c[1][l] = m[6][l] * m[5][l] - m[3][l] * m[8][l];
+            c[2][l] = m[3][l] * m[7][l] - m[6][l] * m[4][l];
+            c[3][l] = m[7][l] * m[2][l] - m[1][l] * m[8][l];
+            c[4][l] = m[0][l] * m[8][l] - m[6][l] * m[2][l];
+            c[5][l] = m[6][l] * m[1][l] - m[0][l] * m[7][l];
+            c[6][l] = m[1][l] * m[5][l] - m[4][l] * m[2][l];
+            c[7][l] = m[3][l] * m[2][l] - m[0][l] * m[5][l];
+            c[8][l] = m[0][l] * m[4][l] - m[3][l] * m[1][l];
+            det[l] = m[0][l] * c[0][l] + m[1][l] * c[1][l] + m[2][l] * c[2][l];
+            U norm_m{};
+            U norm_c{};
+            for (std::size_t k = 0; k < 9; ++k) {
+                norm_m += m[k][l] * m[k][l];
+                norm_c += c[k][l] * c[k][l];
+            }
+            if (iteration == 0) {
+                // Relative to |X|^3, so that the test does not depend on the scale of the input
+                singular[l] = !(std::abs(det[l]) > std::numeric_limits<U>::epsilon() * norm_m * std::sqrt(norm_m));
+            }
+            if (singular[l]) {
+                continue;
+            }
+            const U gamma = std::sqrt(std::sqrt(norm_c / norm_m) / std::abs(det[l]));
+            const U inv = U{1} / (gamma * det[l]);
+            for (std::size_t k = 0; k < 9; ++k) {
+                U next = U{0.5} * (gamma * m[k][l] + c[k][l] * inv);
+                change = std::max(change, std::abs(next - m[k][l]));
+                m[k][l] = next;
+            }
+        }
+        if (change <= tolerance) {
+            break;
+        }
+    }
+    for (std::size_t l = 0; l < lanes; ++l) {
+        if (det[l] < U{0}) {
+            m[6][l] = -m[6][l];
+            m[7][l] = -m[7][l];
+            m[8][l] = -m[8][l];
+        }
+        U error{};
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                const U d = m[3 * i][l] * m[3 * j][l] + m[3 * i + 1][l] * m[3 * j + 1][l] +
+                            m[3 * i + 2][l] * m[3 * j + 2][l] - (i == j ? U{1} : U{0});
+                error = std::isnan(d) ? d : std::max(error, std::abs(d));
+            }
+        }
+        if (singular[l] || !(error <= U{4} * tolerance)) {
+            matrix3_lanes<U, 1> single;
+            for (std::size_t k = 0; k < 9; ++k) {
+                single[k][0] = input[k][l];
+            }
+            gram_schmidt_lanes<U, 1>(single, 1);
+            for (std::size_t k = 0; k < 9; ++k) {
+                m[k][l] = single[k][0];
+            }
+        }
+    }
+}
+
+template <typename U, std::size_t L>
+void orthonormalize_lanes(matrix3_lanes<U, L> &m, std::size_t lanes, orthonormalization method) {
+    if (method == orthonormalization::polar) {
+        polar_lanes<U, L>(m, lanes);
+    } else {
+        gram_schmidt_lanes<U, L>(m, lanes);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Restores the orthonormality of a rotation matrix.
+ *
+ * For 4x4 matrices only the upper-left 3x3 rotation block is modified, so translations are
+ * preserved. This is useful to remove the drift accumulated by long chains of rotate() calls.
+ *
+ * @tparam T The type of the matrix.
+ * @param matrix The 3x3 or 4x4 matrix to orthonormalize in place.
+ * @param method The orthonormalization method (default is polar).
+ */
+template <rotation_block_matrix T>
+void orthonormalize(T &matrix, orthonormalization method = orthonormalization::polar) {
+    using U = std::remove_const_t<typename T::value_type>;
+    detail::matrix3_lanes<U, 1> m;
+    for (std::size_t j = 0; j < 3; ++j) {
+        for (std::size_t i = 0; i < 3; ++i) {
+            m[i + 3 * j][0] = matrix(i, j);
+        }
+    }
+    detail::orthonormalize_lanes<U, 1>(m, 1, method);
+    for (std::size_t j = 0; j < 3; ++j) {
+        for (std::size_t i = 0; i < 3; ++i) {
+            matrix(i, j) = m[i + 3 * j][0];
+        }
+    }
+}
+
+/**
+ * @brief Restores the orthonormality of a batch of rotation matrices.
+ *
+ * The batch is an N×3×3 or N×4×4 tensor where entry (n, i, j) is element (i, j) of matrix n; for
+ * N×4×4 tensors only the rotation blocks are modified. The matrices are processed in blocks of
+ * 64 with the element loops running across the batch, so a column-major batch (the default
+ * layout) is read with unit stride. Blocks are distributed across threads.
+ *
+ * @tparam T The type of the batch tensor.
+ * @param matrices The batch of matrices to orthonormalize in place.
+ * @param method The orthonormalization method (default is polar).
+ * @throws std::invalid_argument if the batch is not N×3×3 or N×4×4.
+ */
+template <host_tensor T>
+    requires(!rotation_block_matrix<T> && floating_point<typename T::value_type>)
+void orthonormalize(T &matrices, orthonormalization method = orthonormalization::polar) {
+    using U = std::remove_const_t<typename T::value_type>;
+    constexpr std::size_t block = 64;
+    const auto &shape = matrices.shape();
+    if (shape.size() != 3 || shape[1] != shape[2] || (shape[1] != 3 && shape[1] != 4)) {
+        throw std::invalid_argument("orthonormalize requires an N×3×3 or N×4×4 batch of matrices");
+    }
+    const std::size_t n = shape[0];
+    const auto &strides = matrices.strides();
+    U *data = matrices.data();
+    parallel_for(0, (n + block - 1) / block, 16, [&](std::size_t first, std::size_t last) {
+        detail::matrix3_lanes<U, block> m;
+        for (std::size_t b = first; b < last; ++b) {
+            const std::size_t begin = b * block;
+            const std::size_t lanes = std::min(block, n - begin);
+            for (std::size_t k = 0; k < 9; ++k) {
+                const U *src = data + (k % 3) * strides[1] + (k / 3) * strides[2] + begin * strides[0];
+                for (std::size_t l = 0; l < lanes; ++l) {
+                    m[k][l] = src[l * strides[0]];
+                }
+                // Pad unused lanes with the identity so they stay well conditioned.
+                for (std::size_t l = lanes; l < block; ++l) {
+                    m[k][l] = (k % 4 == 0) ? U{1} : U{0};
+                }
+            }
+            detail::orthonormalize_lanes<U, block>(m, lanes, method);
+            for (std::size_t k = 0; k < 9; ++k) {
+                U *dst = data + (k % 3) * strides[1] + (k / 3) * strides[2] + begin * strides[0];
+                for (std::size_t l = 0; l < lanes; ++l) {
+                    dst[l * strides[0]] = m[k][l];
+                }
+            }
+        }
+    });
+}
+
 } // namespace squint::geometry
 
 #endif // SQUINT_GEOMETRY_TRANSFORMATIONS_HPP
\ No newline at end of file
@@ -21,11 +21,13 @@ namespace squint {
 /**
  * @brief Represents a physical quantity with a value and dimension.
  *
- * @tparam T The arithmetic type used to represent the value.
+ * @tparam T The arithmetic or complex type used to represent the value.
  * @tparam D The dimension type representing the physical dimension.
  * @tparam E The error checking policy.
  */
-template <arithmetic T, dimensional D, error_checking E = error_checking::disabled> class quantity {
+template <typename T, dimensional D, error_checking E = error_checking::disabled>
+    requires(arithmetic<T> || complex_number<T> || dual_number<T>)
+class quantity {
   public:
     using value_type = T;
     using dimension_type = D;
@@ -2,8 +2,22 @@
 #define SQUINT_TENSOR_HPP
 
 // NOLINTBEGIN
+#include "squint/tensor/autodiff.hpp"
+#include "squint/tensor/banded.hpp"
+#include "squint/tensor/comparison.hpp"
+#include "squint/tensor/concatenation.hpp"
+#include "squint/tensor/convolution.hpp"
 #include "squint/tensor/element_wise_ops.hpp"
+#include "squint/tensor/fft.hpp"
+#include "squint/tensor/indexing.hpp"
+#include "squint/tensor/interpolation.hpp"
+#include "squint/tensor/masking.hpp"
+#include "squint/tensor/ode.hpp"
+#include "squint/tensor/ring_buffer.hpp"
 #include "squint/tensor/scalar_ops.hpp"
+#include "squint/tensor/sliding_window.hpp"
+#include "squint/tensor/sorting.hpp"
+#include "squint/tensor/statistics.hpp"
 #include "squint/tensor/tensor_accessors.hpp"
 #include "squint/tensor/tensor_assignment.hpp"
 #include "squint/tensor/tensor_constructors.hpp"
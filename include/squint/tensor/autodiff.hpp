@@ -0,0 +1,283 @@
+/**
+ * @file autodiff.hpp
+ * @brief Tensor operations on dual numbers and forward-mode Jacobians.
+ *
+ * Tensors of dual numbers (see dual.hpp) support the element-wise operators like any other element
+ * type. This file adds matrix multiplication of dual tensors, which splits the operands into their
+ * value and derivative lanes and multiplies the lanes with two BLAS calls: the value and derivative
+ * lanes of the left operand stacked vertically times the values of the right operand, and the
+ * values of the left operand times the derivative lanes of the right operand placed side by side.
+ *
+ * jacobian evaluates a function once per group of Lanes input variables on dual numbers seeded
+ * with unit derivatives, so the Jacobian of a function of n variables costs ceil(n / Lanes)
+ * evaluations rather than the n + 1 of forward differences.
+ */
+#ifndef SQUINT_TENSOR_AUTODIFF_HPP
+#define SQUINT_TENSOR_AUTODIFF_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/dual.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/layout.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/tensor/tensor_op_compatibility.hpp"
+#include "squint/tensor/tensor_ops.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace squint {
+
+namespace detail {
+
+/// Value type and number of derivative lanes of a tensor element; arithmetic elements have no lanes.
+template <typename T> struct lanes_of {
+    using value_type = T;
+    static constexpr std::size_t count = 0;
+};
+
+template <typename T, std::size_t N> struct lanes_of<dual<T, N>> {
+    using value_type = T;
+    static constexpr std::size_t count = N;
+};
+
+/// Returns lane l of an element: its value for l = 0 and its derivative l - 1 otherwise.
+template <typename E> constexpr auto lane(const E &element, std::size_t l) {
+    if constexpr (dual_number<E>) {
+        return l == 0 ? element.value() : element.derivative(l - 1);
+    } else {
+        return element;
+    }
+}
+
+/**
+ * @brief Gathers the lanes of an m×k matrix into a column-major matrix of m * lanes rows, lane by lane.
+ */
+template <typename T, typename Tensor>
+auto stack_lanes_vertically(const Tensor &t, std::size_t m, std::size_t k, std::size_t lanes)
+    -> tensor<T, dynamic, dynamic> {
+    std::vector<T> data(m * lanes * k);
+    const std::size_t rows = m * lanes;
+    std::size_t index = 0;
+    for (const auto &element : t) {
+        const std::size_t i = index % m;
+        const std::size_t p = index / m;
+        for (std::size_t l = 0; l < lanes; ++l) {
+            data[(l * m + i) + p * rows] = lane(element, l);
+        }
+        ++index;
+    }
+    return {std::vector<std::size_t>{rows, k}, data};
+}
+
+/**
+ * @brief Gathers lanes first..last of a k×n matrix into a column-major matrix of k rows and n lanes
+ * columns per lane, lane by lane.
+ */
+template <typename T, typename Tensor>
+auto stack_lanes_horizontally(const Tensor &t, std::size_t k, std::size_t n, std::size_t first, std::size_t last)
+    -> tensor<T, dynamic, dynamic> {
+    std::vector<T> data(k * n * (last - first));
+    std::size_t index = 0;
+    for (const auto &element : t) {
+        const std::size_t p = index % k;
+        const std::size_t j = index / k;
+        for (std::size_t l = first; l < last; ++l) {
+            data[p + ((l - first) * n + j) * k] = lane(element, l);
+        }
+        ++index;
+    }
+    return {std::vector<std::size_t>{k, n * (last - first)}, data};
+}
+
+} // namespace detail
+
+/**
+ * @brief Matrix multiplication of tensors of dual numbers.
+ *
+ * Either operand may instead hold plain values of the dual numbers' value type. The product rule is
+ * applied lane-wise, (AB)' = A'B + AB', with two matrix multiplications over all lanes at once.
+ *
+ * @param t1 The first tensor to multiply.
+ * @param t2 The second tensor to multiply.
+ * @return A new column-major tensor of dual numbers containing the product.
+ */
+template <tensorial Tensor1, tensorial Tensor2>
+    requires(host_tensor<Tensor1> && host_tensor<Tensor2> &&
+             (dual_number<std::remove_const_t<typename Tensor1::value_type>> ||
+              dual_number<std::remove_const_t<typename Tensor2::value_type>>))
+auto operator*(const Tensor1 &t1, const Tensor2 &t2) {
+    using lanes1 = detail::lanes_of<std::remove_const_t<typename Tensor1::value_type>>;
+    using lanes2 = detail::lanes_of<std::remove_const_t<typename Tensor2::value_type>>;
+    using value_type = typename lanes1::value_type;
+    static_assert(std::is_same_v<value_type, typename lanes2::value_type>,
+                  "Tensors must have the same underlying arithmetic type");
+    static_assert(lanes1::count == 0 || lanes2::count == 0 || lanes1::count == lanes2::count,
+                  "Dual numbers must have the same number of derivatives");
+    constexpr std::size_t N = std::max(lanes1::count, lanes2::count);
+    using result_value_type = dual<value_type, N>;
+    matrix_multiply_compatible(t1, t2);
+
+    const std::size_t m = t1.shape()[0];
+    const std::size_t k = t1.rank() == 1 ? 1 : t1.shape()[1];
+    const std::size_t n = t2.rank() == 1 ? 1 : t2.shape()[1];
+
+    // Lanes of t1 times the values of t2
+    const auto left = detail::stack_lanes_vertically<value_type>(t1, m, k, lanes1::count + 1);
+    const auto right_values = detail::stack_lanes_horizontally<value_type>(t2, k, n, 0, 1);
+    const auto first = left * right_values;
+    const value_type *first_data = first.data();
+
+    std::vector<result_value_type> values(m * n);
+    for (std::size_t j = 0; j < n; ++j) {
+        for (std::size_t i = 0; i < m; ++i) {
+            auto &element = values[i + j * m];
+            const std::size_t column = j * m * (lanes1::count + 1);
+            element.value() = first_data[i + column];
+            for (std::size_t l = 0; l < lanes1::count; ++l) {
+                element.gradient()[l] = first_data[(l + 1) * m + i + column];
+            }
+        }
+    }
+    // Values of t1 times the derivative lanes of t2
+    if constexpr (lanes2::count > 0) {
+        const auto left_values = detail::stack_lanes_vertically<value_type>(t1, m, k, 1);
+        const auto right = detail::stack_lanes_horizontally<value_type>(t2, k, n, 1, lanes2::count + 1);
+        const auto second = left_values * right;
+        const value_type *second_data = second.data();
+        for (std::size_t l = 0; l < lanes2::count; ++l) {
+            for (std::size_t j = 0; j < n; ++j) {
+                for (std::size_t i = 0; i < m; ++i) {
+                    values[i + j * m].gradient()[l] += second_data[i + (l * n + j) * m];
+                }
+            }
+        }
+    }
+
+    constexpr auto checking = resulting_error_checking<Tensor1::error_checking(), Tensor2::error_checking()>::value;
+    if constexpr (fixed_tensor<Tensor1> && fixed_tensor<Tensor2>) {
+        using result_shape_type =
+            matrix_multiply_sequence_t<typename Tensor1::shape_type, typename Tensor2::shape_type>;
+        tensor<result_value_type, result_shape_type, strides::column_major<result_shape_type>, checking> result{};
+        std::copy(values.begin(), values.end(), result.data());
+        return result;
+    } else {
+        return tensor<result_value_type, dynamic, dynamic, checking>(std::vector<std::size_t>{m, n}, values,
+                                                                     layout::column_major);
+    }
+}
+
+/**
+ * @brief Extracts the values of a tensor of dual numbers.
+ * @param t The tensor of dual numbers.
+ * @return A column-major tensor of the shape of t holding the values.
+ */
+template <host_tensor Tensor> auto dual_values(const Tensor &t) {
+    using element_type = std::remove_const_t<typename Tensor::value_type>;
+    static_assert(dual_number<element_type>, "dual_values requires a tensor of dual numbers");
+    using value_type = typename element_type::value_type;
+    std::vector<value_type> values;
+    values.reserve(t.size());
+    for (const auto &element : t) {
+        values.push_back(element.value());
+    }
+    return tensor<value_type, dynamic, dynamic, Tensor::error_checking()>(
+        std::vector<std::size_t>(t.shape().begin(), t.shape().end()), values, layout::column_major);
+}
+
+/**
+ * @brief Extracts the derivatives of a tensor of dual numbers with respect to one variable.
+ * @param t The tensor of dual numbers.
+ * @param i The index of the variable.
+ * @return A column-major tensor of the shape of t holding the derivatives.
+ */
+template <host_tensor Tensor> auto dual_derivatives(const Tensor &t, std::size_t i) {
+    using element_type = std::remove_const_t<typename Tensor::value_type>;
+    static_assert(dual_number<element_type>, "dual_derivatives requires a tensor of dual numbers");
+    using value_type = typename element_type::value_type;
+    std::vector<value_type> derivatives;
+    derivatives.reserve(t.size());
+    for (const auto &element : t) {
+        derivatives.push_back(element.derivative(i));
+    }
+    return tensor<value_type, dynamic, dynamic, Tensor::error_checking()>(
+        std::vector<std::size_t>(t.shape().begin(), t.shape().end()), derivatives, layout::column_major);
+}
+
+/**
+ * @brief Result of jacobian: the value of the function and its Jacobian matrix.
+ */
+template <typename T, error_checking ErrorChecking> struct jacobian_result {
+    tensor<T, dynamic, dynamic, ErrorChecking> value;    ///< f(x), with the shape returned by f.
+    tensor<T, dynamic, dynamic, ErrorChecking> jacobian; ///< d f / d x, of shape {f(x).size(), x.size()}.
+};
+
+/**
+ * @brief Computes the value and Jacobian matrix of a function by forward-mode automatic differentiation.
+ *
+ * The function is called with a dynamic tensor of dual<T, Lanes> numbers of the shape of x and
+ * must return a tensor of the same dual numbers. Each call differentiates with respect to Lanes
+ * of the variables, so f is called ceil(x.size() / Lanes) times. Rows of the Jacobian follow the
+ * column-major order of the elements of f(x), and columns the column-major order of the elements
+ * of x.
+ *
+ * @tparam Lanes The number of derivatives carried by each dual number.
+ * @param f The function, generic over its tensor argument.
+ * @param x The point at which to differentiate, a tensor of floating-point values.
+ * @return The value f(x) and the Jacobian matrix.
+ */
+template <std::size_t Lanes = 8, typename Function, host_tensor Tensor>
+auto jacobian(Function &&f, const Tensor &x) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    static_assert(floating_point<value_type>, "jacobian requires floating-point variables");
+    static_assert(Lanes > 0, "jacobian requires at least one lane");
+    using dual_type = dual<value_type, Lanes>;
+    constexpr auto checking = Tensor::error_checking();
+    const std::vector<std::size_t> shape(x.shape().begin(), x.shape().end());
+    std::vector<value_type> point;
+    point.reserve(x.size());
+    for (const auto &element : x) {
+        point.push_back(element);
+    }
+    const std::size_t n = point.size();
+
+    std::vector<std::size_t> value_shape;
+    std::vector<value_type> values;
+    std::vector<value_type> derivatives;
+    std::size_t outputs = 0;
+    for (std::size_t first = 0; first < std::max<std::size_t>(n, 1); first += Lanes) {
+        std::vector<dual_type> seeded(point.begin(), point.end());
+        for (std::size_t l = 0; l < Lanes && first + l < n; ++l) {
+            seeded[first + l] = dual_type::variable(point[first + l], l);
+        }
+        const auto result = f(tensor<dual_type, dynamic, dynamic, checking>(shape, seeded, layout::column_major));
+        if (first == 0) {
+            value_shape.assign(result.shape().begin(), result.shape().end());
+            outputs = result.size();
+            values.reserve(outputs);
+            for (const auto &element : result) {
+                values.push_back(element.value());
+            }
+            derivatives.resize(outputs * n);
+        }
+        std::size_t row = 0;
+        for (const auto &element : result) {
+            for (std::size_t l = 0; l < Lanes && first + l < n; ++l) {
+                derivatives[row + (first + l) * outputs] = element.derivative(l);
+            }
+            ++row;
+        }
+    }
+    return jacobian_result<value_type, checking>{
+        tensor<value_type, dynamic, dynamic, checking>(value_shape, values, layout::column_major),
+        tensor<value_type, dynamic, dynamic, checking>(std::vector<std::size_t>{outputs, n}, derivatives,
+                                                       layout::column_major)};
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_AUTODIFF_HPP
@@ -0,0 +1,448 @@
+/**
+ * @file banded.hpp
+ * @brief Band matrix storage and solvers for banded and tridiagonal systems.
+ *
+ * This file provides banded_matrix, which stores an n×n matrix with kl subdiagonals and ku
+ * superdiagonals in LAPACK band format using O(n(kl + ku)) memory, together with solve_banded
+ * (LU with partial pivoting, gbsv) and solve_banded_spd (Cholesky, pbsv).
+ *
+ * Tridiagonal systems given as three diagonals are solved by the Thomas algorithm in O(n) with
+ * solve_tridiagonal. solve_tridiagonal_batched solves many independent systems at once, with the
+ * systems interleaved in memory so that the inner loops run across systems and vectorize, and
+ * with the batch split across threads. The Thomas algorithm does not pivot and is meant for
+ * diagonally dominant or symmetric positive definite systems; it accepts quantity coefficients.
+ */
+#ifndef SQUINT_TENSOR_BANDED_HPP
+#define SQUINT_TENSOR_BANDED_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/quantity/quantity_ops.hpp"
+#include "squint/tensor/blas_backend.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/tensor/tensor_op_compatibility.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace squint {
+
+/**
+ * @brief Square band matrix in LAPACK band storage.
+ *
+ * Element (i, j) with -ku <= i - j <= kl is stored at data()[kl + ku + i - j + j * leading_dimension()],
+ * column-major with leading dimension 2kl + ku + 1. The first kl rows of the storage are workspace
+ * for the fill-in of the LU factorization, so the storage can be passed to gbsv without copying.
+ *
+ * @tparam T The element type, float or double.
+ */
+template <floating_point T> class banded_matrix {
+  public:
+    using value_type = T; ///< The type of the elements.
+
+    /**
+     * @brief Constructs a zero band matrix.
+     * @param n The number of rows and columns.
+     * @param lower The number of subdiagonals kl.
+     * @param upper The number of superdiagonals ku.
+     */
+    banded_matrix(std::size_t n, std::size_t lower, std::size_t upper)
+        : n_(n), lower_(lower), upper_(upper), ld_(2 * lower + upper + 1), data_(ld_ * n) {}
+
+    /**
+     * @brief Creates a band matrix from the band of a dense square matrix.
+     * @param dense The dense matrix; elements outside the band are ignored.
+     * @param lower The number of subdiagonals kl.
+     * @param upper The number of superdiagonals ku.
+     * @return The band matrix.
+     * @throws std::invalid_argument if the matrix is not square.
+     */
+    template <host_tensor Dense>
+    static auto from_dense(const Dense &dense, std::size_t lower, std::size_t upper) -> banded_matrix {
+        if (dense.rank() != 2 || dense.shape()[0] != dense.shape()[1]) {
+            throw std::invalid_argument("Band matrix requires a square matrix");
+        }
+        const std::size_t n = dense.shape()[0];
+        banded_matrix result(n, lower, upper);
+        for (std::size_t j = 0; j < n; ++j) {
+            for (std::size_t i = j > upper ? j - upper : 0; i < std::min(n, j + lower + 1); ++i) {
+                result.data_[result.index(i, j)] = static_cast<T>(dense(i, j));
+            }
+        }
+        return result;
+    }
+
+    /// @brief Returns the number of rows and columns.
+    [[nodiscard]] auto rows() const -> std::size_t { return n_; }
+    /// @brief Returns the number of subdiagonals.
+    [[nodiscard]] auto lower_bandwidth() const -> std::size_t { return lower_; }
+    /// @brief Returns the number of superdiagonals.
+    [[nodiscard]] auto upper_bandwidth() const -> std::size_t { return upper_; }
+    /// @brief Returns the leading dimension of the band storage, 2kl + ku + 1.
+    [[nodiscard]] auto leading_dimension() const -> std::size_t { return ld_; }
+    /// @brief Returns a pointer to the band storage.
+    [[nodiscard]] auto data() -> T * { return data_.data(); }
+    /// @brief Returns a pointer to the band storage.
+    [[nodiscard]] auto data() const -> const T * { return data_.data(); }
+
+    /// @brief Returns true if element (i, j) lies inside the band.
+    [[nodiscard]] auto in_band(std::size_t i, std::size_t j) const -> bool {
+        return i < n_ && j < n_ && i <= j + lower_ && j <= i + upper_;
+    }
+
+    /**
+     * @brief Accesses an element inside the band.
+     * @param i The row index.
+     * @param j The column index.
+     * @return A reference to the element.
+     * @throws std::out_of_range if the element lies outside the band.
+     */
+    auto operator()(std::size_t i, std::size_t j) -> T & {
+        if (!in_band(i, j)) {
+            throw std::out_of_range("Element outside the band");
+        }
+        return data_[index(i, j)];
+    }
+
+    /**
+     * @brief Returns an element, zero outside the band.
+     * @param i The row index.
+     * @param j The column index.
+     * @return The value of the element.
+     */
+    auto operator()(std::size_t i, std::size_t j) const -> T { return in_band(i, j) ? data_[index(i, j)] : T{}; }
+
+    /**
+     * @brief Expands the band matrix to a dense matrix.
+     * @return A column-major n×n tensor.
+     */
+    [[nodiscard]] auto to_dense() const -> tensor<T, dynamic, dynamic> {
+        tensor<T, dynamic, dynamic> result({n_, n_}, T{});
+        for (std::size_t j = 0; j < n_; ++j) {
+            for (std::size_t i = j > upper_ ? j - upper_ : 0; i < std::min(n_, j + lower_ + 1); ++i) {
+                result(i, j) = data_[index(i, j)];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Multiplies the band matrix by a vector or matrix in O(n(kl + ku)) per column.
+     * @param x A tensor of shape {n} or {n, k}.
+     * @return A column-major tensor of the shape of x.
+     * @throws std::invalid_argument if x does not have n rows.
+     */
+    template <host_tensor X> [[nodiscard]] auto multiply(const X &x) const {
+        using result_type = decltype(std::declval<T>() * std::declval<std::remove_const_t<typename X::value_type>>());
+        if (x.shape()[0] != n_) {
+            throw std::invalid_argument("Operand rows must match the band matrix size");
+        }
+        std::vector<std::remove_const_t<typename X::value_type>> input;
+        input.reserve(x.size());
+        for (const auto &element : x) {
+            input.push_back(element);
+        }
+        std::vector<result_type> output(input.size(), result_type{});
+        for (std::size_t k = 0; k < input.size() / std::max<std::size_t>(n_, 1); ++k) {
+            for (std::size_t j = 0; j < n_; ++j) {
+                for (std::size_t i = j > upper_ ? j - upper_ : 0; i < std::min(n_, j + lower_ + 1); ++i) {
+                    output[k * n_ + i] += data_[index(i, j)] * input[k * n_ + j];
+                }
+            }
+        }
+        const auto shape = x.shape();
+        return tensor<result_type, dynamic, dynamic>(std::vector<std::size_t>(shape.begin(), shape.end()),
+                                                     std::move(output));
+    }
+
+  private:
+    [[nodiscard]] auto index(std::size_t i, std::size_t j) const -> std::size_t {
+        return lower_ + upper_ + i - j + j * ld_;
+    }
+
+    std::size_t n_;
+    std::size_t lower_;
+    std::size_t upper_;
+    std::size_t ld_;
+    std::vector<T> data_;
+};
+
+namespace detail {
+
+/**
+ * @brief Copies a right-hand side tensor into a column-major buffer of the band matrix type.
+ * @throws std::invalid_argument if the tensor does not have n rows.
+ */
+template <typename T, host_tensor Rhs> auto gather_banded_rhs(const Rhs &b, std::size_t n) -> std::vector<T> {
+    static_assert(dimensionless_scalar<std::remove_const_t<typename Rhs::value_type>>);
+    if (b.rank() == 0 || b.rank() > 2 || b.shape()[0] != n) {
+        throw std::invalid_argument("Right-hand side must have shape {n} or {n, k}");
+    }
+    std::vector<T> buffer;
+    buffer.reserve(b.size());
+    for (const auto &element : b) {
+        buffer.push_back(static_cast<T>(element));
+    }
+    return buffer;
+}
+
+/**
+ * @brief Writes a column-major solution buffer back into a right-hand side tensor.
+ */
+template <typename T, host_tensor Rhs> void scatter_banded_rhs(const std::vector<T> &buffer, Rhs &b) {
+    using value_type = std::remove_const_t<typename Rhs::value_type>;
+    auto it = buffer.begin();
+    for (auto &element : b) {
+        element = static_cast<value_type>(*it++);
+    }
+}
+
+/**
+ * @brief Copies a rank-1 tensor into a vector.
+ */
+template <host_tensor Tensor> auto gather_diagonal(const Tensor &t) {
+    std::vector<std::remove_const_t<typename Tensor::value_type>> buffer;
+    buffer.reserve(t.size());
+    for (const auto &element : t) {
+        buffer.push_back(element);
+    }
+    return buffer;
+}
+
+} // namespace detail
+
+/**
+ * @brief Solves a banded system of linear equations with LU factorization and partial pivoting.
+ * @param A The band matrix, overwritten by its LU factorization.
+ * @param B The right-hand side of shape {n} or {n, k}, overwritten by the solution.
+ * @return The pivot indices.
+ * @throws std::invalid_argument if B does not have n rows.
+ * @throws std::runtime_error if the matrix is singular or an error occurs during the solution.
+ */
+template <floating_point T, host_tensor Rhs> auto solve_banded(banded_matrix<T> &A, Rhs &B) {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "LAPACK band solvers require float or double elements");
+    const std::size_t n = A.rows();
+    auto b = detail::gather_banded_rhs<T>(B, n);
+    const auto nrhs = static_cast<BLAS_INT>(n == 0 ? 0 : b.size() / n);
+    std::vector<BLAS_INT> ipiv(n);
+    int info = 0;
+    // NOLINTBEGIN
+    if constexpr (std::is_same_v<T, float>) {
+        info = LAPACKE_sgbsv(LAPACK_COL_MAJOR, static_cast<BLAS_INT>(n), static_cast<BLAS_INT>(A.lower_bandwidth()),
+                             static_cast<BLAS_INT>(A.upper_bandwidth()), nrhs, A.data(),
+                             static_cast<BLAS_INT>(A.leading_dimension()), ipiv.data(), b.data(),
+                             static_cast<BLAS_INT>(std::max<std::size_t>(n, 1)));
+    }
+    if constexpr (std::is_same_v<T, double>) {
+        info = LAPACKE_dgbsv(LAPACK_COL_MAJOR, static_cast<BLAS_INT>(n), static_cast<BLAS_INT>(A.lower_bandwidth()),
+                             static_cast<BLAS_INT>(A.upper_bandwidth()), nrhs, A.data(),
+                             static_cast<BLAS_INT>(A.leading_dimension()), ipiv.data(), b.data(),
+                             static_cast<BLAS_INT>(std::max<std::size_t>(n, 1)));
+    }
+    // NOLINTEND
+    if (info != 0) {
+        throw std::runtime_error("LAPACKE_gbsv error code: " + std::to_string(info));
+    }
+    detail::scatter_banded_rhs(b, B);
+    return ipiv;
+}
+
+/**
+ * @brief Solves a symmetric positive definite banded system with Cholesky factorization.
+ *
+ * Only the diagonal and the ku superdiagonals of A are read; the matrix is assumed symmetric.
+ *
+ * @param A The band matrix, whose upper band is overwritten by the Cholesky factor U (A = UᵀU).
+ * @param B The right-hand side of shape {n} or {n, k}, overwritten by the solution.
+ * @throws std::invalid_argument if B does not have n rows.
+ * @throws std::runtime_error if the matrix is not positive definite or an error occurs during the solution.
+ */
+template <floating_point T, host_tensor Rhs> void solve_banded_spd(banded_matrix<T> &A, Rhs &B) {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "LAPACK band solvers require float or double elements");
+    const std::size_t n = A.rows();
+    auto b = detail::gather_banded_rhs<T>(B, n);
+    const auto nrhs = static_cast<BLAS_INT>(n == 0 ? 0 : b.size() / n);
+    // Skipping the kl fill-in and subdiagonal rows leaves the upper triangle in pbsv's 'U' layout.
+    T *upper = A.data() + A.lower_bandwidth();
+    int info = 0;
+    // NOLINTBEGIN
+    if constexpr (std::is_same_v<T, float>) {
+        info = LAPACKE_spbsv(LAPACK_COL_MAJOR, 'U', static_cast<BLAS_INT>(n),
+                             static_cast<BLAS_INT>(A.upper_bandwidth()), nrhs, upper,
+                             static_cast<BLAS_INT>(A.leading_dimension()), b.data(),
+                             static_cast<BLAS_INT>(std::max<std::size_t>(n, 1)));
+    }
+    if constexpr (std::is_same_v<T, double>) {
+        info = LAPACKE_dpbsv(LAPACK_COL_MAJOR, 'U', static_cast<BLAS_INT>(n),
+                             static_cast<BLAS_INT>(A.upper_bandwidth()), nrhs, upper,
+                             static_cast<BLAS_INT>(A.leading_dimension()), b.data(),
+                             static_cast<BLAS_INT>(std::max<std::size_t>(n, 1)));
+    }
+    // NOLINTEND
+    if (info != 0) {
+        throw std::runtime_error("LAPACKE_pbsv error code: " + std::to_string(info));
+    }
+    detail::scatter_banded_rhs(b, B);
+}
+
+/**
+ * @brief Solves a tridiagonal system with the Thomas algorithm in O(n).
+ *
+ * Row i of the system reads a[i-1] x[i-1] + b[i] x[i] + c[i] x[i+1] = d[i]. The factorization is
+ * shared by all right-hand sides.
+ *
+ * @param a The subdiagonal, n - 1 elements.
+ * @param b The diagonal, n elements.
+ * @param c The superdiagonal, n - 1 elements.
+ * @param d The right-hand side of shape {n} or {n, k}.
+ * @return The solution, a column-major tensor of the shape of d in units of d / b.
+ * @throws std::invalid_argument if the sizes do not match (when error checking is enabled).
+ * @throws std::runtime_error if a zero pivot is encountered.
+ */
+template <host_tensor Lower, host_tensor Diagonal, host_tensor Upper, host_tensor Rhs>
+auto solve_tridiagonal(const Lower &a, const Diagonal &b, const Upper &c, const Rhs &d) {
+    using diagonal_type = std::remove_const_t<typename Diagonal::value_type>;
+    using ratio_type = decltype(std::declval<std::remove_const_t<typename Upper::value_type>>() /
+                                std::declval<diagonal_type>());
+    using result_type = decltype(std::declval<std::remove_const_t<typename Rhs::value_type>>() /
+                                 std::declval<diagonal_type>());
+    const std::size_t n = b.size();
+    if constexpr (Rhs::error_checking() == error_checking::enabled) {
+        if (n == 0 || a.size() != n - 1 || c.size() != n - 1 || d.rank() == 0 || d.rank() > 2 ||
+            d.shape()[0] != n) {
+            throw std::invalid_argument("Tridiagonal system requires diagonals of n - 1, n and n - 1 elements");
+        }
+    }
+    const auto lower = detail::gather_diagonal(a);
+    const auto diagonal = detail::gather_diagonal(b);
+    const auto upper = detail::gather_diagonal(c);
+    std::vector<diagonal_type> pivot(n);
+    std::vector<ratio_type> ratio(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        pivot[i] = i == 0 ? diagonal[0] : diagonal[i] - lower[i - 1] * ratio[i - 1];
+        if (pivot[i] == diagonal_type{}) {
+            throw std::runtime_error("Zero pivot in tridiagonal system at row " + std::to_string(i));
+        }
+        if (i + 1 < n) {
+            ratio[i] = upper[i] / pivot[i];
+        }
+    }
+    const auto rhs = detail::gather_diagonal(d);
+    std::vector<result_type> x(rhs.size());
+    for (std::size_t k = 0; k < rhs.size() / n; ++k) {
+        const auto *r = rhs.data() + k * n;
+        auto *y = x.data() + k * n;
+        y[0] = r[0] / pivot[0];
+        for (std::size_t i = 1; i < n; ++i) {
+            y[i] = (r[i] - lower[i - 1] * y[i - 1]) / pivot[i];
+        }
+        for (std::size_t i = n - 1; i > 0; --i) {
+            y[i - 1] -= ratio[i - 1] * y[i];
+        }
+    }
+    const auto shape = d.shape();
+    return tensor<result_type, dynamic, dynamic>(std::vector<std::size_t>(shape.begin(), shape.end()), std::move(x));
+}
+
+/**
+ * @brief Solves many independent tridiagonal systems with the Thomas algorithm.
+ *
+ * Column s of each argument describes system s. The systems are interleaved in memory so that
+ * every step of the recurrence is a contiguous loop across systems, and the batch is split
+ * across threads.
+ *
+ * @param a The subdiagonals, shape {n - 1, m}.
+ * @param b The diagonals, shape {n, m}.
+ * @param c The superdiagonals, shape {n - 1, m}.
+ * @param d The right-hand sides, shape {n, m}.
+ * @return The solutions, a column-major tensor of shape {n, m} in units of d / b.
+ * @throws std::invalid_argument if the shapes do not match (when error checking is enabled).
+ * @throws std::runtime_error if a zero pivot is encountered in any system.
+ */
+template <host_tensor Lower, host_tensor Diagonal, host_tensor Upper, host_tensor Rhs>
+auto solve_tridiagonal_batched(const Lower &a, const Diagonal &b, const Upper &c, const Rhs &d) {
+    using lower_type = std::remove_const_t<typename Lower::value_type>;
+    using diagonal_type = std::remove_const_t<typename Diagonal::value_type>;
+    using upper_type = std::remove_const_t<typename Upper::value_type>;
+    using rhs_type = std::remove_const_t<typename Rhs::value_type>;
+    using ratio_type = decltype(std::declval<upper_type>() / std::declval<diagonal_type>());
+    using result_type = decltype(std::declval<rhs_type>() / std::declval<diagonal_type>());
+    if constexpr (Rhs::error_checking() == error_checking::enabled) {
+        if (b.rank() != 2 || d.rank() != 2 || a.rank() != 2 || c.rank() != 2 || b.shape()[0] == 0 ||
+            d.shape()[0] != b.shape()[0] || d.shape()[1] != b.shape()[1] || a.shape()[0] != b.shape()[0] - 1 ||
+            a.shape()[1] != b.shape()[1] || c.shape()[0] != a.shape()[0] || c.shape()[1] != b.shape()[1]) {
+            throw std::invalid_argument("Batched tridiagonal systems require shapes {n - 1, m}, {n, m}, {n - 1, m}");
+        }
+    }
+    const std::size_t n = b.shape()[0];
+    const std::size_t m = b.shape()[1];
+    // Element i of system s is stored at i * m + s.
+    auto interleave = [m](const auto &t, std::size_t rows) {
+        std::vector<std::remove_const_t<typename std::remove_cvref_t<decltype(t)>::value_type>> buffer(rows * m);
+        for (std::size_t s = 0; s < m; ++s) {
+            for (std::size_t i = 0; i < rows; ++i) {
+                buffer[i * m + s] = t(i, s);
+            }
+        }
+        return buffer;
+    };
+    const std::vector<lower_type> lower = interleave(a, n - 1);
+    const std::vector<diagonal_type> diagonal = interleave(b, n);
+    const std::vector<upper_type> upper = interleave(c, n - 1);
+    const std::vector<rhs_type> rhs = interleave(d, n);
+    std::vector<ratio_type> ratio(n * m);
+    std::vector<result_type> x(n * m);
+    const std::size_t grain = std::max<std::size_t>(1, (std::size_t{1} << 14) / n);
+    parallel_for(0, m, grain, [&](std::size_t first, std::size_t last) {
+        bool singular = false;
+        for (std::size_t s = first; s < last; ++s) {
+            const diagonal_type pivot = diagonal[s];
+            singular |= pivot == diagonal_type{};
+            if (n > 1) {
+                ratio[s] = upper[s] / pivot;
+            }
+            x[s] = rhs[s] / pivot;
+        }
+        for (std::size_t i = 1; i < n; ++i) {
+            const std::size_t row = i * m;
+            const std::size_t previous = row - m;
+            for (std::size_t s = first; s < last; ++s) {
+                const diagonal_type pivot = diagonal[row + s] - lower[previous + s] * ratio[previous + s];
+                singular |= pivot == diagonal_type{};
+                if (i + 1 < n) {
+                    ratio[row + s] = upper[row + s] / pivot;
+                }
+                x[row + s] = (rhs[row + s] - lower[previous + s] * x[previous + s]) / pivot;
+            }
+        }
+        if (singular) {
+            throw std::runtime_error("Zero pivot in batched tridiagonal system");
+        }
+        for (std::size_t i = n - 1; i > 0; --i) {
+            const std::size_t row = i * m;
+            const std::size_t previous = row - m;
+            for (std::size_t s = first; s < last; ++s) {
+                x[previous + s] -= ratio[previous + s] * x[row + s];
+            }
+        }
+    });
+    tensor<result_type, dynamic, dynamic> result({n, m});
+    for (std::size_t s = 0; s < m; ++s) {
+        for (std::size_t i = 0; i < n; ++i) {
+            result(i, s) = x[i * m + s];
+        }
+    }
+    return result;
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_BANDED_HPP
@@ -28,16 +28,25 @@
 #define BLAS_INT int
 #define cblas_sgemm squint::gemm<float>
 #define cblas_dgemm squint::gemm<double>
+#define cblas_ssyrk squint::syrk<float>
+#define cblas_dsyrk squint::syrk<double>
 #define LAPACKE_sgetrf squint::getrf<float>
 #define LAPACKE_dgetrf squint::getrf<double>
 #define LAPACKE_sgetri squint::getri<float>
 #define LAPACKE_dgetri squint::getri<double>
+#define LAPACKE_sgetrs squint::getrs<float>
+#define LAPACKE_dgetrs squint::getrs<double>
 #define LAPACKE_sgesv squint::gesv<float>
 #define LAPACKE_dgesv squint::gesv<double>
+#define LAPACKE_sgbsv squint::gbsv<float>
+#define LAPACKE_dgbsv squint::gbsv<double>
+#define LAPACKE_spbsv squint::pbsv<float>
+#define LAPACKE_dpbsv squint::pbsv<double>
 #define LAPACKE_sgels squint::gels<float>
 #define LAPACKE_dgels squint::gels<double>
 #define CBLAS_TRANSPOSE squint::CBLAS_TRANSPOSE
 #define CBLAS_ORDER squint::CBLAS_ORDER
+#define CBLAS_UPLO squint::CBLAS_UPLO
 #define LAPACK_COL_MAJOR squint::LAPACK_COL_MAJOR
 #define LAPACK_ROW_MAJOR squint::LAPACK_ROW_MAJOR
 #endif
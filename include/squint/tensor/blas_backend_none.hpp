@@ -15,6 +15,7 @@
 #ifndef SQUINT_TENSOR_BLAS_BACKEND_NONE_HPP
 #define SQUINT_TENSOR_BLAS_BACKEND_NONE_HPP
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 #include <vector>
@@ -27,6 +28,7 @@ constexpr int LAPACK_COL_MAJOR = 102;
 
 enum class CBLAS_ORDER { CblasRowMajor = 101, CblasColMajor = 102 };
 enum class CBLAS_TRANSPOSE { CblasNoTrans = 111, CblasTrans = 112, CblasConjTrans = 113 };
+enum class CBLAS_UPLO { CblasUpper = 121, CblasLower = 122 };
 
 // Helper functions
 
@@ -87,6 +89,39 @@ void gemm(CBLAS_ORDER order, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, i
     }
 }
 
+/**
+ * @brief Symmetric rank-k update (SYRK) implementation.
+ *
+ * Computes C = alpha * op(A) * op(A)^T + beta * C, where op(A) is N-by-K, touching only the
+ * triangle of C selected by uplo.
+ */
+template <typename T>
+void syrk(CBLAS_ORDER order, CBLAS_UPLO uplo, CBLAS_TRANSPOSE trans, int n, int k, T alpha, const T *a, int lda,
+          T beta, T *c, int ldc) {
+    const bool row_major = (order == CBLAS_ORDER::CblasRowMajor);
+    const bool trans_bool = (trans != CBLAS_TRANSPOSE::CblasNoTrans);
+    const bool upper = (uplo == CBLAS_UPLO::CblasUpper);
+    auto op_a = [&](int i, int l) {
+        if (trans_bool) {
+            return row_major ? a[l * lda + i] : a[i * lda + l];
+        }
+        return row_major ? a[i * lda + l] : a[l * lda + i];
+    };
+
+    for (int j = 0; j < n; ++j) {
+        const int i_begin = upper ? 0 : j;
+        const int i_end = upper ? j + 1 : n;
+        for (int i = i_begin; i < i_end; ++i) {
+            T sum = 0;
+            for (int l = 0; l < k; ++l) {
+                sum += op_a(i, l) * op_a(j, l);
+            }
+            const int c_idx = row_major ? i * ldc + j : j * ldc + i;
+            c[c_idx] = alpha * sum + beta * c[c_idx];
+        }
+    }
+}
+
 /**
  * @brief LU factorization of a general M-by-N matrix (GETRF).
  *
@@ -219,6 +254,47 @@ template <typename T> int getri(int matrix_layout, int n, T *a, int lda, const i
     return 0;
 }
 
+/**
+ * @brief Solve a system of linear equations using an LU factorization (GETRS).
+ *
+ * Solves A * X = B with the factors computed by GETRF. Only the non-transposed system is supported.
+ */
+template <typename T>
+auto getrs(int matrix_layout, char trans, int n, int nrhs, const T *a, int lda, const int *ipiv, T *b, int ldb)
+    -> int {
+    if (trans != 'N' && trans != 'n') {
+        return -2;
+    }
+    const bool row_major = (matrix_layout == LAPACK_ROW_MAJOR);
+    auto a_element = [&](int i, int j) { return row_major ? a[i * lda + j] : a[j * lda + i]; };
+
+    for (int k = 0; k < nrhs; ++k) {
+        auto b_element = [&](int i) -> T & { return row_major ? b[i * ldb + k] : b[k * ldb + i]; };
+        // Apply the row interchanges in order
+        for (int i = 0; i < n; ++i) {
+            const int pivot = ipiv[i] - 1;
+            if (pivot != i) {
+                std::swap(b_element(i), b_element(pivot));
+            }
+        }
+        // Forward substitution with the unit lower triangle
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < i; ++j) {
+                b_element(i) -= a_element(i, j) * b_element(j);
+            }
+        }
+        // Backward substitution with the upper triangle
+        for (int i = n - 1; i >= 0; --i) {
+            for (int j = i + 1; j < n; ++j) {
+                b_element(i) -= a_element(i, j) * b_element(j);
+            }
+            b_element(i) /= a_element(i, i);
+        }
+    }
+
+    return 0;
+}
+
 /**
  * @brief Solve a system of linear equations (GESV).
  *
@@ -268,6 +344,136 @@ template <typename T> auto gesv(int matrix_layout, int n, int nrhs, T *a, int ld
     return 0;
 }
 
+/**
+ * @brief Solve a banded system of linear equations (GBSV).
+ *
+ * Computes the solution to A * X = B for an N-by-N band matrix A with KL subdiagonals and KU
+ * superdiagonals, using LU factorization with partial pivoting. A is stored in LAPACK band format
+ * with LDAB >= 2 * KL + KU + 1; the first KL rows receive the fill-in of the factorization. Only the
+ * column-major layout is supported.
+ */
+template <typename T>
+auto gbsv(int matrix_layout, int n, int kl, int ku, int nrhs, T *ab, int ldab, int *ipiv, T *b, int ldb) -> int {
+    if (matrix_layout != LAPACK_COL_MAJOR) {
+        return -1;
+    }
+    const int kv = kl + ku;
+    auto a = [&](int i, int j) -> T & { return ab[(kv + i - j) + j * ldab]; };
+
+    // Clear the fill-in rows
+    for (int j = 0; j < n; ++j) {
+        for (int r = 0; r < kl; ++r) {
+            ab[r + j * ldab] = T(0);
+        }
+    }
+
+    // Factorize
+    int ju = 0;
+    for (int j = 0; j < n; ++j) {
+        const int km = std::min(kl, n - 1 - j);
+        int p = 0;
+        for (int r = 1; r <= km; ++r) {
+            if (std::abs(a(j + r, j)) > std::abs(a(j + p, j))) {
+                p = r;
+            }
+        }
+        ipiv[j] = j + p + 1;
+        if (a(j + p, j) == T(0)) {
+            return j + 1;
+        }
+        ju = std::max(ju, std::min(j + ku + p, n - 1));
+        if (p != 0) {
+            for (int c = j; c <= ju; ++c) {
+                std::swap(a(j, c), a(j + p, c));
+            }
+        }
+        for (int r = 1; r <= km; ++r) {
+            a(j + r, j) /= a(j, j);
+        }
+        for (int c = j + 1; c <= ju; ++c) {
+            for (int r = 1; r <= km; ++r) {
+                a(j + r, c) -= a(j + r, j) * a(j, c);
+            }
+        }
+    }
+
+    // Solve
+    for (int k = 0; k < nrhs; ++k) {
+        T *x = b + k * ldb;
+        for (int j = 0; j < n; ++j) {
+            std::swap(x[j], x[ipiv[j] - 1]);
+            const int km = std::min(kl, n - 1 - j);
+            for (int r = 1; r <= km; ++r) {
+                x[j + r] -= a(j + r, j) * x[j];
+            }
+        }
+        for (int j = n - 1; j >= 0; --j) {
+            x[j] /= a(j, j);
+            for (int i = std::max(0, j - kv); i < j; ++i) {
+                x[i] -= a(i, j) * x[j];
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Solve a symmetric positive definite banded system of linear equations (PBSV).
+ *
+ * Computes the solution to A * X = B using the Cholesky factorization A = U^T * U, where A has KD
+ * superdiagonals stored in LAPACK band format (AB(KD + i - j, j) = A(i, j)). Only the upper
+ * triangle and the column-major layout are supported.
+ */
+template <typename T>
+auto pbsv(int matrix_layout, char uplo, int n, int kd, int nrhs, T *ab, int ldab, T *b, int ldb) -> int {
+    if (matrix_layout != LAPACK_COL_MAJOR) {
+        return -1;
+    }
+    if (uplo != 'U' && uplo != 'u') {
+        return -2;
+    }
+    auto u = [&](int i, int j) -> T & { return ab[(kd + i - j) + j * ldab]; };
+
+    // Factorize, one row of U at a time
+    for (int j = 0; j < n; ++j) {
+        T diagonal = u(j, j);
+        for (int k = std::max(0, j - kd); k < j; ++k) {
+            diagonal -= u(k, j) * u(k, j);
+        }
+        if (diagonal <= T(0)) {
+            return j + 1;
+        }
+        u(j, j) = std::sqrt(diagonal);
+        for (int c = j + 1; c <= std::min(n - 1, j + kd); ++c) {
+            T value = u(j, c);
+            for (int k = std::max(0, c - kd); k < j; ++k) {
+                value -= u(k, j) * u(k, c);
+            }
+            u(j, c) = value / u(j, j);
+        }
+    }
+
+    // Solve U^T * y = b, then U * x = y
+    for (int k = 0; k < nrhs; ++k) {
+        T *x = b + k * ldb;
+        for (int j = 0; j < n; ++j) {
+            for (int i = std::max(0, j - kd); i < j; ++i) {
+                x[j] -= u(i, j) * x[i];
+            }
+            x[j] /= u(j, j);
+        }
+        for (int j = n - 1; j >= 0; --j) {
+            for (int c = j + 1; c <= std::min(n - 1, j + kd); ++c) {
+                x[j] -= u(j, c) * x[c];
+            }
+            x[j] /= u(j, j);
+        }
+    }
+
+    return 0;
+}
+
 /**
  * @brief Solve overdetermined or underdetermined linear systems (GELS).
  *
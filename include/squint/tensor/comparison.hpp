@@ -0,0 +1,220 @@
+/**
+ * @file comparison.hpp
+ * @brief Fused comparison and reduction kernels.
+ *
+ * This file provides all_equal, any_not_equal, count_if and approx_all_close, which compare and
+ * reduce in a single pass instead of materializing the std::uint8_t mask returned by the
+ * element-wise comparison operators. Elements are processed in fixed-size blocks: within a block
+ * the predicate results are summed without branches, so the loop vectorizes, and the reduction
+ * stops at the first block that decides the result. Tensors that share a contiguous layout are
+ * compared directly through their data pointers; all others are traversed with their iterators.
+ */
+#ifndef SQUINT_TENSOR_COMPARISON_HPP
+#define SQUINT_TENSOR_COMPARISON_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/tensor/tensor_op_compatibility.hpp"
+#include "squint/util/sequence_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+namespace squint {
+
+namespace detail {
+
+/// Number of elements compared between two checks of the early exit condition.
+inline constexpr std::size_t comparison_block = 256;
+
+/**
+ * @brief Counts the elements of a tensor that satisfy a predicate.
+ *
+ * Counting stops at the end of the first block in which the count reaches limit, so the result is
+ * exact when it is below limit and at least limit otherwise.
+ *
+ * @param t The tensor to scan.
+ * @param pred The predicate.
+ * @param limit The count at which scanning may stop.
+ * @return The number of elements satisfying the predicate.
+ */
+template <host_tensor Tensor, typename Predicate>
+auto count_matches(const Tensor &t, Predicate pred, std::size_t limit = std::numeric_limits<std::size_t>::max())
+    -> std::size_t {
+    const std::size_t size = t.size();
+    std::size_t count = 0;
+    if (t.is_contiguous()) {
+        const auto *data = t.data();
+        for (std::size_t first = 0; first < size && count < limit; first += comparison_block) {
+            const std::size_t last = std::min(size, first + comparison_block);
+            for (std::size_t i = first; i < last; ++i) {
+                count += static_cast<std::size_t>(static_cast<bool>(pred(data[i])));
+            }
+        }
+        return count;
+    }
+    std::size_t block = 0;
+    for (const auto &element : t) {
+        count += static_cast<std::size_t>(static_cast<bool>(pred(element)));
+        if (++block == comparison_block) {
+            if (count >= limit) {
+                break;
+            }
+            block = 0;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Counts the pairs of corresponding elements of two tensors that satisfy a predicate.
+ *
+ * The tensors must have the same shape. Counting stops at the end of the first block in which the
+ * count reaches limit.
+ *
+ * @param a The first tensor.
+ * @param b The second tensor.
+ * @param pred The binary predicate.
+ * @param limit The count at which scanning may stop.
+ * @return The number of pairs satisfying the predicate.
+ */
+template <host_tensor Tensor1, host_tensor Tensor2, typename Predicate>
+auto count_matches(const Tensor1 &a, const Tensor2 &b, Predicate pred,
+                   std::size_t limit = std::numeric_limits<std::size_t>::max()) -> std::size_t {
+    const std::size_t size = a.size();
+    std::size_t count = 0;
+    const auto a_strides = a.strides();
+    const auto b_strides = b.strides();
+    if (a.is_contiguous() && std::ranges::equal(a_strides, b_strides)) {
+        // Same contiguous layout: the element at every offset has the same index in both tensors
+        const auto *a_data = a.data();
+        const auto *b_data = b.data();
+        for (std::size_t first = 0; first < size && count < limit; first += comparison_block) {
+            const std::size_t last = std::min(size, first + comparison_block);
+            for (std::size_t i = first; i < last; ++i) {
+                count += static_cast<std::size_t>(static_cast<bool>(pred(a_data[i], b_data[i])));
+            }
+        }
+        return count;
+    }
+    auto b_it = b.begin();
+    std::size_t block = 0;
+    for (const auto &element : a) {
+        count += static_cast<std::size_t>(static_cast<bool>(pred(element, *b_it)));
+        ++b_it;
+        if (++block == comparison_block) {
+            if (count >= limit) {
+                break;
+            }
+            block = 0;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Checks whether two tensors have the same shape.
+ *
+ * Fixed tensors of different shapes are rejected at compile time.
+ */
+template <host_tensor Tensor1, host_tensor Tensor2> auto same_shape(const Tensor1 &a, const Tensor2 &b) -> bool {
+    if constexpr (fixed_tensor<Tensor1> && fixed_tensor<Tensor2>) {
+        static_assert(Tensor1::shape_type::size() == Tensor2::shape_type::size(),
+                      "Comparison requires tensors of the same shape");
+        static_assert(make_array(typename Tensor1::shape_type{}) == make_array(typename Tensor2::shape_type{}),
+                      "Comparison requires tensors of the same shape");
+        return true;
+    } else {
+        return std::ranges::equal(a.shape(), b.shape());
+    }
+}
+
+/**
+ * @brief Returns the numeric value of a scalar or quantity.
+ */
+template <typename T> constexpr auto numeric_value(const T &x) {
+    if constexpr (quantitative<T>) {
+        return x.value();
+    } else {
+        return x;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Checks whether all corresponding elements of two tensors are equal.
+ *
+ * Equivalent to reducing the result of operator== with a logical and, without allocating the mask.
+ *
+ * @param a The first tensor.
+ * @param b The second tensor.
+ * @return True if the tensors have the same shape and all elements compare equal.
+ */
+template <host_tensor Tensor1, host_tensor Tensor2> auto all_equal(const Tensor1 &a, const Tensor2 &b) -> bool {
+    if (!detail::same_shape(a, b)) {
+        return false;
+    }
+    return detail::count_matches(a, b, std::not_equal_to{}, 1) == 0;
+}
+
+/**
+ * @brief Checks whether any corresponding elements of two tensors differ.
+ * @param a The first tensor.
+ * @param b The second tensor.
+ * @return True if the tensors differ in shape or in any element.
+ */
+template <host_tensor Tensor1, host_tensor Tensor2> auto any_not_equal(const Tensor1 &a, const Tensor2 &b) -> bool {
+    return !all_equal(a, b);
+}
+
+/**
+ * @brief Counts the elements of a tensor that satisfy a predicate.
+ * @param t The tensor.
+ * @param pred The unary predicate.
+ * @return The number of elements for which pred returns true.
+ */
+template <host_tensor Tensor, typename Predicate>
+    requires std::predicate<Predicate &, const typename Tensor::value_type &>
+auto count_if(const Tensor &t, Predicate pred) -> std::size_t {
+    return detail::count_matches(t, pred);
+}
+
+/**
+ * @brief Checks whether two tensors are equal within a tolerance.
+ *
+ * Elements a_i and b_i are close if |a_i - b_i| <= atol + rtol * |b_i|, compared on their numeric
+ * values so that quantities and complex elements are supported. NaN is never close to anything.
+ *
+ * @param a The first tensor.
+ * @param b The second tensor, whose magnitude scales the relative tolerance.
+ * @param rtol The relative tolerance.
+ * @param atol The absolute tolerance.
+ * @return True if the tensors have the same shape and all elements are close.
+ */
+template <host_tensor Tensor1, host_tensor Tensor2,
+          typename Scalar = std::remove_const_t<decltype(std::abs(std::declval<blas_type_t<std::common_type_t<
+                                                                      typename Tensor1::value_type,
+                                                                      typename Tensor2::value_type>>>()))>>
+auto approx_all_close(const Tensor1 &a, const Tensor2 &b, Scalar rtol = Scalar(1e-5), Scalar atol = Scalar(1e-8))
+    -> bool {
+    if (!detail::same_shape(a, b)) {
+        return false;
+    }
+    auto far = [rtol, atol](const auto &x, const auto &y) {
+        const auto difference = std::abs(detail::numeric_value(x) - detail::numeric_value(y));
+        return !(difference <= atol + rtol * std::abs(detail::numeric_value(y)));
+    };
+    return detail::count_matches(a, b, far, 1) == 0;
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_COMPARISON_HPP
@@ -0,0 +1,282 @@
+/**
+ * @file concatenation.hpp
+ * @brief Joining tensors along an existing or a new axis.
+ *
+ * This file provides concatenate, which joins tensors along an existing axis, stack, which joins
+ * tensors of the same shape along a new axis, and concat_into, which concatenates into an existing
+ * tensor. The output shape is computed once, at compile time for fixed tensors when the axis is a
+ * template argument, and every part is copied as a set of blocks: when the part and the output are
+ * both column-major, each block spans the part's extent along the axis and every axis before it and
+ * is copied with a single std::copy_n.
+ */
+#ifndef SQUINT_TENSOR_CONCATENATION_HPP
+#define SQUINT_TENSOR_CONCATENATION_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/layout.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/tensor/indexing.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/util/sequence_utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace squint {
+
+namespace detail {
+
+/**
+ * @brief Copies a part into the slab of an output tensor that starts at an offset along an axis.
+ *
+ * @param data The data of the part.
+ * @param shape The shape of the part, equal to that of the output except along the axis.
+ * @param strides The strides of the part.
+ * @param out The output tensor.
+ * @param axis The axis along which the part is placed.
+ * @param start The index along the axis at which the part starts.
+ */
+template <typename T, host_tensor Out>
+void copy_slab(const T *data, const std::vector<std::size_t> &shape, const std::vector<std::size_t> &strides,
+               Out &out, std::size_t axis, std::size_t start) {
+    const auto source = make_axis_offsets(shape, strides, axis);
+    const auto target = make_axis_offsets(out.shape(), out.strides(), axis);
+    const std::size_t inner = source.inner.size();
+    const std::size_t extent = shape[axis];
+    auto *to = out.data() + start * target.stride;
+    // Column-major part and output: the inner axes and the concatenation axis form one run
+    const bool run = source.contiguous_inner && target.contiguous_inner && (extent == 1 || source.stride == inner) &&
+                     target.stride == inner;
+    for (std::size_t o = 0; o < source.outer.size(); ++o) {
+        if (run) {
+            std::copy_n(data + source.outer[o], inner * extent, to + target.outer[o]);
+        } else {
+            for (std::size_t j = 0; j < extent; ++j) {
+                for (std::size_t i = 0; i < inner; ++i) {
+                    to[target.outer[o] + j * target.stride + target.inner[i]] =
+                        data[source.outer[o] + j * source.stride + source.inner[i]];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Checks that a part can be placed in an output along an axis.
+ * @throws std::invalid_argument if the ranks differ or another extent differs (when error checking is enabled).
+ */
+template <error_checking ErrorChecking, typename ShapeRange>
+void check_part_shape(const ShapeRange &part, const std::vector<std::size_t> &out, std::size_t axis) {
+    if constexpr (ErrorChecking == error_checking::enabled) {
+        bool match = part.size() == out.size() && axis < out.size();
+        for (std::size_t k = 0; match && k < out.size(); ++k) {
+            match = k == axis || part[k] == out[k];
+        }
+        if (!match) {
+            throw std::invalid_argument("Tensors must have the same shape except along the concatenation axis");
+        }
+    }
+}
+
+/**
+ * @brief Copies parts one after another along an axis of an output tensor.
+ */
+template <host_tensor Out, host_tensor... Tensors>
+void concatenate_parts(Out &out, std::size_t axis, const Tensors &...ts) {
+    std::size_t start = 0;
+    auto copy_part = [&](const auto &t) {
+        std::vector<std::size_t> shape(t.shape().begin(), t.shape().end());
+        std::vector<std::size_t> strides(t.strides().begin(), t.strides().end());
+        copy_slab(t.data(), shape, strides, out, axis, start);
+        start += shape[axis];
+    };
+    (copy_part(ts), ...);
+}
+
+/**
+ * @brief Copies parts of the same shape into consecutive positions of a new axis of an output tensor.
+ */
+template <host_tensor Out, host_tensor... Tensors>
+void stack_parts(Out &out, std::size_t axis, const Tensors &...ts) {
+    std::size_t start = 0;
+    auto copy_part = [&](const auto &t) {
+        std::vector<std::size_t> shape(t.shape().begin(), t.shape().end());
+        std::vector<std::size_t> strides(t.strides().begin(), t.strides().end());
+        shape.insert(shape.begin() + static_cast<std::ptrdiff_t>(axis), 1);
+        strides.insert(strides.begin() + static_cast<std::ptrdiff_t>(axis), 0);
+        copy_slab(t.data(), shape, strides, out, axis, start++);
+    };
+    (copy_part(ts), ...);
+}
+
+/**
+ * @brief Shape of fixed tensors concatenated along Axis.
+ */
+template <std::size_t Axis, typename Shape, std::size_t Extent, std::size_t... I>
+auto concatenated_shape(std::index_sequence<I...> /*unused*/)
+    -> std::index_sequence<(I == Axis ? Extent : make_array(Shape{})[I])...>;
+
+/**
+ * @brief Shape of fixed tensors stacked along a new axis at Axis.
+ */
+template <std::size_t Axis, typename Shape, std::size_t Count, std::size_t... I>
+auto stacked_shape(std::index_sequence<I...> /*unused*/)
+    -> std::index_sequence<(I < Axis ? make_array(Shape{})[I] : I == Axis ? Count : make_array(Shape{})[I - 1])...>;
+
+/**
+ * @brief Checks at compile time that fixed shapes agree except along Axis.
+ */
+template <std::size_t Axis, typename Shape, typename... Shapes> constexpr auto compatible_parts() -> bool {
+    constexpr auto first = make_array(Shape{});
+    auto matches = [&](auto other) {
+        if (other.size() != first.size()) {
+            return false;
+        }
+        for (std::size_t k = 0; k < first.size(); ++k) {
+            if (k != Axis && other[k] != first[k]) {
+                return false;
+            }
+        }
+        return true;
+    };
+    return Axis < first.size() && (matches(make_array(Shapes{})) && ...);
+}
+
+template <typename... Tensors>
+using joined_value_t = std::remove_const_t<std::common_type_t<typename Tensors::value_type...>>;
+
+template <typename First, typename... Rest> constexpr auto first_error_checking() -> error_checking {
+    return First::error_checking();
+}
+
+} // namespace detail
+
+/**
+ * @brief Concatenates fixed tensors along a compile-time axis.
+ * @tparam Axis The axis along which to concatenate.
+ * @param ts The tensors, whose shapes must agree except along Axis.
+ * @return A fixed column-major tensor whose extent along Axis is the sum of those of the parts.
+ */
+template <std::size_t Axis, fixed_tensor... Tensors>
+    requires(sizeof...(Tensors) > 0)
+auto concatenate(const Tensors &...ts) {
+    static_assert(detail::compatible_parts<Axis, typename Tensors::shape_type...>(),
+                  "Tensors must have the same shape except along the concatenation axis");
+    using first_shape = typename std::tuple_element_t<0, std::tuple<Tensors...>>::shape_type;
+    constexpr std::size_t extent = (make_array(typename Tensors::shape_type{})[Axis] + ...);
+    using shape_type = decltype(detail::concatenated_shape<Axis, first_shape, extent>(
+        std::make_index_sequence<first_shape::size()>{}));
+    tensor<detail::joined_value_t<Tensors...>, shape_type, strides::column_major<shape_type>,
+           detail::first_error_checking<Tensors...>()>
+        result;
+    detail::concatenate_parts(result, Axis, ts...);
+    return result;
+}
+
+/**
+ * @brief Concatenates tensors along an axis.
+ * @param axis The axis along which to concatenate.
+ * @param ts The tensors, whose shapes must agree except along axis.
+ * @return A dynamic column-major tensor whose extent along axis is the sum of those of the parts.
+ * @throws std::invalid_argument if the shapes are incompatible (when error checking is enabled for the first tensor).
+ */
+template <host_tensor... Tensors>
+    requires(sizeof...(Tensors) > 0)
+auto concatenate(std::size_t axis, const Tensors &...ts) {
+    constexpr auto checking = detail::first_error_checking<Tensors...>();
+    const auto &first = std::get<0>(std::forward_as_tuple(ts...));
+    std::vector<std::size_t> shape(first.shape().begin(), first.shape().end());
+    if constexpr (checking == error_checking::enabled) {
+        if (axis >= shape.size()) {
+            throw std::invalid_argument("Tensors must have the same shape except along the concatenation axis");
+        }
+    }
+    shape[axis] = 0;
+    ((detail::check_part_shape<checking>(ts.shape(), shape, axis), shape[axis] += ts.shape()[axis]), ...);
+    tensor<detail::joined_value_t<Tensors...>, dynamic, dynamic, checking> result(shape);
+    detail::concatenate_parts(result, axis, ts...);
+    return result;
+}
+
+/**
+ * @brief Concatenates tensors along an axis into an existing tensor.
+ * @param out The output tensor, whose extent along axis must be the sum of those of the parts.
+ * @param axis The axis along which to concatenate.
+ * @param ts The tensors, whose shapes must agree with out except along axis.
+ * @throws std::invalid_argument if the shapes are incompatible (when error checking is enabled for out).
+ */
+template <host_tensor Out, host_tensor... Tensors>
+void concat_into(Out &out, std::size_t axis, const Tensors &...ts) {
+    constexpr auto checking = Out::error_checking();
+    const std::vector<std::size_t> shape(out.shape().begin(), out.shape().end());
+    if constexpr (checking == error_checking::enabled) {
+        std::size_t extent = 0;
+        ((detail::check_part_shape<checking>(ts.shape(), shape, axis), extent += ts.shape()[axis]), ...);
+        if (extent != shape[axis]) {
+            throw std::invalid_argument("Output extent must equal the total extent of the parts");
+        }
+    }
+    detail::concatenate_parts(out, axis, ts...);
+}
+
+/**
+ * @brief Stacks fixed tensors of the same shape along a new compile-time axis.
+ * @tparam Axis The position of the new axis in the result.
+ * @param ts The tensors, which must all have the same shape.
+ * @return A fixed column-major tensor with an axis of extent sizeof...(ts) inserted at Axis.
+ */
+template <std::size_t Axis, fixed_tensor... Tensors>
+    requires(sizeof...(Tensors) > 0)
+auto stack(const Tensors &...ts) {
+    using first_shape = typename std::tuple_element_t<0, std::tuple<Tensors...>>::shape_type;
+    static_assert(Axis <= first_shape::size(), "Stack axis out of range");
+    static_assert((std::is_same_v<first_shape, typename Tensors::shape_type> && ...),
+                  "Stacked tensors must have the same shape");
+    using shape_type = decltype(detail::stacked_shape<Axis, first_shape, sizeof...(Tensors)>(
+        std::make_index_sequence<first_shape::size() + 1>{}));
+    tensor<detail::joined_value_t<Tensors...>, shape_type, strides::column_major<shape_type>,
+           detail::first_error_checking<Tensors...>()>
+        result;
+    detail::stack_parts(result, Axis, ts...);
+    return result;
+}
+
+/**
+ * @brief Stacks tensors of the same shape along a new axis.
+ * @param axis The position of the new axis in the result.
+ * @param ts The tensors, which must all have the same shape.
+ * @return A dynamic column-major tensor with an axis of extent sizeof...(ts) inserted at axis.
+ * @throws std::invalid_argument if the shapes differ or the axis is out of range (when error checking is enabled
+ * for the first tensor).
+ */
+template <host_tensor... Tensors>
+    requires(sizeof...(Tensors) > 0)
+auto stack(std::size_t axis, const Tensors &...ts) {
+    constexpr auto checking = detail::first_error_checking<Tensors...>();
+    const auto &first = std::get<0>(std::forward_as_tuple(ts...));
+    std::vector<std::size_t> shape(first.shape().begin(), first.shape().end());
+    if constexpr (checking == error_checking::enabled) {
+        if (axis > shape.size()) {
+            throw std::invalid_argument("Stack axis out of range");
+        }
+        auto same = [&](const auto &t) { return std::ranges::equal(t.shape(), shape); };
+        if (!(same(ts) && ...)) {
+            throw std::invalid_argument("Stacked tensors must have the same shape");
+        }
+    }
+    shape.insert(shape.begin() + static_cast<std::ptrdiff_t>(axis), sizeof...(Tensors));
+    tensor<detail::joined_value_t<Tensors...>, dynamic, dynamic, checking> result(shape);
+    detail::stack_parts(result, axis, ts...);
+    return result;
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_CONCATENATION_HPP
@@ -0,0 +1,353 @@
+/**
+ * @file convolution.hpp
+ * @brief One and two dimensional convolution and correlation of tensors.
+ *
+ * This file provides convolve and correlate for a kernel of rank 1 or 2 applied along the leading
+ * axes of a signal. Any remaining axes of the signal are channels, each filtered independently by
+ * the same kernel, so a matrix whose columns are signals is filtered column by column.
+ *
+ * Two kernels are available. The direct kernel accumulates one shifted copy of the signal per
+ * kernel element, with contiguous inner loops the compiler can vectorize, and is split across
+ * threads by output blocks. The FFT kernel zero-pads to a fast transform length, multiplies
+ * spectra and transforms back. By default the cheaper one is chosen from the signal and kernel
+ * sizes; the FFT kernel needs a floating-point element type.
+ */
+#ifndef SQUINT_TENSOR_CONVOLUTION_HPP
+#define SQUINT_TENSOR_CONVOLUTION_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/quantity/quantity_ops.hpp"
+#include "squint/tensor/fft.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace squint {
+
+/**
+ * @brief Extent of the output of a convolution along each convolved axis.
+ */
+enum class convolution_mode : std::uint8_t {
+    full,  ///< Every position where the signal and kernel overlap: n + m - 1.
+    same,  ///< The size of the signal, centered on the full output: n.
+    valid, ///< Only positions where the kernel lies entirely inside the signal: n - m + 1.
+};
+
+/**
+ * @brief Algorithm used to compute a convolution.
+ */
+enum class convolution_method : std::uint8_t {
+    automatic, ///< Choose from the estimated cost of each method.
+    direct,    ///< Sum over the kernel elements.
+    fft,       ///< Multiply zero-padded spectra.
+};
+
+namespace detail {
+
+/**
+ * @brief Extents of a convolution, with a 1D convolution expressed as a 2D one of width 1.
+ */
+struct convolution_geometry {
+    std::array<std::size_t, 2> signal{1, 1};
+    std::array<std::size_t, 2> kernel{1, 1};
+    std::array<std::size_t, 2> output{1, 1};
+    std::array<std::size_t, 2> offset{0, 0}; ///< Index of output element 0 in the full output.
+    std::size_t channels = 1;
+};
+
+/**
+ * @brief Returns the number type of a tensor element: the element itself or the value of a quantity.
+ */
+template <typename V> auto convolution_number(const V &v) {
+    if constexpr (quantitative<V>) {
+        return v.value();
+    } else {
+        return v;
+    }
+}
+
+/**
+ * @brief Copies the numbers of a tensor into a column-major buffer of type N.
+ */
+template <typename N, host_tensor Tensor> auto gather_numbers(const Tensor &t) -> std::vector<N> {
+    std::vector<N> buffer;
+    buffer.reserve(t.size());
+    for (const auto &element : t) {
+        buffer.push_back(static_cast<N>(convolution_number(element)));
+    }
+    return buffer;
+}
+
+/**
+ * @brief Computes the extents of a convolution and the shape of its result.
+ * @throws std::invalid_argument if the kernel rank is not 1 or 2, exceeds the signal rank, or
+ * either operand is empty (when error checking is enabled).
+ */
+template <error_checking ErrorChecking, typename SignalShape, typename KernelShape>
+auto make_convolution_geometry(const SignalShape &signal_shape, const KernelShape &kernel_shape,
+                               convolution_mode mode) -> std::pair<convolution_geometry, std::vector<std::size_t>> {
+    const std::size_t rank = kernel_shape.size();
+    if constexpr (ErrorChecking == error_checking::enabled) {
+        if (rank == 0 || rank > 2 || rank > signal_shape.size()) {
+            throw std::invalid_argument("Convolution kernel must have rank 1 or 2, at most the signal rank");
+        }
+        for (std::size_t i = 0; i < rank; ++i) {
+            if (signal_shape[i] == 0 || kernel_shape[i] == 0) {
+                throw std::invalid_argument("Convolution operands must not be empty");
+            }
+        }
+    }
+    convolution_geometry g;
+    std::vector<std::size_t> shape(signal_shape.begin(), signal_shape.end());
+    for (std::size_t i = 0; i < rank; ++i) {
+        const std::size_t n = signal_shape[i];
+        const std::size_t m = kernel_shape[i];
+        g.signal[i] = n;
+        g.kernel[i] = m;
+        switch (mode) {
+        case convolution_mode::full:
+            g.output[i] = n + m - 1;
+            g.offset[i] = 0;
+            break;
+        case convolution_mode::same:
+            g.output[i] = n;
+            g.offset[i] = (m - 1) / 2;
+            break;
+        case convolution_mode::valid:
+            g.output[i] = n >= m ? n - m + 1 : 0;
+            g.offset[i] = m - 1;
+            break;
+        }
+        shape[i] = g.output[i];
+    }
+    for (std::size_t i = rank; i < signal_shape.size(); ++i) {
+        g.channels *= signal_shape[i];
+    }
+    return {g, shape};
+}
+
+/**
+ * @brief Direct convolution of column-major buffers.
+ *
+ * Every output block accumulates out[o] += k[j] * x[o + offset - j] for each kernel element,
+ * an axpy over a contiguous range of the signal.
+ */
+template <typename N>
+void convolve_direct(const std::vector<N> &x, const std::vector<N> &k, const convolution_geometry &g, N *out) {
+    constexpr std::size_t block = 4096;
+    const auto [n0, n1] = g.signal;
+    const auto [m0, m1] = g.kernel;
+    const auto [out0, out1] = g.output;
+    const auto off0 = static_cast<std::ptrdiff_t>(g.offset[0]);
+    const auto off1 = static_cast<std::ptrdiff_t>(g.offset[1]);
+    const std::size_t blocks = (out0 + block - 1) / block;
+    const std::size_t units = blocks * out1 * g.channels;
+    const std::size_t work = std::max<std::size_t>(1, std::min(out0, block) * m0 * m1);
+    const std::size_t grain = std::max<std::size_t>(1, (std::size_t{1} << 14) / work);
+    parallel_for(0, units, grain, [&](std::size_t first, std::size_t last) {
+        for (std::size_t unit = first; unit < last; ++unit) {
+            const std::size_t line = unit / blocks;
+            const auto lo = static_cast<std::ptrdiff_t>((unit % blocks) * block);
+            const auto hi = std::min(lo + static_cast<std::ptrdiff_t>(block), static_cast<std::ptrdiff_t>(out0));
+            const auto o1 = static_cast<std::ptrdiff_t>(line % out1);
+            const std::size_t channel = line / out1;
+            N *y = out + line * out0;
+            std::fill(y + lo, y + hi, N{});
+            for (std::size_t j1 = 0; j1 < m1; ++j1) {
+                const std::ptrdiff_t i1 = o1 + off1 - static_cast<std::ptrdiff_t>(j1);
+                if (i1 < 0 || i1 >= static_cast<std::ptrdiff_t>(n1)) {
+                    continue;
+                }
+                const N *column = x.data() + (channel * n1 + static_cast<std::size_t>(i1)) * n0;
+                for (std::size_t j0 = 0; j0 < m0; ++j0) {
+                    const N weight = k[j1 * m0 + j0];
+                    const std::ptrdiff_t shift = off0 - static_cast<std::ptrdiff_t>(j0);
+                    const std::ptrdiff_t begin = std::max(lo, -shift);
+                    const std::ptrdiff_t end = std::min(hi, static_cast<std::ptrdiff_t>(n0) - shift);
+                    for (std::ptrdiff_t o0 = begin; o0 < end; ++o0) {
+                        y[o0] += weight * column[o0 + shift];
+                    }
+                }
+            }
+        }
+    });
+}
+
+/**
+ * @brief FFT convolution of column-major buffers.
+ *
+ * Both operands are zero-padded to fast lengths of at least n + m - 1 along each convolved axis,
+ * so the circular convolution of the spectra equals the full linear convolution.
+ */
+template <typename N>
+void convolve_fft(const std::vector<N> &x, const std::vector<N> &k, const convolution_geometry &g, N *out) {
+    const std::size_t p0 = next_fast_length(g.signal[0] + g.kernel[0] - 1);
+    const std::size_t p1 = next_fast_length(g.signal[1] + g.kernel[1] - 1);
+    const std::size_t channels = g.channels;
+    tensor<N, dynamic, dynamic> signal({p0, p1, channels}, N{});
+    tensor<N, dynamic, dynamic> kernel({p0, p1}, N{});
+    for (std::size_t c = 0; c < channels; ++c) {
+        for (std::size_t i1 = 0; i1 < g.signal[1]; ++i1) {
+            std::copy_n(x.data() + (c * g.signal[1] + i1) * g.signal[0], g.signal[0],
+                        signal.data() + (c * p1 + i1) * p0);
+        }
+    }
+    for (std::size_t j1 = 0; j1 < g.kernel[1]; ++j1) {
+        std::copy_n(k.data() + j1 * g.kernel[0], g.kernel[0], kernel.data() + j1 * p0);
+    }
+    auto transform = [p1](const auto &t) {
+        if constexpr (complex_number<N>) {
+            return p1 > 1 ? fft(fft(t, 0), 1) : fft(t, 0);
+        } else {
+            return p1 > 1 ? fft(rfft(t, 0), 1) : rfft(t, 0);
+        }
+    };
+    auto spectrum = transform(signal);
+    const auto kernel_spectrum = transform(kernel);
+    const std::size_t plane = kernel_spectrum.size();
+    auto *values = spectrum.data();
+    const auto *weights = kernel_spectrum.data();
+    parallel_for(0, spectrum.size(), std::size_t{1} << 14, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            values[i] = detail::multiply(values[i], weights[i % plane]);
+        }
+    });
+    const auto full = [&] {
+        if constexpr (complex_number<N>) {
+            return p1 > 1 ? ifft(ifft(spectrum, 1), 0) : ifft(spectrum, 0);
+        } else {
+            return p1 > 1 ? irfft(ifft(spectrum, 1), p0, 0) : irfft(spectrum, p0, 0);
+        }
+    }();
+    const auto [out0, out1] = g.output;
+    for (std::size_t c = 0; c < channels; ++c) {
+        for (std::size_t o1 = 0; o1 < out1; ++o1) {
+            std::copy_n(full.data() + (c * p1 + o1 + g.offset[1]) * p0 + g.offset[0], out0,
+                        out + (c * out1 + o1) * out0);
+        }
+    }
+}
+
+/**
+ * @brief Returns true if the FFT kernel is expected to be faster than the direct kernel.
+ */
+inline auto prefer_fft_convolution(const convolution_geometry &g) -> bool {
+    const std::size_t taps = g.kernel[0] * g.kernel[1];
+    if (taps <= 32) {
+        return false;
+    }
+    const double direct = static_cast<double>(g.output[0] * g.output[1] * g.channels * taps);
+    const auto padded = static_cast<double>(next_fast_length(g.signal[0] + g.kernel[0] - 1) *
+                                            next_fast_length(g.signal[1] + g.kernel[1] - 1));
+    const double fft = 6.0 * static_cast<double>(g.channels + 1) * padded * std::bit_width(std::size_t(padded));
+    return fft < direct;
+}
+
+/**
+ * @brief Convolves a signal with a column-major kernel buffer.
+ */
+template <host_tensor Signal, typename KernelElement, typename N, typename KernelShape>
+auto convolve_numbers(const Signal &x, const std::vector<N> &k, const KernelShape &kernel_shape, convolution_mode mode,
+                      convolution_method method) {
+    using result_type = decltype(std::declval<std::remove_const_t<typename Signal::value_type>>() *
+                                 std::declval<KernelElement>());
+    static_assert(sizeof(result_type) == sizeof(N), "Result elements must have the layout of their numbers");
+    const auto [g, shape] = make_convolution_geometry<Signal::error_checking()>(x.shape(), kernel_shape, mode);
+    tensor<result_type, dynamic, dynamic> result(shape);
+    if (result.size() == 0) {
+        return result;
+    }
+    const auto signal = gather_numbers<N>(x);
+    auto *out = reinterpret_cast<N *>(result.data());
+    bool use_fft = false;
+    if constexpr (floating_point<fft_real_t<N>>) {
+        use_fft = method == convolution_method::fft ||
+                  (method == convolution_method::automatic && prefer_fft_convolution(g));
+    } else if constexpr (Signal::error_checking() == error_checking::enabled) {
+        if (method == convolution_method::fft) {
+            throw std::invalid_argument("FFT convolution requires a floating-point element type");
+        }
+    }
+    if (use_fft) {
+        if constexpr (floating_point<fft_real_t<N>>) {
+            convolve_fft(signal, k, g, out);
+        }
+    } else {
+        convolve_direct(signal, k, g, out);
+    }
+    return result;
+}
+
+/// @brief The number type of a convolution of tensors with elements A and B.
+template <typename A, typename B>
+using convolution_number_t = decltype(convolution_number(std::declval<std::remove_const_t<A>>()) *
+                                      convolution_number(std::declval<std::remove_const_t<B>>()));
+
+} // namespace detail
+
+/**
+ * @brief Convolves the leading axes of a signal with a kernel of rank 1 or 2.
+ *
+ * For a 1D kernel, full[i] = sum over j of x[i - j] k[j]; the 2D case sums over both axes. Axes
+ * of the signal beyond the rank of the kernel are channels, each convolved independently.
+ *
+ * @param x The signal.
+ * @param k The kernel.
+ * @param mode The extent of the output along the convolved axes.
+ * @param method The algorithm, chosen from the operand sizes by default.
+ * @return A column-major tensor of the products of signal and kernel elements.
+ * @throws std::invalid_argument if the kernel rank is not 1 or 2, exceeds the signal rank, or an
+ * operand is empty (when error checking is enabled).
+ */
+template <host_tensor Signal, host_tensor Kernel>
+auto convolve(const Signal &x, const Kernel &k, convolution_mode mode = convolution_mode::full,
+              convolution_method method = convolution_method::automatic) {
+    using number_type = detail::convolution_number_t<typename Signal::value_type, typename Kernel::value_type>;
+    return detail::convolve_numbers<Signal, std::remove_const_t<typename Kernel::value_type>>(
+        x, detail::gather_numbers<number_type>(k), k.shape(), mode, method);
+}
+
+/**
+ * @brief Cross-correlates the leading axes of a signal with a kernel of rank 1 or 2.
+ *
+ * Correlation is convolution with the kernel reversed along every axis (and conjugated for
+ * complex kernels): in valid mode, out[i] = sum over j of x[i + j] conj(k[j]).
+ *
+ * @param x The signal.
+ * @param k The kernel.
+ * @param mode The extent of the output along the correlated axes.
+ * @param method The algorithm, chosen from the operand sizes by default.
+ * @return A column-major tensor of the products of signal and kernel elements.
+ * @throws std::invalid_argument if the kernel rank is not 1 or 2, exceeds the signal rank, or an
+ * operand is empty (when error checking is enabled).
+ */
+template <host_tensor Signal, host_tensor Kernel>
+auto correlate(const Signal &x, const Kernel &k, convolution_mode mode = convolution_mode::full,
+               convolution_method method = convolution_method::automatic) {
+    using number_type = detail::convolution_number_t<typename Signal::value_type, typename Kernel::value_type>;
+    auto kernel = detail::gather_numbers<number_type>(k);
+    // Reversing a column-major buffer reverses every axis.
+    std::reverse(kernel.begin(), kernel.end());
+    if constexpr (complex_number<number_type>) {
+        for (auto &value : kernel) {
+            value = std::conj(value);
+        }
+    }
+    return detail::convolve_numbers<Signal, std::remove_const_t<typename Kernel::value_type>>(x, kernel, k.shape(),
+                                                                                              mode, method);
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_CONVOLUTION_HPP
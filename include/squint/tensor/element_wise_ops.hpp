@@ -14,8 +14,11 @@
 #include "squint/tensor/tensor.hpp"
 #include "squint/tensor/tensor_op_compatibility.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <type_traits>
+#include <utility>
 
 #ifdef SQUINT_USE_CUDA
 #include "squint/tensor/cuda/element_wise.hpp"
@@ -229,7 +232,7 @@ auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::opera
  */
 template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
           memory_space MemorySpace>
-auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::operator-() const -> tensor {
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::operator-() const & -> tensor {
     tensor result = this->copy();
     if constexpr (MemorySpace == memory_space::host) {
         std::transform(result.begin(), result.end(), result.begin(), std::negate{});
@@ -252,6 +255,37 @@ auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::opera
     return result;
 }
 
+// Unary negation of an expiring tensor
+/**
+ * @brief Unary negation operator for expiring tensors.
+ *
+ * Owning host tensors are negated in place and their storage is reused for the result.
+ *
+ * @return A tensor with all elements negated.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::operator-() && -> tensor {
+    if constexpr (OwnershipType == ownership_type::owner && MemorySpace == memory_space::host) {
+        std::transform(begin(), end(), begin(), std::negate{});
+        return std::move(*this);
+    } else {
+        return -std::as_const(*this);
+    }
+}
+
+/**
+ * @brief Concept for expiring tensors whose storage can hold the result of an element-wise operation.
+ *
+ * The tensor must own host memory and have the same type as its own copy(), so that reusing it
+ * yields the same result type as the copying operators.
+ *
+ * @tparam Tensor The type to check.
+ */
+template <typename Tensor>
+concept reusable_temporary = owning_tensor<Tensor> && host_tensor<Tensor> &&
+                             std::is_same_v<Tensor, decltype(std::declval<const Tensor &>().copy())>;
+
 // Element-wise addition
 /**
  * @brief Element-wise addition operator.
@@ -288,6 +322,122 @@ auto operator-(const tensor<T, Shape, Strides, ErrorChecking, OwnershipType, Mem
     return std::move(result);
 }
 
+// Element-wise addition with expiring operands
+/**
+ * @brief Element-wise addition operator reusing the storage of an expiring left-hand side.
+ * @param lhs The left-hand side tensor, whose storage holds the result.
+ * @param rhs The right-hand side tensor.
+ * @return The element-wise sum.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, typename U, typename OtherShape,
+          typename OtherStrides, enum error_checking OtherErrorChecking, enum ownership_type OtherOwnershipType>
+    requires reusable_temporary<tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host>>
+auto operator+(tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host> &&lhs,
+               const tensor<U, OtherShape, OtherStrides, OtherErrorChecking, OtherOwnershipType, memory_space::host>
+                   &rhs) {
+    lhs += rhs;
+    return std::move(lhs);
+}
+
+/**
+ * @brief Element-wise addition operator reusing the storage of an expiring right-hand side.
+ *
+ * Only used when the right-hand side has the same type as the result of the copying operator.
+ *
+ * @param lhs The left-hand side tensor.
+ * @param rhs The right-hand side tensor, whose storage holds the result.
+ * @return The element-wise sum.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          typename U, typename OtherShape, typename OtherStrides, enum error_checking OtherErrorChecking>
+    requires reusable_temporary<tensor<U, OtherShape, OtherStrides, OtherErrorChecking, ownership_type::owner,
+                                       memory_space::host>> &&
+             std::is_same_v<decltype(std::declval<const tensor<T, Shape, Strides, ErrorChecking, OwnershipType,
+                                                               memory_space::host> &>()
+                                         .copy()),
+                            tensor<U, OtherShape, OtherStrides, OtherErrorChecking, ownership_type::owner,
+                                   memory_space::host>>
+auto operator+(const tensor<T, Shape, Strides, ErrorChecking, OwnershipType, memory_space::host> &lhs,
+               tensor<U, OtherShape, OtherStrides, OtherErrorChecking, ownership_type::owner, memory_space::host>
+                   &&rhs) {
+    element_wise_compatible(lhs, rhs);
+    std::transform(lhs.begin(), lhs.end(), rhs.begin(), rhs.begin(), std::plus{});
+    return std::move(rhs);
+}
+
+/**
+ * @brief Element-wise addition operator for two expiring tensors, reusing the left-hand side.
+ * @param lhs The left-hand side tensor, whose storage holds the result.
+ * @param rhs The right-hand side tensor.
+ * @return The element-wise sum.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, typename U, typename OtherShape,
+          typename OtherStrides, enum error_checking OtherErrorChecking, enum ownership_type OtherOwnershipType>
+    requires reusable_temporary<tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host>>
+auto operator+(tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host> &&lhs,
+               tensor<U, OtherShape, OtherStrides, OtherErrorChecking, OtherOwnershipType, memory_space::host> &&rhs) {
+    lhs += rhs;
+    return std::move(lhs);
+}
+
+// Element-wise subtraction with expiring operands
+/**
+ * @brief Element-wise subtraction operator reusing the storage of an expiring left-hand side.
+ * @param lhs The left-hand side tensor, whose storage holds the result.
+ * @param rhs The right-hand side tensor.
+ * @return The element-wise difference.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, typename U, typename OtherShape,
+          typename OtherStrides, enum error_checking OtherErrorChecking, enum ownership_type OtherOwnershipType>
+    requires reusable_temporary<tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host>>
+auto operator-(tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host> &&lhs,
+               const tensor<U, OtherShape, OtherStrides, OtherErrorChecking, OtherOwnershipType, memory_space::host>
+                   &rhs) {
+    lhs -= rhs;
+    return std::move(lhs);
+}
+
+/**
+ * @brief Element-wise subtraction operator reusing the storage of an expiring right-hand side.
+ *
+ * Only used when the right-hand side has the same type as the result of the copying operator.
+ *
+ * @param lhs The left-hand side tensor.
+ * @param rhs The right-hand side tensor, whose storage holds the result.
+ * @return The element-wise difference.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          typename U, typename OtherShape, typename OtherStrides, enum error_checking OtherErrorChecking>
+    requires reusable_temporary<tensor<U, OtherShape, OtherStrides, OtherErrorChecking, ownership_type::owner,
+                                       memory_space::host>> &&
+             std::is_same_v<decltype(std::declval<const tensor<T, Shape, Strides, ErrorChecking, OwnershipType,
+                                                               memory_space::host> &>()
+                                         .copy()),
+                            tensor<U, OtherShape, OtherStrides, OtherErrorChecking, ownership_type::owner,
+                                   memory_space::host>>
+auto operator-(const tensor<T, Shape, Strides, ErrorChecking, OwnershipType, memory_space::host> &lhs,
+               tensor<U, OtherShape, OtherStrides, OtherErrorChecking, ownership_type::owner, memory_space::host>
+                   &&rhs) {
+    element_wise_compatible(lhs, rhs);
+    std::transform(lhs.begin(), lhs.end(), rhs.begin(), rhs.begin(), std::minus{});
+    return std::move(rhs);
+}
+
+/**
+ * @brief Element-wise subtraction operator for two expiring tensors, reusing the left-hand side.
+ * @param lhs The left-hand side tensor, whose storage holds the result.
+ * @param rhs The right-hand side tensor.
+ * @return The element-wise difference.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, typename U, typename OtherShape,
+          typename OtherStrides, enum error_checking OtherErrorChecking, enum ownership_type OtherOwnershipType>
+    requires reusable_temporary<tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host>>
+auto operator-(tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host> &&lhs,
+               tensor<U, OtherShape, OtherStrides, OtherErrorChecking, OtherOwnershipType, memory_space::host> &&rhs) {
+    lhs -= rhs;
+    return std::move(lhs);
+}
+
 } // namespace squint
 
 #endif // SQUINT_TENSOR_ELEMENT_WISE_OPS_HPP
\ No newline at end of file
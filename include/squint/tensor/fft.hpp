@@ -0,0 +1,833 @@
+/**
+ * @file fft.hpp
+ * @brief Fast Fourier transforms of real and complex tensors.
+ *
+ * This file provides one and two dimensional discrete Fourier transforms of host tensors along any
+ * axis. Every line along the transformed axis is an independent transform, so a rank-R tensor is
+ * a batch of transforms which are distributed across threads; a single large transform is instead
+ * parallelized within each pass.
+ *
+ * Transforms are computed by a mixed-radix Stockham autosort FFT (radices 2, 3, 4, 5, 7, 11 and
+ * 13), which needs no bit-reversal pass. Lengths with a larger prime factor are handled by
+ * Bluestein's algorithm on top of a power of two transform. Plans (factorization, twiddle factors
+ * and Bluestein kernels) are built once per length and cached.
+ *
+ * Inputs may be real or complex numbers or quantities. The transform of a quantity tensor is a
+ * tensor of complex quantities with the same dimension, and fftfreq returns frequencies in the
+ * reciprocal dimension of the sample spacing. The forward transform is unnormalized and the
+ * inverse transforms are scaled by 1/n.
+ */
+#ifndef SQUINT_TENSOR_FFT_HPP
+#define SQUINT_TENSOR_FFT_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/quantity/quantity.hpp"
+#include "squint/quantity/quantity_ops.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/tensor/tensor_op_compatibility.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <numbers>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace squint {
+
+namespace detail {
+
+/**
+ * @brief Process-wide cache of plans indexed by transform length.
+ *
+ * Plans are built outside the lock, so building a plan may itself request other plans.
+ *
+ * @tparam Plan The plan type, constructible from a length.
+ * @param n The transform length.
+ * @return The cached plan for the length.
+ */
+template <typename Plan> auto cached_plan(std::size_t n) -> std::shared_ptr<const Plan> {
+    static std::mutex mutex;
+    static std::unordered_map<std::size_t, std::shared_ptr<const Plan>> cache;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto it = cache.find(n); it != cache.end()) {
+            return it->second;
+        }
+    }
+    auto plan = std::make_shared<const Plan>(n);
+    std::lock_guard<std::mutex> lock(mutex);
+    return cache.try_emplace(n, std::move(plan)).first->second;
+}
+
+/**
+ * @brief Returns exp(-2πi * numerator / denominator), evaluated in double precision.
+ */
+template <typename T> auto unit_root(std::size_t numerator, std::size_t denominator) -> std::complex<T> {
+    const double angle = -2.0 * std::numbers::pi * static_cast<double>(numerator) / static_cast<double>(denominator);
+    return {static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle))};
+}
+
+/**
+ * @brief Multiplies two complex numbers without the NaN and infinity recovery of std::complex.
+ */
+template <typename T> inline auto multiply(const std::complex<T> &a, const std::complex<T> &b) -> std::complex<T> {
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+} // namespace detail
+
+/**
+ * @brief Precomputed complex-to-complex FFT of a fixed length.
+ *
+ * Plans are immutable once built and can be shared between threads; every call takes its own
+ * work buffer of work_size() elements.
+ *
+ * @tparam T The floating-point type of the real and imaginary parts.
+ */
+template <floating_point T> class fft_plan {
+  public:
+    using complex_type = std::complex<T>; ///< The complex type transformed by the plan.
+
+    /// @brief The largest prime handled directly by a Stockham pass; larger factors use Bluestein's algorithm.
+    static constexpr std::size_t max_radix = 13;
+
+    /**
+     * @brief Builds a plan for transforms of length n.
+     * @param n The transform length.
+     * @throws std::invalid_argument if n is zero.
+     */
+    explicit fft_plan(std::size_t n) : n_(n) {
+        if (n == 0) {
+            throw std::invalid_argument("FFT length must be positive");
+        }
+        std::vector<std::size_t> radices;
+        std::size_t rest = n;
+        while (rest % 4 == 0) {
+            radices.push_back(4);
+            rest /= 4;
+        }
+        for (std::size_t radix : {std::size_t{2}, std::size_t{3}, std::size_t{5}, std::size_t{7}, std::size_t{11},
+                                  std::size_t{13}}) {
+            while (rest % radix == 0) {
+                radices.push_back(radix);
+                rest /= radix;
+            }
+        }
+        if (rest != 1) {
+            build_bluestein();
+            return;
+        }
+        // Stage k splits transforms of length n_cur = n / (s * ...) into radix transforms of length m.
+        std::size_t n_cur = n;
+        std::size_t s = 1;
+        for (std::size_t radix : radices) {
+            const std::size_t m = n_cur / radix;
+            stage st{radix, m, s, twiddles_.size(), 0};
+            for (std::size_t p = 0; p < m; ++p) {
+                for (std::size_t k = 1; k < radix; ++k) {
+                    twiddles_.push_back(detail::unit_root<T>(p * k, n_cur));
+                }
+            }
+            st.roots = twiddles_.size();
+            for (std::size_t k = 0; k < radix; ++k) {
+                twiddles_.push_back(detail::unit_root<T>(k, radix));
+            }
+            stages_.push_back(st);
+            n_cur = m;
+            s *= radix;
+        }
+    }
+
+    /**
+     * @brief Returns the cached plan for a length, building it on first use.
+     * @param n The transform length.
+     * @return A shared pointer to the plan.
+     */
+    static auto get(std::size_t n) -> std::shared_ptr<const fft_plan> { return detail::cached_plan<fft_plan>(n); }
+
+    /// @brief Returns the transform length.
+    [[nodiscard]] auto size() const -> std::size_t { return n_; }
+
+    /// @brief Returns the number of complex elements needed for the work buffer.
+    [[nodiscard]] auto work_size() const -> std::size_t { return inner_ ? 2 * inner_->size() : n_; }
+
+    /**
+     * @brief Computes the unnormalized forward transform in place.
+     * @param data The n elements to transform.
+     * @param work A work buffer of work_size() elements.
+     * @param parallel Whether the passes may be split across threads.
+     */
+    void forward(complex_type *data, complex_type *work, bool parallel = false) const {
+        if (inner_) {
+            bluestein(data, work, parallel);
+        } else {
+            stockham(data, work, parallel);
+        }
+    }
+
+    /**
+     * @brief Computes the inverse transform in place, scaled by 1/n.
+     * @param data The n elements to transform.
+     * @param work A work buffer of work_size() elements.
+     * @param parallel Whether the passes may be split across threads.
+     */
+    void inverse(complex_type *data, complex_type *work, bool parallel = false) const {
+        for (std::size_t i = 0; i < n_; ++i) {
+            data[i] = std::conj(data[i]);
+        }
+        forward(data, work, parallel);
+        const T scale = T(1) / static_cast<T>(n_);
+        for (std::size_t i = 0; i < n_; ++i) {
+            data[i] = std::conj(data[i]) * scale;
+        }
+    }
+
+  private:
+    /// @brief One Stockham pass: radix-point butterflies over m groups with stride s.
+    struct stage {
+        std::size_t radix;
+        std::size_t m;
+        std::size_t s;
+        std::size_t twiddles; ///< Offset of the m × (radix - 1) twiddle factors.
+        std::size_t roots;    ///< Offset of the radix roots of unity.
+    };
+
+    /// @brief Below this length a transform always runs on the calling thread.
+    static constexpr std::size_t parallel_threshold = std::size_t{1} << 15;
+
+    void build_bluestein() {
+        const std::size_t m = std::bit_ceil(2 * n_ - 1);
+        inner_ = get(m);
+        chirp_.resize(n_);
+        for (std::size_t k = 0; k < n_; ++k) {
+            // exp(-πi k² / n), with k² reduced modulo 2n to keep the angle accurate for large k.
+            chirp_[k] = detail::unit_root<T>((k * k) % (2 * n_), 2 * n_);
+        }
+        kernel_.assign(m, complex_type{});
+        kernel_[0] = std::conj(chirp_[0]);
+        for (std::size_t k = 1; k < n_; ++k) {
+            kernel_[k] = kernel_[m - k] = std::conj(chirp_[k]);
+        }
+        std::vector<complex_type> work(inner_->work_size());
+        inner_->forward(kernel_.data(), work.data());
+        const T scale = T(1) / static_cast<T>(m);
+        for (auto &value : kernel_) {
+            value *= scale;
+        }
+    }
+
+    void bluestein(complex_type *data, complex_type *work, bool parallel) const {
+        const std::size_t m = inner_->size();
+        complex_type *a = work;
+        for (std::size_t k = 0; k < n_; ++k) {
+            a[k] = detail::multiply(data[k], chirp_[k]);
+        }
+        std::fill(a + n_, a + m, complex_type{});
+        inner_->forward(a, work + m, parallel);
+        // Circular convolution with the chirp kernel; the inverse transform uses conj(FFT(conj(.))).
+        for (std::size_t k = 0; k < m; ++k) {
+            a[k] = std::conj(detail::multiply(a[k], kernel_[k]));
+        }
+        inner_->forward(a, work + m, parallel);
+        for (std::size_t k = 0; k < n_; ++k) {
+            data[k] = detail::multiply(std::conj(a[k]), chirp_[k]);
+        }
+    }
+
+    void stockham(complex_type *data, complex_type *work, bool parallel) const {
+        complex_type *x = data;
+        complex_type *y = work;
+        for (const auto &st : stages_) {
+            if (!parallel || n_ < parallel_threshold) {
+                run_stage(st, x, y, 0, st.m, 0, st.s);
+            } else if (st.m >= st.s) {
+                parallel_for(0, st.m, std::max<std::size_t>(1, 4096 / st.s),
+                             [&](std::size_t first, std::size_t last) { run_stage(st, x, y, first, last, 0, st.s); });
+            } else {
+                parallel_for(0, st.s, std::max<std::size_t>(1, 4096 / st.m),
+                             [&](std::size_t first, std::size_t last) { run_stage(st, x, y, 0, st.m, first, last); });
+            }
+            std::swap(x, y);
+        }
+        if (x != data) {
+            std::copy(x, x + n_, data);
+        }
+    }
+
+    void run_stage(const stage &st, const complex_type *x, complex_type *y, std::size_t p_begin, std::size_t p_end,
+                   std::size_t q_begin, std::size_t q_end) const {
+        switch (st.radix) {
+        case 2:
+            butterflies<2>(st, x, y, p_begin, p_end, q_begin, q_end);
+            break;
+        case 3:
+            butterflies<3>(st, x, y, p_begin, p_end, q_begin, q_end);
+            break;
+        case 4:
+            butterflies<4>(st, x, y, p_begin, p_end, q_begin, q_end);
+            break;
+        default:
+            butterflies<0>(st, x, y, p_begin, p_end, q_begin, q_end);
+            break;
+        }
+    }
+
+    /**
+     * @brief Runs the butterflies of a pass for a range of groups and strides.
+     *
+     * Element q + s(p + jm) of x is point j of butterfly (p, q), and output k of the butterfly,
+     * multiplied by the twiddle factor w^(pk) of the current length, goes to y[q + s(rp + k)].
+     *
+     * @tparam R The radix, or 0 for a generic radix read from the stage.
+     */
+    template <std::size_t R>
+    void butterflies(const stage &st, const complex_type *x, complex_type *y, std::size_t p_begin, std::size_t p_end,
+                     std::size_t q_begin, std::size_t q_end) const {
+        const std::size_t r = R == 0 ? st.radix : R;
+        const std::size_t m = st.m;
+        const std::size_t s = st.s;
+        const complex_type *roots = twiddles_.data() + st.roots;
+        std::array<complex_type, max_radix> a{};
+        std::array<complex_type, max_radix> b{};
+        for (std::size_t p = p_begin; p < p_end; ++p) {
+            const complex_type *w = twiddles_.data() + st.twiddles + p * (r - 1);
+            for (std::size_t q = q_begin; q < q_end; ++q) {
+                for (std::size_t j = 0; j < r; ++j) {
+                    a[j] = x[q + s * (p + j * m)];
+                }
+                if constexpr (R == 2) {
+                    b[0] = a[0] + a[1];
+                    b[1] = a[0] - a[1];
+                } else if constexpr (R == 3) {
+                    const T half = T(0.5);
+                    const T sin60 = static_cast<T>(std::numbers::sqrt3 / 2);
+                    const complex_type sum = a[1] + a[2];
+                    const complex_type t = a[0] - half * sum;
+                    const complex_type d = a[1] - a[2];
+                    const complex_type u(sin60 * d.imag(), -sin60 * d.real());
+                    b[0] = a[0] + sum;
+                    b[1] = t + u;
+                    b[2] = t - u;
+                } else if constexpr (R == 4) {
+                    const complex_type t0 = a[0] + a[2];
+                    const complex_type t1 = a[0] - a[2];
+                    const complex_type t2 = a[1] + a[3];
+                    const complex_type d = a[1] - a[3];
+                    const complex_type t3(d.imag(), -d.real());
+                    b[0] = t0 + t2;
+                    b[1] = t1 + t3;
+                    b[2] = t0 - t2;
+                    b[3] = t1 - t3;
+                } else {
+                    for (std::size_t k = 0; k < r; ++k) {
+                        complex_type sum = a[0];
+                        std::size_t root = 0; // (j * k) mod r
+                        for (std::size_t j = 1; j < r; ++j) {
+                            root += k;
+                            root -= root >= r ? r : 0;
+                            sum += detail::multiply(a[j], roots[root]);
+                        }
+                        b[k] = sum;
+                    }
+                }
+                complex_type *out = y + q + s * r * p;
+                out[0] = b[0];
+                for (std::size_t k = 1; k < r; ++k) {
+                    out[s * k] = detail::multiply(b[k], w[k - 1]);
+                }
+            }
+        }
+    }
+
+    std::size_t n_;
+    std::vector<stage> stages_;
+    std::vector<complex_type> twiddles_;
+    std::shared_ptr<const fft_plan> inner_; ///< Power of two plan used by Bluestein's algorithm.
+    std::vector<complex_type> chirp_;
+    std::vector<complex_type> kernel_; ///< Transform of the conjugate chirp, scaled by 1/m.
+};
+
+/**
+ * @brief Precomputed real-to-complex FFT of a fixed length.
+ *
+ * Even lengths are transformed as a complex transform of half the length over the packed
+ * even/odd samples, followed by a split pass; odd lengths use a full complex transform.
+ *
+ * @tparam T The floating-point type of the samples.
+ */
+template <floating_point T> class rfft_plan {
+  public:
+    using complex_type = std::complex<T>; ///< The complex type of the spectrum.
+
+    /**
+     * @brief Builds a plan for real transforms of length n.
+     * @param n The number of real samples.
+     * @throws std::invalid_argument if n is zero.
+     */
+    explicit rfft_plan(std::size_t n) : n_(n), half_(n % 2 == 0 ? n / 2 : n) {
+        if (n == 0) {
+            throw std::invalid_argument("FFT length must be positive");
+        }
+        complex_ = fft_plan<T>::get(half_);
+        if (n % 2 == 0) {
+            twiddles_.resize(half_ + 1);
+            for (std::size_t k = 0; k <= half_; ++k) {
+                twiddles_[k] = detail::unit_root<T>(k, n);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the cached plan for a length, building it on first use.
+     * @param n The number of real samples.
+     * @return A shared pointer to the plan.
+     */
+    static auto get(std::size_t n) -> std::shared_ptr<const rfft_plan> { return detail::cached_plan<rfft_plan>(n); }
+
+    /// @brief Returns the number of real samples.
+    [[nodiscard]] auto size() const -> std::size_t { return n_; }
+
+    /// @brief Returns the number of complex elements needed for the work buffer.
+    [[nodiscard]] auto work_size() const -> std::size_t { return half_ + complex_->work_size(); }
+
+    /**
+     * @brief Computes the n/2 + 1 non-negative frequency terms of a real signal.
+     * @param in The first sample.
+     * @param in_stride The distance between samples.
+     * @param out The first output element.
+     * @param out_stride The distance between output elements.
+     * @param work A work buffer of work_size() elements.
+     * @param parallel Whether the transform may be split across threads.
+     */
+    void forward(const T *in, std::size_t in_stride, complex_type *out, std::size_t out_stride, complex_type *work,
+                 bool parallel = false) const {
+        complex_type *z = work;
+        if (n_ % 2 != 0) {
+            for (std::size_t i = 0; i < n_; ++i) {
+                z[i] = complex_type(in[i * in_stride]);
+            }
+            complex_->forward(z, work + half_, parallel);
+            for (std::size_t k = 0; k <= n_ / 2; ++k) {
+                out[k * out_stride] = z[k];
+            }
+            return;
+        }
+        for (std::size_t i = 0; i < half_; ++i) {
+            z[i] = complex_type(in[2 * i * in_stride], in[(2 * i + 1) * in_stride]);
+        }
+        complex_->forward(z, work + half_, parallel);
+        // Split Z = FFT(even) + i FFT(odd) and combine: X[k] = E[k] + w^k O[k].
+        for (std::size_t k = 0; k <= half_; ++k) {
+            const complex_type zk = z[k % half_];
+            const complex_type zc = std::conj(z[(half_ - k) % half_]);
+            const complex_type even = (zk + zc) * T(0.5);
+            const complex_type diff = (zk - zc) * T(0.5);
+            const complex_type odd(diff.imag(), -diff.real());
+            out[k * out_stride] = even + detail::multiply(twiddles_[k], odd);
+        }
+    }
+
+    /**
+     * @brief Reconstructs a real signal from its n/2 + 1 non-negative frequency terms, scaled by 1/n.
+     * @param in The first spectrum element.
+     * @param in_stride The distance between spectrum elements.
+     * @param out The first output sample.
+     * @param out_stride The distance between output samples.
+     * @param work A work buffer of work_size() elements.
+     * @param parallel Whether the transform may be split across threads.
+     */
+    void inverse(const complex_type *in, std::size_t in_stride, T *out, std::size_t out_stride, complex_type *work,
+                 bool parallel = false) const {
+        complex_type *z = work;
+        if (n_ % 2 != 0) {
+            z[0] = complex_type(in[0].real());
+            for (std::size_t k = 1; k <= n_ / 2; ++k) {
+                z[k] = in[k * in_stride];
+                z[n_ - k] = std::conj(z[k]);
+            }
+            complex_->inverse(z, work + half_, parallel);
+            for (std::size_t i = 0; i < n_; ++i) {
+                out[i * out_stride] = z[i].real();
+            }
+            return;
+        }
+        const complex_type first(in[0].real());
+        const complex_type last(in[half_ * in_stride].real());
+        for (std::size_t k = 0; k < half_; ++k) {
+            const complex_type xk = k == 0 ? first : in[k * in_stride];
+            const complex_type xc = std::conj(half_ - k == half_ ? last : in[(half_ - k) * in_stride]);
+            const complex_type even = (xk + xc) * T(0.5);
+            const complex_type odd = detail::multiply((xk - xc) * T(0.5), std::conj(twiddles_[k]));
+            z[k] = even + complex_type(-odd.imag(), odd.real());
+        }
+        complex_->inverse(z, work + half_, parallel);
+        for (std::size_t i = 0; i < half_; ++i) {
+            out[2 * i * out_stride] = z[i].real();
+            out[(2 * i + 1) * out_stride] = z[i].imag();
+        }
+    }
+
+  private:
+    std::size_t n_;
+    std::size_t half_;
+    std::shared_ptr<const fft_plan<T>> complex_;
+    std::vector<complex_type> twiddles_;
+};
+
+namespace detail {
+
+/// @brief The number type of an element: the element itself, or the value type of a quantity.
+template <typename V> struct fft_number {
+    using type = V;
+};
+template <quantitative V> struct fft_number<V> {
+    using type = typename V::value_type;
+};
+template <typename V> using fft_number_t = typename fft_number<std::remove_const_t<V>>::type;
+
+/// @brief The real floating-point type underlying a real or complex number.
+template <typename N> struct fft_real {
+    using type = N;
+};
+template <complex_number N> struct fft_real<N> {
+    using type = typename N::value_type;
+};
+template <typename V> using fft_real_t = typename fft_real<fft_number_t<V>>::type;
+
+/// @brief The element type holding a number N with the dimension of the element type V.
+template <typename V, typename N> struct fft_rebind {
+    using type = N;
+};
+template <quantitative V, typename N> struct fft_rebind<V, N> {
+    using type = quantity<N, typename V::dimension_type, V::error_checking()>;
+};
+template <typename V, typename N> using fft_rebind_t = typename fft_rebind<std::remove_const_t<V>, N>::type;
+
+/**
+ * @brief Applies a function to every line of a tensor along an axis.
+ *
+ * The output is column-major with the given shape. Lines are distributed across threads; when
+ * there is a single line the function is told it may parallelize internally instead.
+ *
+ * @param in The first input element.
+ * @param in_shape The shape of the input.
+ * @param in_strides The strides of the input.
+ * @param out The first output element.
+ * @param out_shape The shape of the output, equal to the input shape except along the axis.
+ * @param axis The axis along which lines run.
+ * @param line Called as line(in_line, in_stride, out_line, out_stride, scratch, parallel).
+ */
+template <typename In, typename Out, typename C, typename LineFn>
+void for_each_line(const In *in, const std::vector<std::size_t> &in_shape, const std::vector<std::size_t> &in_strides,
+                   Out *out, const std::vector<std::size_t> &out_shape, std::size_t axis, LineFn &&line) {
+    const std::size_t rank = in_shape.size();
+    std::vector<std::size_t> out_strides(rank, 1);
+    for (std::size_t i = 1; i < rank; ++i) {
+        out_strides[i] = out_strides[i - 1] * out_shape[i - 1];
+    }
+    std::size_t lines = 1;
+    for (std::size_t i = 0; i < rank; ++i) {
+        lines *= i == axis ? 1 : in_shape[i];
+    }
+    auto run = [&](std::size_t first, std::size_t last, bool parallel) {
+        std::vector<C> scratch;
+        for (std::size_t l = first; l < last; ++l) {
+            std::size_t in_offset = 0;
+            std::size_t out_offset = 0;
+            std::size_t rest = l;
+            for (std::size_t i = 0; i < rank; ++i) {
+                if (i != axis) {
+                    const std::size_t index = rest % in_shape[i];
+                    rest /= in_shape[i];
+                    in_offset += index * in_strides[i];
+                    out_offset += index * out_strides[i];
+                }
+            }
+            line(in + in_offset, in_strides[axis], out + out_offset, out_strides[axis], scratch, parallel);
+        }
+    };
+    if (lines == 1) {
+        run(0, 1, true);
+    } else {
+        const std::size_t grain = std::max<std::size_t>(1, 4096 / std::max<std::size_t>(1, in_shape[axis]));
+        parallel_for(0, lines, grain, [&](std::size_t first, std::size_t last) { run(first, last, false); });
+    }
+}
+
+/**
+ * @brief Returns the shape and strides of a tensor as vectors, checking the transform axis.
+ */
+template <host_tensor Tensor>
+auto fft_layout(const Tensor &x, std::size_t axis) -> std::pair<std::vector<std::size_t>, std::vector<std::size_t>> {
+    const auto shape = x.shape();
+    const auto strides = x.strides();
+    if constexpr (Tensor::error_checking() == error_checking::enabled) {
+        if (axis >= shape.size()) {
+            throw std::invalid_argument("FFT axis out of range");
+        }
+    }
+    return {std::vector<std::size_t>(shape.begin(), shape.end()),
+            std::vector<std::size_t>(strides.begin(), strides.end())};
+}
+
+/**
+ * @brief Complex transform of every line of a tensor along an axis.
+ * @tparam Inverse Whether to compute the inverse transform.
+ */
+template <bool Inverse, host_tensor Tensor> auto complex_transform(const Tensor &x, std::size_t axis) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    using number_type = fft_number_t<value_type>;
+    using real_type = fft_real_t<value_type>;
+    using complex_type = std::complex<real_type>;
+    auto [shape, strides] = fft_layout(x, axis);
+    tensor<fft_rebind_t<value_type, complex_type>, dynamic, dynamic> result(shape);
+    if (result.size() == 0) {
+        return result;
+    }
+    const std::size_t n = shape[axis];
+    const auto plan = fft_plan<real_type>::get(n);
+    const auto *in = reinterpret_cast<const number_type *>(x.data());
+    auto *out = reinterpret_cast<complex_type *>(result.data());
+    for_each_line<number_type, complex_type, complex_type>(
+        in, shape, strides, out, shape, axis,
+        [&](const number_type *src, std::size_t src_stride, complex_type *dst, std::size_t dst_stride,
+            std::vector<complex_type> &scratch, bool parallel) {
+            scratch.resize(n + plan->work_size());
+            complex_type *buffer = scratch.data();
+            for (std::size_t i = 0; i < n; ++i) {
+                buffer[i] = complex_type(src[i * src_stride]);
+            }
+            if constexpr (Inverse) {
+                plan->inverse(buffer, buffer + n, parallel);
+            } else {
+                plan->forward(buffer, buffer + n, parallel);
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                dst[i * dst_stride] = buffer[i];
+            }
+        });
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * @brief Returns the smallest length of at least n whose only prime factors are 2, 3 and 5.
+ *
+ * Zero-padding a transform to such a length keeps it on the fastest radices.
+ *
+ * @param n The minimum length.
+ * @return The padded length, 1 for n = 0.
+ */
+inline auto next_fast_length(std::size_t n) -> std::size_t {
+    std::size_t best = std::bit_ceil(std::max<std::size_t>(n, 1));
+    for (std::size_t p5 = 1; p5 < best; p5 *= 5) {
+        for (std::size_t p35 = p5; p35 < best; p35 *= 3) {
+            std::size_t length = p35;
+            while (length < n) {
+                length *= 2;
+            }
+            best = std::min(best, length);
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Concept for element types that can be Fourier transformed.
+ *
+ * Real or complex numbers, or quantities of them, with a floating-point representation.
+ */
+template <typename T>
+concept fft_element = scalar<std::remove_const_t<T>> && floating_point<detail::fft_real_t<T>>;
+
+/**
+ * @brief Computes the discrete Fourier transform of every line of a tensor along an axis.
+ *
+ * X[k] = sum over j of x[j] exp(-2πi jk / n), with n the extent of the axis.
+ *
+ * @param x The tensor to transform, real or complex.
+ * @param axis The axis to transform along.
+ * @return A column-major complex tensor of the same shape, with the dimension of x for quantities.
+ * @throws std::invalid_argument if the axis is out of range (when error checking is enabled).
+ */
+template <host_tensor Tensor>
+    requires fft_element<typename Tensor::value_type>
+auto fft(const Tensor &x, std::size_t axis = 0) {
+    return detail::complex_transform<false>(x, axis);
+}
+
+/**
+ * @brief Computes the inverse discrete Fourier transform of every line of a tensor along an axis.
+ *
+ * x[j] = 1/n sum over k of X[k] exp(2πi jk / n), with n the extent of the axis.
+ *
+ * @param x The spectrum to transform.
+ * @param axis The axis to transform along.
+ * @return A column-major complex tensor of the same shape.
+ * @throws std::invalid_argument if the axis is out of range (when error checking is enabled).
+ */
+template <host_tensor Tensor>
+    requires fft_element<typename Tensor::value_type>
+auto ifft(const Tensor &x, std::size_t axis = 0) {
+    return detail::complex_transform<true>(x, axis);
+}
+
+/**
+ * @brief Computes the two dimensional discrete Fourier transform over the first two axes.
+ * @param x The tensor to transform, of rank 2 or more.
+ * @return A column-major complex tensor of the same shape.
+ */
+template <host_tensor Tensor>
+    requires fft_element<typename Tensor::value_type>
+auto fft2(const Tensor &x) {
+    return fft(fft(x, 0), 1);
+}
+
+/**
+ * @brief Computes the two dimensional inverse discrete Fourier transform over the first two axes.
+ * @param x The spectrum to transform, of rank 2 or more.
+ * @return A column-major complex tensor of the same shape.
+ */
+template <host_tensor Tensor>
+    requires fft_element<typename Tensor::value_type>
+auto ifft2(const Tensor &x) {
+    return ifft(ifft(x, 0), 1);
+}
+
+/**
+ * @brief Computes the non-negative frequency terms of the transform of a real tensor along an axis.
+ *
+ * The remaining terms follow from the Hermitian symmetry X[n - k] = conj(X[k]).
+ *
+ * @param x The real tensor to transform.
+ * @param axis The axis to transform along.
+ * @return A column-major complex tensor with n/2 + 1 elements along the axis.
+ * @throws std::invalid_argument if the axis is out of range (when error checking is enabled).
+ */
+template <host_tensor Tensor>
+    requires fft_element<typename Tensor::value_type> &&
+             (!complex_number<detail::fft_number_t<typename Tensor::value_type>>)
+auto rfft(const Tensor &x, std::size_t axis = 0) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    using real_type = detail::fft_real_t<value_type>;
+    using complex_type = std::complex<real_type>;
+    auto [shape, strides] = detail::fft_layout(x, axis);
+    const std::size_t n = shape[axis];
+    auto out_shape = shape;
+    out_shape[axis] = n / 2 + 1;
+    tensor<detail::fft_rebind_t<value_type, complex_type>, dynamic, dynamic> result(out_shape);
+    if (x.size() == 0) {
+        return result;
+    }
+    const auto plan = rfft_plan<real_type>::get(n);
+    detail::for_each_line<real_type, complex_type, complex_type>(
+        reinterpret_cast<const real_type *>(x.data()), shape, strides,
+        reinterpret_cast<complex_type *>(result.data()), out_shape, axis,
+        [&](const real_type *src, std::size_t src_stride, complex_type *dst, std::size_t dst_stride,
+            std::vector<complex_type> &scratch, bool parallel) {
+            scratch.resize(plan->work_size());
+            plan->forward(src, src_stride, dst, dst_stride, scratch.data(), parallel);
+        });
+    return result;
+}
+
+/**
+ * @brief Reconstructs real signals from their non-negative frequency terms along an axis.
+ *
+ * The imaginary parts of the zero and (for even n) Nyquist terms are ignored.
+ *
+ * @param x The spectrum, with n/2 + 1 elements along the axis.
+ * @param n The number of real samples to reconstruct.
+ * @param axis The axis to transform along.
+ * @return A column-major real tensor with n elements along the axis.
+ * @throws std::invalid_argument if the axis or spectrum length does not match (when error checking is enabled).
+ */
+template <host_tensor Tensor>
+    requires fft_element<typename Tensor::value_type> &&
+             complex_number<detail::fft_number_t<typename Tensor::value_type>>
+auto irfft(const Tensor &x, std::size_t n, std::size_t axis = 0) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    using real_type = detail::fft_real_t<value_type>;
+    using complex_type = std::complex<real_type>;
+    auto [shape, strides] = detail::fft_layout(x, axis);
+    if constexpr (Tensor::error_checking() == error_checking::enabled) {
+        if (shape[axis] != n / 2 + 1) {
+            throw std::invalid_argument("Spectrum length must be n / 2 + 1");
+        }
+    }
+    auto out_shape = shape;
+    out_shape[axis] = n;
+    tensor<detail::fft_rebind_t<value_type, real_type>, dynamic, dynamic> result(out_shape);
+    if (result.size() == 0) {
+        return result;
+    }
+    const auto plan = rfft_plan<real_type>::get(n);
+    detail::for_each_line<complex_type, real_type, complex_type>(
+        reinterpret_cast<const complex_type *>(x.data()), shape, strides,
+        reinterpret_cast<real_type *>(result.data()), out_shape, axis,
+        [&](const complex_type *src, std::size_t src_stride, real_type *dst, std::size_t dst_stride,
+            std::vector<complex_type> &scratch, bool parallel) {
+            scratch.resize(plan->work_size());
+            plan->inverse(src, src_stride, dst, dst_stride, scratch.data(), parallel);
+        });
+    return result;
+}
+
+/**
+ * @brief Returns the sample frequencies of an n-point transform.
+ *
+ * The frequencies are k / (n d) for k = 0, ..., ceil(n/2) - 1 followed by the negative
+ * frequencies -floor(n/2), ..., -1, divided by n d, matching the order of fft.
+ *
+ * @param n The transform length.
+ * @param spacing The sample spacing d, a number or a quantity such as a duration or a length.
+ * @return An n-element tensor in the reciprocal unit of the spacing.
+ */
+template <scalar D>
+    requires floating_point<blas_type_t<D>>
+auto fftfreq(std::size_t n, const D &spacing) {
+    using real_type = blas_type_t<D>;
+    using frequency_type = decltype(real_type(1) / spacing);
+    tensor<frequency_type, dynamic, dynamic> result({n});
+    const auto period = static_cast<real_type>(n) * spacing;
+    for (std::size_t k = 0; k < n; ++k) {
+        const auto index = k < (n + 1) / 2 ? static_cast<real_type>(k) : -static_cast<real_type>(n - k);
+        result(k) = index / period;
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the sample frequencies of the n/2 + 1 terms computed by rfft.
+ * @param n The number of real samples.
+ * @param spacing The sample spacing d, a number or a quantity such as a duration or a length.
+ * @return An (n/2 + 1)-element tensor in the reciprocal unit of the spacing.
+ */
+template <scalar D>
+    requires floating_point<blas_type_t<D>>
+auto rfftfreq(std::size_t n, const D &spacing) {
+    using real_type = blas_type_t<D>;
+    using frequency_type = decltype(real_type(1) / spacing);
+    tensor<frequency_type, dynamic, dynamic> result({n / 2 + 1});
+    const auto period = static_cast<real_type>(n) * spacing;
+    for (std::size_t k = 0; k <= n / 2; ++k) {
+        result(k) = static_cast<real_type>(k) / period;
+    }
+    return result;
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_FFT_HPP
@@ -0,0 +1,331 @@
+/**
+ * @file indexing.hpp
+ * @brief Gather and scatter operations with index lists.
+ *
+ * This file provides take and index_select, which gather the slices of a tensor at a list of
+ * indices along one axis, and scatter_add, which accumulates slices into a tensor at a list of
+ * indices. Indices may be given by any range of integers, including integer tensors.
+ *
+ * The kernels compute element offsets from the strides once per call instead of creating a view
+ * per index, and copy whole runs with std::copy_n when the slices are contiguous. Work is split
+ * across threads; scatter_add never lets two threads update the same element, either because
+ * every thread owns a set of lines along the indexed axis or, when there are few such lines,
+ * because the updates are sorted by index and every thread owns a set of target indices. The
+ * updates to each element are applied in index list order, so results are deterministic.
+ */
+#ifndef SQUINT_TENSOR_INDEXING_HPP
+#define SQUINT_TENSOR_INDEXING_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace squint {
+
+namespace detail {
+
+/**
+ * @brief Offsets of the elements before and after an axis.
+ *
+ * The element with column-major indices (i, j, o) relative to the axis, where i indexes the axes
+ * before it and o the axes after it, is at inner[i] + j * stride + outer[o].
+ */
+struct axis_offsets {
+    std::vector<std::size_t> inner;
+    std::vector<std::size_t> outer;
+    std::size_t stride;
+    bool contiguous_inner; ///< True if inner[i] == i, so inner runs can be copied with std::copy_n.
+};
+
+/**
+ * @brief Computes the offsets of the elements of a tensor around an axis.
+ */
+template <typename ShapeRange, typename StrideRange>
+auto make_axis_offsets(const ShapeRange &shape, const StrideRange &strides, std::size_t axis) -> axis_offsets {
+    auto offsets_of = [&](std::size_t first, std::size_t last) {
+        std::vector<std::size_t> offsets{0};
+        for (std::size_t k = first; k < last; ++k) {
+            const std::size_t count = offsets.size();
+            offsets.resize(count * shape[k]);
+            for (std::size_t m = 1; m < shape[k]; ++m) {
+                for (std::size_t c = 0; c < count; ++c) {
+                    offsets[m * count + c] = offsets[c] + m * strides[k];
+                }
+            }
+        }
+        return offsets;
+    };
+    axis_offsets result{offsets_of(0, axis), offsets_of(axis + 1, shape.size()), strides[axis], true};
+    for (std::size_t i = 0; i < result.inner.size(); ++i) {
+        result.contiguous_inner = result.contiguous_inner && result.inner[i] == i;
+    }
+    return result;
+}
+
+/**
+ * @brief Copies an index range into a vector, checking the indices against an extent.
+ * @throws std::out_of_range if an index is out of bounds (when error checking is enabled).
+ */
+template <error_checking ErrorChecking, typename Indices>
+auto index_list(const Indices &indices, std::size_t extent) -> std::vector<std::size_t> {
+    std::vector<std::size_t> list;
+    for (const auto &index : indices) {
+        if constexpr (ErrorChecking == error_checking::enabled) {
+            if (std::cmp_less(index, 0) || std::cmp_greater_equal(index, extent)) {
+                throw std::out_of_range("Index out of bounds");
+            }
+        }
+        list.push_back(static_cast<std::size_t>(index));
+    }
+    return list;
+}
+
+/**
+ * @brief Checks that a tensor has the shape of another with one axis replaced by an extent.
+ * @throws std::invalid_argument if the shapes do not match (when error checking is enabled).
+ */
+template <error_checking ErrorChecking, typename ShapeRange1, typename ShapeRange2>
+void check_indexed_shape(const ShapeRange1 &shape, const ShapeRange2 &indexed_shape, std::size_t axis,
+                         std::size_t extent) {
+    if constexpr (ErrorChecking == error_checking::enabled) {
+        bool match = shape.size() == indexed_shape.size() && axis < shape.size();
+        for (std::size_t k = 0; match && k < shape.size(); ++k) {
+            match = indexed_shape[k] == (k == axis ? extent : shape[k]);
+        }
+        if (!match) {
+            throw std::invalid_argument("Shape must match the indexed tensor except along the indexed axis");
+        }
+    }
+}
+
+/**
+ * @brief Checks that an axis is valid for a tensor of the given rank.
+ * @throws std::invalid_argument if the axis is out of range (when error checking is enabled).
+ */
+template <error_checking ErrorChecking> void check_axis(std::size_t axis, std::size_t rank) {
+    if constexpr (ErrorChecking == error_checking::enabled) {
+        if (axis >= rank) {
+            throw std::invalid_argument("Axis out of range");
+        }
+    }
+}
+
+/**
+ * @brief Applies a function to every line of a tensor along an axis.
+ *
+ * The function is called as f(buffer, line) with a buffer holding the elements of the line, and
+ * the buffer is written back to the line afterwards when WriteBack is set. Lines are processed in
+ * parallel; line is the column-major index of the line among all lines.
+ */
+template <bool WriteBack, typename Tensor, typename Function>
+void for_each_axis_line(Tensor &t, std::size_t axis, Function f) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    const auto shape = t.shape();
+    check_axis<Tensor::error_checking()>(axis, shape.size());
+    const auto offsets = make_axis_offsets(shape, t.strides(), axis);
+    const std::size_t inner = offsets.inner.size();
+    const std::size_t lines = inner * offsets.outer.size();
+    const std::size_t length = shape[axis];
+    auto *data = t.data();
+    const std::size_t grain = std::max<std::size_t>(1, (std::size_t{1} << 14) / std::max<std::size_t>(1, length));
+    parallel_for(0, lines, grain, [&](std::size_t first, std::size_t last) {
+        std::vector<value_type> buffer(length);
+        for (std::size_t line = first; line < last; ++line) {
+            auto *base = data + offsets.inner[line % inner] + offsets.outer[line / inner];
+            for (std::size_t j = 0; j < length; ++j) {
+                buffer[j] = base[j * offsets.stride];
+            }
+            f(buffer, line);
+            if constexpr (WriteBack) {
+                for (std::size_t j = 0; j < length; ++j) {
+                    base[j * offsets.stride] = buffer[j];
+                }
+            }
+        }
+    });
+}
+
+} // namespace detail
+
+/**
+ * @brief Gathers the slices of a tensor at a list of indices along an axis into an existing tensor.
+ *
+ * result(..., j, ...) = t(..., indices[j], ...), where j indexes the given axis.
+ *
+ * @param t The tensor to gather from.
+ * @param indices A range of integer indices along the axis; indices may repeat.
+ * @param axis The axis to index.
+ * @param result The tensor receiving the slices, with the shape of t except for indices.size() along axis.
+ * @throws std::out_of_range if an index is out of bounds (when error checking is enabled).
+ * @throws std::invalid_argument if the axis or the shape of result is invalid (when error checking is enabled).
+ */
+template <host_tensor Tensor, typename Indices, host_tensor Result>
+void index_select(const Tensor &t, const Indices &indices, std::size_t axis, Result &result) {
+    constexpr auto checking = Tensor::error_checking();
+    const auto shape = t.shape();
+    detail::check_axis<checking>(axis, shape.size());
+    const auto list = detail::index_list<checking>(indices, shape[axis]);
+    const std::size_t count = list.size();
+    detail::check_indexed_shape<checking>(shape, result.shape(), axis, count);
+    const auto source = detail::make_axis_offsets(shape, t.strides(), axis);
+    const auto target = detail::make_axis_offsets(result.shape(), result.strides(), axis);
+    const std::size_t inner = source.inner.size();
+    const auto *in = t.data();
+    auto *out = result.data();
+    const bool contiguous = source.contiguous_inner && target.contiguous_inner;
+    const std::size_t grain = std::max<std::size_t>(1, (std::size_t{1} << 14) / std::max<std::size_t>(1, inner));
+    // One task per (outer position, selected index) pair, each copying an inner run
+    parallel_for(0, source.outer.size() * count, grain, [&](std::size_t first, std::size_t last) {
+        for (std::size_t task = first; task < last; ++task) {
+            const std::size_t j = task % count;
+            const std::size_t o = task / count;
+            const auto *from = in + source.outer[o] + list[j] * source.stride;
+            auto *to = out + target.outer[o] + j * target.stride;
+            if (contiguous) {
+                std::copy_n(from, inner, to);
+            } else {
+                for (std::size_t i = 0; i < inner; ++i) {
+                    to[target.inner[i]] = from[source.inner[i]];
+                }
+            }
+        }
+    });
+}
+
+/**
+ * @brief Gathers the slices of a tensor at a list of indices along an axis.
+ *
+ * Selecting rows of an N×3 vertex tensor by the vertex indices of a face is take(vertices, face, 0).
+ *
+ * @param t The tensor to gather from.
+ * @param indices A range of integer indices along the axis; indices may repeat.
+ * @param axis The axis to index.
+ * @return A column-major tensor with the shape of t except for indices.size() along axis.
+ * @throws std::out_of_range if an index is out of bounds (when error checking is enabled).
+ * @throws std::invalid_argument if the axis is out of range (when error checking is enabled).
+ */
+template <host_tensor Tensor, typename Indices> auto take(const Tensor &t, const Indices &indices, std::size_t axis) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    const auto tensor_shape = t.shape();
+    detail::check_axis<Tensor::error_checking()>(axis, tensor_shape.size());
+    std::vector<std::size_t> shape(tensor_shape.begin(), tensor_shape.end());
+    shape[axis] = 0;
+    for ([[maybe_unused]] const auto &index : indices) {
+        ++shape[axis];
+    }
+    tensor<value_type, dynamic, dynamic, Tensor::error_checking()> result(shape);
+    index_select(t, indices, axis, result);
+    return result;
+}
+
+/**
+ * @brief Gathers elements of a tensor at a list of column-major flat indices.
+ * @param t The tensor to gather from.
+ * @param indices A range of integer flat indices, which address the elements in column-major order.
+ * @return A rank-1 tensor of the selected elements.
+ * @throws std::out_of_range if an index is out of bounds (when error checking is enabled).
+ */
+template <host_tensor Tensor, typename Indices> auto take(const Tensor &t, const Indices &indices) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    const auto list = detail::index_list<Tensor::error_checking()>(indices, t.size());
+    const auto shape = t.shape();
+    const auto strides = t.strides();
+    std::vector<value_type> values(list.size());
+    const auto *in = t.data();
+    parallel_for(0, list.size(), std::size_t{1} << 12, [&](std::size_t first, std::size_t last) {
+        for (std::size_t j = first; j < last; ++j) {
+            std::size_t flat = list[j];
+            std::size_t offset = 0;
+            for (std::size_t k = 0; k < shape.size(); ++k) {
+                offset += (flat % shape[k]) * strides[k];
+                flat /= shape[k];
+            }
+            values[j] = in[offset];
+        }
+    });
+    return tensor<value_type, dynamic, dynamic, Tensor::error_checking()>(std::vector<std::size_t>{list.size()},
+                                                                           values);
+}
+
+/**
+ * @brief Adds slices to a tensor at a list of indices along an axis.
+ *
+ * out(..., indices[j], ...) += values(..., j, ...) for every j, where repeated indices accumulate.
+ * The updates are partitioned between threads so that no element is written by two threads, and
+ * the updates of every element are applied in the order of the index list.
+ *
+ * @param out The tensor to accumulate into.
+ * @param indices A range of integer indices along the axis.
+ * @param values The slices to add, with the shape of out except for indices.size() along axis.
+ * @param axis The axis to index.
+ * @throws std::out_of_range if an index is out of bounds (when error checking is enabled).
+ * @throws std::invalid_argument if the axis or the shape of values is invalid (when error checking is enabled).
+ */
+template <host_tensor Tensor, typename Indices, host_tensor Values>
+void scatter_add(Tensor &out, const Indices &indices, const Values &values, std::size_t axis) {
+    constexpr auto checking = Tensor::error_checking();
+    const auto shape = out.shape();
+    detail::check_axis<checking>(axis, shape.size());
+    const auto list = detail::index_list<checking>(indices, shape[axis]);
+    const std::size_t count = list.size();
+    detail::check_indexed_shape<checking>(shape, values.shape(), axis, count);
+    const auto target = detail::make_axis_offsets(shape, out.strides(), axis);
+    const auto source = detail::make_axis_offsets(values.shape(), values.strides(), axis);
+    const std::size_t inner = target.inner.size();
+    const std::size_t lines = inner * target.outer.size();
+    auto *to = out.data();
+    const auto *from = values.data();
+    auto add_line = [&](std::size_t line, std::size_t j) {
+        const std::size_t i = line % inner;
+        const std::size_t o = line / inner;
+        to[target.inner[i] + list[j] * target.stride + target.outer[o]] +=
+            from[source.inner[i] + j * source.stride + source.outer[o]];
+    };
+
+    constexpr std::size_t min_lines = 64;
+    if (lines >= min_lines) {
+        // Privatize by line: a thread owns whole lines along the axis
+        const std::size_t grain = std::max<std::size_t>(1, (std::size_t{1} << 14) / std::max<std::size_t>(1, count));
+        parallel_for(0, lines, grain, [&](std::size_t first, std::size_t last) {
+            for (std::size_t j = 0; j < count; ++j) {
+                for (std::size_t line = first; line < last; ++line) {
+                    add_line(line, j);
+                }
+            }
+        });
+        return;
+    }
+    // Few lines: sort the updates by target index and give each thread whole groups of equal indices
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return list[a] < list[b]; });
+    std::vector<std::size_t> group_starts;
+    for (std::size_t k = 0; k < count; ++k) {
+        if (k == 0 || list[order[k]] != list[order[k - 1]]) {
+            group_starts.push_back(k);
+        }
+    }
+    group_starts.push_back(count);
+    const std::size_t grain = std::max<std::size_t>(1, (std::size_t{1} << 12) / std::max<std::size_t>(1, lines));
+    parallel_for(0, group_starts.size() - 1, grain, [&](std::size_t first, std::size_t last) {
+        for (std::size_t k = group_starts[first]; k < group_starts[last]; ++k) {
+            for (std::size_t line = 0; line < lines; ++line) {
+                add_line(line, order[k]);
+            }
+        }
+    });
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_INDEXING_HPP
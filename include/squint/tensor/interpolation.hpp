@@ -0,0 +1,316 @@
+/**
+ * @file interpolation.hpp
+ * @brief Batched linear, bilinear and cubic spline interpolation of tabulated data.
+ *
+ * This file provides interp1d and interp2d, which interpolate tables of samples at tensors of
+ * query points, and cubic_spline, which precomputes the coefficients of a natural cubic spline
+ * once so that it can be evaluated many times. Sample points and queries may be quantities: the
+ * queries must have the type of the sample points, and the results have the type of the sampled
+ * values, so a density tabulated against temperature is looked up with temperatures and yields
+ * densities.
+ *
+ * Queries are evaluated in parallel. Each thread remembers the interval of its previous query and
+ * checks it and the next interval before falling back to a binary search, so sorted or slowly
+ * varying queries are located in constant time.
+ */
+#ifndef SQUINT_TENSOR_INTERPOLATION_HPP
+#define SQUINT_TENSOR_INTERPOLATION_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/layout.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/tensor/comparison.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace squint {
+
+namespace detail {
+
+/// Underlying arithmetic type of a quantity or arithmetic type.
+template <typename T> using numeric_type_t = std::remove_cvref_t<decltype(numeric_value(std::declval<T>()))>;
+
+/**
+ * @brief Gathers the elements of a rank-1 tensor as numbers.
+ */
+template <typename S, typename Tensor> auto numeric_values(const Tensor &t) -> std::vector<S> {
+    std::vector<S> values;
+    values.reserve(t.size());
+    for (const auto &element : t) {
+        values.push_back(static_cast<S>(numeric_value(element)));
+    }
+    return values;
+}
+
+/**
+ * @brief Checks that sample points form a strictly ascending rank-1 table matching the sampled values.
+ */
+template <error_checking ErrorChecking, typename S>
+void check_knots(std::size_t rank, const std::vector<S> &knots, std::size_t values) {
+    if constexpr (ErrorChecking == error_checking::enabled) {
+        if (rank != 1 || knots.size() < 2) {
+            throw std::invalid_argument("Sample points must be a vector of at least two points");
+        }
+        if (values != knots.size()) {
+            throw std::invalid_argument("Sample points and values must have the same length");
+        }
+        if (std::adjacent_find(knots.begin(), knots.end(), std::greater_equal<>()) != knots.end()) {
+            throw std::invalid_argument("Sample points must be strictly ascending");
+        }
+    }
+}
+
+/**
+ * @brief Finds the interval [knots[k], knots[k + 1]) containing x, clamped to the first and last interval.
+ *
+ * The interval of the previous query and the one after it are checked before a binary search.
+ */
+template <typename S> auto locate(const std::vector<S> &knots, S x, std::size_t guess) -> std::size_t {
+    const std::size_t last = knots.size() - 2;
+    if (guess <= last && knots[guess] <= x) {
+        if (guess == last || x < knots[guess + 1]) {
+            return guess;
+        }
+        if (guess + 1 == last || x < knots[guess + 2]) {
+            return guess + 1;
+        }
+    }
+    const auto upper = std::upper_bound(knots.begin(), knots.end(), x) - knots.begin();
+    return std::min<std::size_t>(static_cast<std::size_t>(std::max<std::ptrdiff_t>(upper, 1)) - 1, last);
+}
+
+/**
+ * @brief Evaluates f at every query point in parallel into a column-major tensor of the given shape.
+ *
+ * f is called as f(i, state) for the column-major index i of the query, where state is a
+ * default-constructed State shared by consecutive queries on the same thread, used to remember
+ * the intervals of the previous query.
+ */
+template <typename R, error_checking ErrorChecking, typename State, typename Function>
+auto evaluate_queries(const std::vector<std::size_t> &shape, Function f) {
+    tensor<R, dynamic, dynamic, ErrorChecking> result(shape);
+    auto *out = result.data();
+    parallel_for(0, result.size(), std::size_t{1} << 12, [&](std::size_t first, std::size_t last) {
+        State state{};
+        for (std::size_t i = first; i < last; ++i) {
+            out[i] = f(i, state);
+        }
+    });
+    return result;
+}
+
+/// Shape of a tensor as a vector.
+template <typename Tensor> auto shape_vector(const Tensor &t) -> std::vector<std::size_t> {
+    return {t.shape().begin(), t.shape().end()};
+}
+
+} // namespace detail
+
+/**
+ * @brief Linearly interpolates a table of samples at a tensor of query points.
+ *
+ * Queries outside the sample points take the first or last value.
+ *
+ * @param xp The strictly ascending sample points, a rank-1 tensor.
+ * @param fp The sampled values, a rank-1 tensor of the length of xp.
+ * @param x The query points, a tensor of any shape with elements of the type of xp.
+ * @return A column-major tensor of the shape of x holding the interpolated values.
+ * @throws std::invalid_argument if the table is malformed (when error checking is enabled for xp).
+ */
+template <host_tensor XP, host_tensor FP, host_tensor Query>
+auto interp1d(const XP &xp, const FP &fp, const Query &x) {
+    using x_type = std::remove_const_t<typename XP::value_type>;
+    using y_type = std::remove_const_t<typename FP::value_type>;
+    static_assert(std::is_convertible_v<std::remove_const_t<typename Query::value_type>, x_type>,
+                  "Query points must have the type of the sample points");
+    using scalar_type = std::common_type_t<detail::numeric_type_t<x_type>, detail::numeric_type_t<y_type>>;
+    const auto knots = detail::numeric_values<scalar_type>(xp);
+    const auto values = detail::numeric_values<scalar_type>(fp);
+    detail::check_knots<XP::error_checking()>(xp.rank(), knots, values.size());
+    std::vector<scalar_type> slopes(knots.size() - 1);
+    for (std::size_t k = 0; k + 1 < knots.size(); ++k) {
+        slopes[k] = (values[k + 1] - values[k]) / (knots[k + 1] - knots[k]);
+    }
+    const auto queries = detail::numeric_values<scalar_type>(x);
+    return detail::evaluate_queries<y_type, Query::error_checking(), std::size_t>(
+        detail::shape_vector(x), [&](std::size_t i, std::size_t &guess) {
+            guess = detail::locate(knots, queries[i], guess);
+            const scalar_type t = std::clamp(queries[i], knots.front(), knots.back()) - knots[guess];
+            return y_type(static_cast<detail::numeric_type_t<y_type>>(values[guess] + slopes[guess] * t));
+        });
+}
+
+/**
+ * @brief Bilinearly interpolates a grid of samples at tensors of query points.
+ *
+ * Queries outside the grid are clamped to its edges.
+ *
+ * @param xp The strictly ascending sample points along the first axis, a rank-1 tensor.
+ * @param yp The strictly ascending sample points along the second axis, a rank-1 tensor.
+ * @param fp The sampled values, of shape {xp.size(), yp.size()}.
+ * @param x The first coordinates of the query points, with elements of the type of xp.
+ * @param y The second coordinates of the query points, of the shape of x with elements of the type of yp.
+ * @return A column-major tensor of the shape of x holding the interpolated values.
+ * @throws std::invalid_argument if the grid is malformed or the query shapes differ (when error checking is
+ * enabled for xp).
+ */
+template <host_tensor XP, host_tensor YP, host_tensor FP, host_tensor QueryX, host_tensor QueryY>
+auto interp2d(const XP &xp, const YP &yp, const FP &fp, const QueryX &x, const QueryY &y) {
+    using x_type = std::remove_const_t<typename XP::value_type>;
+    using y_type = std::remove_const_t<typename YP::value_type>;
+    using z_type = std::remove_const_t<typename FP::value_type>;
+    static_assert(std::is_convertible_v<std::remove_const_t<typename QueryX::value_type>, x_type> &&
+                      std::is_convertible_v<std::remove_const_t<typename QueryY::value_type>, y_type>,
+                  "Query points must have the types of the sample points");
+    using scalar_type = std::common_type_t<detail::numeric_type_t<x_type>, detail::numeric_type_t<y_type>,
+                                           detail::numeric_type_t<z_type>>;
+    constexpr auto checking = XP::error_checking();
+    const auto x_knots = detail::numeric_values<scalar_type>(xp);
+    const auto y_knots = detail::numeric_values<scalar_type>(yp);
+    if constexpr (checking == error_checking::enabled) {
+        if (fp.rank() != 2) {
+            throw std::invalid_argument("Sampled values must be a matrix");
+        }
+        if (detail::shape_vector(x) != detail::shape_vector(y)) {
+            throw std::invalid_argument("Query coordinates must have the same shape");
+        }
+    }
+    detail::check_knots<checking>(xp.rank(), x_knots, fp.shape()[0]);
+    detail::check_knots<checking>(yp.rank(), y_knots, fp.shape()[1]);
+    const std::size_t rows = x_knots.size();
+    std::vector<scalar_type> values(fp.size());
+    for (std::size_t j = 0; j < y_knots.size(); ++j) {
+        for (std::size_t i = 0; i < rows; ++i) {
+            values[i + j * rows] = static_cast<scalar_type>(detail::numeric_value(fp(i, j)));
+        }
+    }
+    const auto x_queries = detail::numeric_values<scalar_type>(x);
+    const auto y_queries = detail::numeric_values<scalar_type>(y);
+    return detail::evaluate_queries<z_type, QueryX::error_checking(), std::array<std::size_t, 2>>(
+        detail::shape_vector(x), [&](std::size_t q, std::array<std::size_t, 2> &guess) {
+            const std::size_t i = guess[0] = detail::locate(x_knots, x_queries[q], guess[0]);
+            const std::size_t j = guess[1] = detail::locate(y_knots, y_queries[q], guess[1]);
+            const scalar_type s = (std::clamp(x_queries[q], x_knots.front(), x_knots.back()) - x_knots[i]) /
+                                  (x_knots[i + 1] - x_knots[i]);
+            const scalar_type t = (std::clamp(y_queries[q], y_knots.front(), y_knots.back()) - y_knots[j]) /
+                                  (y_knots[j + 1] - y_knots[j]);
+            const scalar_type *corner = values.data() + i + j * rows;
+            const scalar_type low = corner[0] + s * (corner[1] - corner[0]);
+            const scalar_type high = corner[rows] + s * (corner[rows + 1] - corner[rows]);
+            return z_type(static_cast<detail::numeric_type_t<z_type>>(low + t * (high - low)));
+        });
+}
+
+/**
+ * @brief Natural cubic spline through a table of samples.
+ *
+ * The spline is twice continuously differentiable and has zero second derivative at the end points.
+ * Its polynomial coefficients are computed once on construction, so evaluating it costs one
+ * interval lookup and a cubic polynomial per query. Queries outside the sample points are
+ * extrapolated with the polynomial of the nearest interval.
+ *
+ * @tparam X The type of the sample points, an arithmetic type or a quantity.
+ * @tparam Y The type of the sampled values, an arithmetic type or a quantity.
+ */
+template <typename X, typename Y> class cubic_spline {
+  public:
+    /// @brief Arithmetic type in which the coefficients are stored.
+    using scalar_type = std::common_type_t<detail::numeric_type_t<X>, detail::numeric_type_t<Y>>;
+
+    /**
+     * @brief Computes the spline through the given samples.
+     * @param xp The strictly ascending sample points, a rank-1 tensor.
+     * @param fp The sampled values, a rank-1 tensor of the length of xp.
+     * @throws std::invalid_argument if the table is malformed.
+     */
+    template <host_tensor XP, host_tensor FP>
+    cubic_spline(const XP &xp, const FP &fp)
+        : knots_(detail::numeric_values<scalar_type>(xp)), coefficients_(4 * std::max<std::size_t>(knots_.size(), 1)) {
+        const auto values = detail::numeric_values<scalar_type>(fp);
+        detail::check_knots<error_checking::enabled>(xp.rank(), knots_, values.size());
+        const std::size_t n = knots_.size();
+        // Solve the tridiagonal system for the second derivatives with the Thomas algorithm
+        std::vector<scalar_type> second(n);
+        std::vector<scalar_type> diagonal(n);
+        std::vector<scalar_type> rhs(n);
+        for (std::size_t i = 1; i + 1 < n; ++i) {
+            const scalar_type h_prev = knots_[i] - knots_[i - 1];
+            const scalar_type h = knots_[i + 1] - knots_[i];
+            diagonal[i] = 2 * (h_prev + h);
+            rhs[i] = 6 * ((values[i + 1] - values[i]) / h - (values[i] - values[i - 1]) / h_prev);
+            if (i > 1) {
+                const scalar_type factor = h_prev / diagonal[i - 1];
+                diagonal[i] -= factor * h_prev;
+                rhs[i] -= factor * rhs[i - 1];
+            }
+        }
+        for (std::size_t i = n - 2; i >= 1; --i) {
+            second[i] = (rhs[i] - (knots_[i + 1] - knots_[i]) * second[i + 1]) / diagonal[i];
+        }
+        for (std::size_t k = 0; k + 1 < n; ++k) {
+            const scalar_type h = knots_[k + 1] - knots_[k];
+            scalar_type *c = coefficients_.data() + 4 * k;
+            c[0] = values[k];
+            c[1] = (values[k + 1] - values[k]) / h - h * (2 * second[k] + second[k + 1]) / 6;
+            c[2] = second[k] / 2;
+            c[3] = (second[k + 1] - second[k]) / (6 * h);
+        }
+    }
+
+    /**
+     * @brief Evaluates the spline at a point.
+     * @param x The point.
+     * @return The value of the spline.
+     */
+    auto operator()(const X &x) const -> Y {
+        std::size_t guess = 0;
+        const scalar_type value = evaluate(static_cast<scalar_type>(detail::numeric_value(x)), guess);
+        return Y(static_cast<detail::numeric_type_t<Y>>(value));
+    }
+
+    /**
+     * @brief Evaluates the spline at a tensor of points.
+     * @param x The points, a tensor of any shape with elements of type X.
+     * @return A column-major tensor of the shape of x holding the values of the spline.
+     */
+    template <host_tensor Query> auto operator()(const Query &x) const {
+        static_assert(std::is_convertible_v<std::remove_const_t<typename Query::value_type>, X>,
+                      "Query points must have the type of the sample points");
+        const auto queries = detail::numeric_values<scalar_type>(x);
+        return detail::evaluate_queries<Y, Query::error_checking(), std::size_t>(
+            detail::shape_vector(x), [&](std::size_t i, std::size_t &guess) {
+                return Y(static_cast<detail::numeric_type_t<Y>>(evaluate(queries[i], guess)));
+            });
+    }
+
+  private:
+    /// Evaluates the polynomial of the interval containing x, updating the interval guess.
+    auto evaluate(scalar_type x, std::size_t &guess) const -> scalar_type {
+        guess = detail::locate(knots_, x, guess);
+        const scalar_type t = x - knots_[guess];
+        const scalar_type *c = coefficients_.data() + 4 * guess;
+        return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+    }
+
+    std::vector<scalar_type> knots_;
+    std::vector<scalar_type> coefficients_; ///< Four polynomial coefficients per interval, constant term first.
+};
+
+/// @brief Deduces the spline types from the sample tensors.
+template <host_tensor XP, host_tensor FP>
+cubic_spline(const XP &, const FP &)
+    -> cubic_spline<std::remove_const_t<typename XP::value_type>, std::remove_const_t<typename FP::value_type>>;
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_INTERPOLATION_HPP
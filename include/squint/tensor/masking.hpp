@@ -0,0 +1,346 @@
+/**
+ * @file masking.hpp
+ * @brief Boolean masks, conditional selection and masked assignment.
+ *
+ * This file provides bit_mask, a bit-packed boolean tensor using one bit per element, and the
+ * kernels where, masked_assign and compress. Masks may be bit_mask objects or tensors whose
+ * non-zero elements select, such as the std::uint8_t tensors returned by the comparison operators.
+ * Mask elements are matched to tensor elements in column-major order, so a mask built from one
+ * tensor applies to any other tensor of the same shape regardless of its memory layout.
+ *
+ * When the operands are stored contiguously in column-major order the kernels run over raw
+ * pointers and select with a conditional expression on every element instead of branching, which
+ * compilers turn into vector blends. Other operands are traversed with their iterators.
+ */
+#ifndef SQUINT_TENSOR_MASKING_HPP
+#define SQUINT_TENSOR_MASKING_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/tensor/tensor_op_compatibility.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace squint {
+
+/**
+ * @brief A bit-packed boolean mask.
+ *
+ * Stores one bit per element in 64-bit words, an eighth of the memory of a std::uint8_t mask.
+ * Elements are addressed by their column-major flat index.
+ */
+class bit_mask {
+  public:
+    using word_type = std::uint64_t;
+    static constexpr std::size_t word_bits = 64;
+
+    bit_mask() = default;
+
+    /**
+     * @brief Constructs a mask of the given shape with every element set to value.
+     * @param shape The shape of the mask.
+     * @param value The initial value of every element.
+     */
+    explicit bit_mask(std::vector<std::size_t> shape, bool value = false)
+        : shape_(std::move(shape)),
+          size_(std::accumulate(shape_.begin(), shape_.end(), std::size_t{1}, std::multiplies<>())),
+          words_((size_ + word_bits - 1) / word_bits, value ? ~word_type{0} : word_type{0}) {
+        clear_padding();
+    }
+
+    /**
+     * @brief Constructs a mask from a tensor, setting the elements that are non-zero.
+     * @param mask The tensor to pack, typically the result of a comparison operator.
+     */
+    template <host_tensor Tensor>
+    explicit bit_mask(const Tensor &mask)
+        : bit_mask(std::vector<std::size_t>(mask.shape().begin(), mask.shape().end())) {
+        std::size_t i = 0;
+        for (const auto &element : mask) {
+            words_[i / word_bits] |= static_cast<word_type>(element != 0) << (i % word_bits);
+            ++i;
+        }
+    }
+
+    /// @brief Returns the shape of the mask.
+    [[nodiscard]] auto shape() const -> const std::vector<std::size_t> & { return shape_; }
+    /// @brief Returns the number of elements of the mask.
+    [[nodiscard]] auto size() const -> std::size_t { return size_; }
+    /// @brief Returns the packed words, with the element of flat index i in bit i % 64 of word i / 64.
+    [[nodiscard]] auto words() const -> const std::vector<word_type> & { return words_; }
+
+    /// @brief Returns the element with the given column-major flat index.
+    [[nodiscard]] auto test(std::size_t i) const -> bool {
+        return ((words_[i / word_bits] >> (i % word_bits)) & 1U) != 0;
+    }
+
+    /// @brief Sets the element with the given column-major flat index.
+    void set(std::size_t i, bool value = true) {
+        const word_type bit = word_type{1} << (i % word_bits);
+        words_[i / word_bits] = value ? (words_[i / word_bits] | bit) : (words_[i / word_bits] & ~bit);
+    }
+
+    /// @brief Returns the number of set elements.
+    [[nodiscard]] auto count() const -> std::size_t {
+        std::size_t total = 0;
+        for (const auto word : words_) {
+            total += static_cast<std::size_t>(std::popcount(word));
+        }
+        return total;
+    }
+
+    /// @brief Returns the complement of the mask.
+    auto operator~() const -> bit_mask {
+        bit_mask result = *this;
+        for (auto &word : result.words_) {
+            word = ~word;
+        }
+        result.clear_padding();
+        return result;
+    }
+
+    /// @brief Returns the element-wise conjunction of two masks of the same shape.
+    auto operator&(const bit_mask &other) const -> bit_mask { return combine(other, std::bit_and<>()); }
+    /// @brief Returns the element-wise disjunction of two masks of the same shape.
+    auto operator|(const bit_mask &other) const -> bit_mask { return combine(other, std::bit_or<>()); }
+
+  private:
+    /// Clears the unused bits of the last word so that count() only sees elements.
+    void clear_padding() {
+        if (size_ % word_bits != 0) {
+            words_.back() &= (word_type{1} << (size_ % word_bits)) - 1;
+        }
+    }
+
+    template <typename Op> auto combine(const bit_mask &other, Op op) const -> bit_mask {
+        if (other.shape_ != shape_) {
+            throw std::invalid_argument("Masks must have the same shape");
+        }
+        bit_mask result = *this;
+        for (std::size_t k = 0; k < words_.size(); ++k) {
+            result.words_[k] = op(words_[k], other.words_[k]);
+        }
+        return result;
+    }
+
+    std::vector<std::size_t> shape_;
+    std::size_t size_ = 0;
+    std::vector<word_type> words_;
+};
+
+/**
+ * @brief Builds a bit mask by applying a predicate to every element of a tensor.
+ *
+ * Avoids the intermediate std::uint8_t tensor of the comparison operators.
+ *
+ * @param t The tensor.
+ * @param pred The unary predicate.
+ * @return A mask with the shape of t, set where pred returns true.
+ */
+template <host_tensor Tensor, typename Predicate> auto make_mask(const Tensor &t, Predicate pred) -> bit_mask {
+    bit_mask mask(std::vector<std::size_t>(t.shape().begin(), t.shape().end()));
+    std::size_t i = 0;
+    for (const auto &element : t) {
+        mask.set(i++, static_cast<bool>(pred(element)));
+    }
+    return mask;
+}
+
+namespace detail {
+
+/**
+ * @brief Returns the data pointer of a tensor stored contiguously in column-major order, or nullptr.
+ */
+template <typename Tensor> auto column_major_data(Tensor &t) -> decltype(t.data()) {
+    std::size_t expected = 1;
+    const auto shape = t.shape();
+    const auto strides = t.strides();
+    for (std::size_t k = 0; k < shape.size(); ++k) {
+        if (shape[k] != 1 && strides[k] != expected) {
+            return nullptr;
+        }
+        expected *= shape[k];
+    }
+    return t.data();
+}
+
+/**
+ * @brief Checks that a mask has the shape of the tensor it is applied to.
+ * @throws std::runtime_error if the shapes differ (when error checking is enabled).
+ */
+template <typename Mask, host_tensor Tensor> void mask_compatible(const Mask &mask, const Tensor &t) {
+    if constexpr (std::is_same_v<Mask, bit_mask>) {
+        if constexpr (Tensor::error_checking() == error_checking::enabled) {
+            if (!implicit_convertible_shapes_vector(mask.shape(),
+                                                    std::vector<std::size_t>(t.shape().begin(), t.shape().end()))) {
+                throw std::runtime_error("Shapes must be compatible for element-wise operations");
+            }
+        }
+    } else {
+        element_wise_compatible(mask, t);
+    }
+}
+
+/**
+ * @brief Calls f with an accessor returning the mask element of a column-major flat index.
+ *
+ * Bit masks and contiguous column-major tensor masks are read in place; other tensor masks are
+ * packed into a bit mask first.
+ */
+template <typename Mask, typename Function> void visit_mask(const Mask &mask, Function f) {
+    if constexpr (std::is_same_v<Mask, bit_mask>) {
+        const auto *words = mask.words().data();
+        f([words](std::size_t i) { return ((words[i / bit_mask::word_bits] >> (i % bit_mask::word_bits)) & 1U) != 0; });
+    } else {
+        if (const auto *data = column_major_data(mask)) {
+            f([data](std::size_t i) { return data[i] != 0; });
+        } else {
+            visit_mask(bit_mask(mask), f);
+        }
+    }
+}
+
+/**
+ * @brief Replaces the elements of target where the mask is false (Keep) or true (!Keep) with source(i).
+ *
+ * @param target The tensor to modify.
+ * @param bit The mask accessor.
+ * @param source Returns the replacement for a flat index, given a contiguous pointer or iterator position.
+ */
+template <bool Keep, typename Tensor, typename Bit, typename Source>
+void blend(Tensor &target, Bit bit, Source source) {
+    const std::size_t size = target.size();
+    if (auto *data = column_major_data(target)) {
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = (bit(i) == Keep) ? data[i] : source(i);
+        }
+    } else {
+        std::size_t i = 0;
+        for (auto &element : target) {
+            if (bit(i) != Keep) {
+                element = source(i);
+            }
+            ++i;
+        }
+    }
+}
+
+/**
+ * @brief Returns a function giving the element of a tensor at a column-major flat index.
+ *
+ * Contiguous column-major tensors are indexed directly; other tensors are gathered first.
+ */
+template <host_tensor Tensor> auto flat_reader(const Tensor &t) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    std::vector<value_type> gathered;
+    const auto *data = column_major_data(t);
+    if (data == nullptr) {
+        gathered.reserve(t.size());
+        for (const auto &element : t) {
+            gathered.push_back(element);
+        }
+    }
+    return [data, gathered = std::move(gathered)](std::size_t i) { return data != nullptr ? data[i] : gathered[i]; };
+}
+
+} // namespace detail
+
+/**
+ * @brief Selects elements from two tensors according to a mask.
+ * @param mask A bit_mask or a tensor whose non-zero elements select a.
+ * @param a The tensor selected where the mask is set.
+ * @param b The tensor selected where the mask is not set.
+ * @return An owning tensor with the shape of a, equal to a where the mask is set and to b elsewhere.
+ * @throws std::runtime_error if the shapes differ (when error checking is enabled).
+ */
+template <typename Mask, host_tensor Tensor1, host_tensor Tensor2>
+    requires(std::is_same_v<Mask, bit_mask> || host_tensor<Mask>)
+auto where(const Mask &mask, const Tensor1 &a, const Tensor2 &b) {
+    element_wise_compatible(a, b);
+    detail::mask_compatible(mask, a);
+    auto result = a.copy();
+    const auto read_b = detail::flat_reader(b);
+    detail::visit_mask(mask, [&](auto bit) { detail::blend<true>(result, bit, read_b); });
+    return result;
+}
+
+/**
+ * @brief Assigns a value to the elements of a tensor where a mask is set.
+ * @param t The tensor to modify.
+ * @param mask A bit_mask or a tensor whose non-zero elements select.
+ * @param value The value to assign.
+ * @throws std::runtime_error if the shapes differ (when error checking is enabled).
+ */
+template <host_tensor Tensor, typename Mask>
+    requires(std::is_same_v<Mask, bit_mask> || host_tensor<Mask>)
+void masked_assign(Tensor &t, const Mask &mask, const typename Tensor::value_type &value) {
+    detail::mask_compatible(mask, t);
+    detail::visit_mask(mask, [&](auto bit) { detail::blend<false>(t, bit, [&value](std::size_t) { return value; }); });
+}
+
+/**
+ * @brief Copies the elements of a source tensor into a tensor where a mask is set.
+ * @param t The tensor to modify.
+ * @param mask A bit_mask or a tensor whose non-zero elements select.
+ * @param source A tensor with the shape of t whose selected elements are copied.
+ * @throws std::runtime_error if the shapes differ (when error checking is enabled).
+ */
+template <host_tensor Tensor, typename Mask, host_tensor Source>
+    requires(std::is_same_v<Mask, bit_mask> || host_tensor<Mask>)
+void masked_assign(Tensor &t, const Mask &mask, const Source &source) {
+    element_wise_compatible(t, source);
+    detail::mask_compatible(mask, t);
+    const auto read_source = detail::flat_reader(source);
+    detail::visit_mask(mask, [&](auto bit) { detail::blend<false>(t, bit, read_source); });
+}
+
+/**
+ * @brief Gathers the elements of a tensor where a mask is set.
+ * @param mask A bit_mask or a tensor whose non-zero elements select.
+ * @param t The tensor to select from.
+ * @return A rank-1 tensor of the selected elements in column-major order.
+ * @throws std::runtime_error if the shapes differ (when error checking is enabled).
+ */
+template <typename Mask, host_tensor Tensor>
+    requires(std::is_same_v<Mask, bit_mask> || host_tensor<Mask>)
+auto compress(const Mask &mask, const Tensor &t) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    detail::mask_compatible(mask, t);
+    std::vector<value_type> selected;
+    if constexpr (std::is_same_v<Mask, bit_mask>) {
+        selected.reserve(mask.count());
+    }
+    detail::visit_mask(mask, [&](auto bit) {
+        if (const auto *data = detail::column_major_data(t)) {
+            const std::size_t size = t.size();
+            for (std::size_t i = 0; i < size; ++i) {
+                if (bit(i)) {
+                    selected.push_back(data[i]);
+                }
+            }
+        } else {
+            std::size_t i = 0;
+            for (const auto &element : t) {
+                if (bit(i++)) {
+                    selected.push_back(element);
+                }
+            }
+        }
+    });
+    const std::size_t count = selected.size();
+    return tensor<value_type, dynamic, dynamic, Tensor::error_checking()>(std::vector<std::size_t>{count},
+                                                                           std::move(selected));
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_MASKING_HPP
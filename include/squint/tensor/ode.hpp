@@ -0,0 +1,394 @@
+/**
+ * @file ode.hpp
+ * @brief Fixed-step and adaptive integrators for ordinary differential equations over tensors.
+ *
+ * This file provides rk4_stepper, the classical fourth-order Runge-Kutta method with a fixed step,
+ * and dormand_prince_stepper, the adaptive fifth-order method of Dormand and Prince with an
+ * embedded fourth-order error estimate, together with the convenience functions integrate_rk4 and
+ * integrate_adaptive.
+ *
+ * The state is a tensor whose elements may be quantities, and the time may be a quantity. The
+ * right-hand side is evaluated into tensors of the derivative type, decltype(state / time), so a
+ * right-hand side producing the wrong dimension fails to compile. Steppers allocate their stage
+ * buffers once on construction, and every stage is formed by a single fused pass that combines
+ * all previous stage derivatives, so no temporaries are created while stepping. Independent
+ * systems can be integrated together by stacking their states along any axis; adaptive steps are
+ * then chosen for the least accurate system.
+ */
+#ifndef SQUINT_TENSOR_ODE_HPP
+#define SQUINT_TENSOR_ODE_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/layout.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/tensor/comparison.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace squint {
+
+/**
+ * @brief Statistics of an integration.
+ */
+struct integration_stats {
+    std::size_t accepted = 0;    ///< Number of accepted steps.
+    std::size_t rejected = 0;    ///< Number of steps rejected by the error control.
+    std::size_t evaluations = 0; ///< Number of evaluations of the right-hand side.
+};
+
+namespace detail {
+
+/// Element type of the time derivative of a state with elements of type T.
+template <typename T, typename Time>
+using derivative_value_t = std::remove_cvref_t<decltype(std::declval<T>() / std::declval<Time>())>;
+
+/**
+ * @brief Tensor type holding the time derivative of a state tensor, with the state's shape and layout.
+ */
+template <typename State, typename Time>
+using derivative_tensor_t =
+    tensor<derivative_value_t<std::remove_const_t<typename State::value_type>, Time>, typename State::shape_type,
+           typename State::strides_type, State::error_checking()>;
+
+/**
+ * @brief Creates a buffer for the time derivative of a state.
+ */
+template <typename Time, typename State> auto make_derivative_buffer(const State &state) {
+    using buffer_type = derivative_tensor_t<State, Time>;
+    if constexpr (fixed_tensor<State>) {
+        return buffer_type{};
+    } else {
+        const std::vector<std::size_t> shape(state.shape().begin(), state.shape().end());
+        const bool row_major = shape.size() > 1 && state.strides()[0] != 1;
+        return buffer_type(shape, row_major ? layout::row_major : layout::column_major);
+    }
+}
+
+/**
+ * @brief Evaluates the right-hand side of an ODE into a derivative buffer.
+ *
+ * The right-hand side is either called as f(t, y, dydt), writing the derivative into dydt, or as
+ * f(t, y), returning a tensor of the derivative type.
+ */
+template <typename Function, typename Time, typename State, typename Derivative>
+void evaluate_rhs(Function &f, Time t, const State &y, Derivative &dydt) {
+    if constexpr (std::invocable<Function &, Time, const State &, Derivative &>) {
+        f(t, y, dydt);
+    } else if constexpr (std::invocable<Function &, Time, const State &>) {
+        auto result = f(t, y);
+        static_assert(std::is_same_v<std::remove_const_t<typename decltype(result)::value_type>,
+                                     typename Derivative::value_type>,
+                      "The right-hand side must return the derivative of the state with respect to time");
+        auto it = dydt.begin();
+        for (const auto &element : result) {
+            *it = element;
+            ++it;
+        }
+    } else {
+        static_assert(std::invocable<Function &, Time, const State &, Derivative &>,
+                      "The right-hand side must be callable as f(t, y, dydt) or f(t, y) with dydt of the derivative "
+                      "type of the state");
+    }
+}
+
+/**
+ * @brief Forms out = y + h * sum_j coefficients[j] * stages[j] in one pass over the elements.
+ */
+template <std::size_t N, typename T, typename D, typename Time>
+void combine_stages(T *out, const T *y, Time h, const std::array<double, N> &coefficients,
+                    const D *const (&stages)[N], std::size_t size) { // NOLINT(*-avoid-c-arrays)
+    using scalar_type = std::remove_cvref_t<decltype(numeric_value(std::declval<D>()))>;
+    std::array<scalar_type, N> a{};
+    for (std::size_t j = 0; j < N; ++j) {
+        a[j] = static_cast<scalar_type>(coefficients[j]);
+    }
+    parallel_for(0, size, std::size_t{1} << 14, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            D sum = stages[0][i] * a[0];
+            for (std::size_t j = 1; j < N; ++j) {
+                sum += stages[j][i] * a[j];
+            }
+            out[i] = y[i] + sum * h;
+        }
+    });
+}
+
+/**
+ * @brief Checks that a state has the shape the stepper was constructed for.
+ */
+template <typename State> void check_state(const State &y, const std::vector<std::size_t> &shape) {
+    if constexpr (State::error_checking() == error_checking::enabled) {
+        if (!std::equal(shape.begin(), shape.end(), y.shape().begin(), y.shape().end())) {
+            throw std::invalid_argument("State shape does not match the stepper");
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Classical fourth-order Runge-Kutta stepper with preallocated stage buffers.
+ *
+ * @tparam State The owning state tensor type.
+ * @tparam Time The type of the time, an arithmetic type or a quantity.
+ */
+template <host_tensor State, typename Time> class rk4_stepper {
+    static_assert(owning_tensor<State>, "The state must be an owning tensor");
+
+  public:
+    /// @brief Tensor type of the time derivative of the state.
+    using derivative_type = detail::derivative_tensor_t<State, Time>;
+    /// @brief Element type of the time derivative of the state.
+    using derivative_value_type = typename derivative_type::value_type;
+
+    /**
+     * @brief Allocates the stage buffers for states shaped like a prototype.
+     * @param prototype A state with the shape and layout of the states to integrate.
+     */
+    explicit rk4_stepper(const State &prototype)
+        : shape_(prototype.shape().begin(), prototype.shape().end()), stage_(prototype),
+          k_{detail::make_derivative_buffer<Time>(prototype), detail::make_derivative_buffer<Time>(prototype),
+             detail::make_derivative_buffer<Time>(prototype), detail::make_derivative_buffer<Time>(prototype)} {}
+
+    /**
+     * @brief Advances a state by one step in place.
+     * @param f The right-hand side, callable as f(t, y, dydt) or f(t, y).
+     * @param t The time of the state.
+     * @param y The state, replaced by the state at t + dt.
+     * @param dt The step.
+     * @throws std::invalid_argument if the state has a different shape (when error checking is enabled).
+     */
+    template <typename Function> void step(Function &&f, Time t, State &y, Time dt) {
+        detail::check_state(y, shape_);
+        const std::size_t n = y.size();
+        const auto half = static_cast<Time>(dt / 2);
+        const derivative_value_type *k1 = k_[0].data();
+        const derivative_value_type *k2 = k_[1].data();
+        const derivative_value_type *k3 = k_[2].data();
+        const derivative_value_type *k4 = k_[3].data();
+        detail::evaluate_rhs(f, t, y, k_[0]);
+        detail::combine_stages<1>(stage_.data(), y.data(), half, {1.0}, {k1}, n);
+        detail::evaluate_rhs(f, t + half, stage_, k_[1]);
+        detail::combine_stages<1>(stage_.data(), y.data(), half, {1.0}, {k2}, n);
+        detail::evaluate_rhs(f, t + half, stage_, k_[2]);
+        detail::combine_stages<1>(stage_.data(), y.data(), dt, {1.0}, {k3}, n);
+        detail::evaluate_rhs(f, t + dt, stage_, k_[3]);
+        detail::combine_stages<4>(y.data(), y.data(), dt, {1.0 / 6, 1.0 / 3, 1.0 / 3, 1.0 / 6}, {k1, k2, k3, k4}, n);
+    }
+
+  private:
+    std::vector<std::size_t> shape_;
+    State stage_;
+    std::array<derivative_type, 4> k_;
+};
+
+/**
+ * @brief Adaptive Dormand-Prince 5(4) stepper with preallocated stage buffers.
+ *
+ * Each step uses seven stages, the last of which is reused as the first stage of the next step.
+ * The local error is estimated with the embedded fourth-order solution and measured as the maximum
+ * over all elements of |error| / (atol + rtol * |y|), using the numeric values of the elements in
+ * their base units. Systems stacked in one state therefore take the steps their least accurate
+ * system would take alone, however many idle systems share the state.
+ *
+ * @tparam State The owning state tensor type.
+ * @tparam Time The type of the time, an arithmetic type or a quantity.
+ */
+template <host_tensor State, typename Time> class dormand_prince_stepper {
+    static_assert(owning_tensor<State>, "The state must be an owning tensor");
+
+  public:
+    /// @brief Tensor type of the time derivative of the state.
+    using derivative_type = detail::derivative_tensor_t<State, Time>;
+    /// @brief Element type of the time derivative of the state.
+    using derivative_value_type = typename derivative_type::value_type;
+
+    /**
+     * @brief Allocates the stage buffers for states shaped like a prototype.
+     * @param prototype A state with the shape and layout of the states to integrate.
+     * @param rtol The relative tolerance.
+     * @param atol The absolute tolerance, in the base units of the state.
+     * @throws std::invalid_argument if a tolerance is negative or both are zero.
+     */
+    explicit dormand_prince_stepper(const State &prototype, double rtol = 1e-6, double atol = 1e-9)
+        : shape_(prototype.shape().begin(), prototype.shape().end()), rtol_(rtol), atol_(atol), stage_(prototype),
+          next_(prototype) {
+        if (!(rtol >= 0 && atol >= 0 && rtol + atol > 0)) {
+            throw std::invalid_argument("Tolerances must be non-negative and not both zero");
+        }
+        for (auto &k : k_) {
+            k = detail::make_derivative_buffer<Time>(prototype);
+        }
+    }
+
+    /**
+     * @brief Integrates a state in place from t0 to t1.
+     * @param f The right-hand side, callable as f(t, y, dydt) or f(t, y).
+     * @param y The state at t0, replaced by the state at t1.
+     * @param t0 The initial time.
+     * @param t1 The final time, which may be before t0.
+     * @param dt The initial step; its sign is ignored.
+     * @param max_steps The maximum number of attempted steps.
+     * @return The number of accepted and rejected steps and of right-hand side evaluations.
+     * @throws std::invalid_argument if the state has a different shape (when error checking is enabled).
+     * @throws std::runtime_error if t1 is not reached within max_steps or the step becomes too small.
+     */
+    template <typename Function>
+    auto integrate(Function &&f, State &y, Time t0, Time t1, Time dt, std::size_t max_steps = 100000)
+        -> integration_stats {
+        detail::check_state(y, shape_);
+        integration_stats stats;
+        const double span = static_cast<double>(detail::numeric_value(t1 - t0));
+        if (span == 0) {
+            return stats;
+        }
+        const double direction = span > 0 ? 1.0 : -1.0;
+        double h = std::min(std::abs(static_cast<double>(detail::numeric_value(dt))), std::abs(span)) * direction;
+        double elapsed = 0;
+        detail::evaluate_rhs(f, t0, y, k_[0]);
+        ++stats.evaluations;
+        while (std::abs(elapsed) < std::abs(span)) {
+            if (stats.accepted + stats.rejected == max_steps) {
+                throw std::runtime_error("Integration did not reach the final time within the maximum steps");
+            }
+            const bool last = std::abs(elapsed + h) >= std::abs(span);
+            if (last) {
+                h = span - elapsed;
+            }
+            const Time t = t0 + as_time(elapsed);
+            const double error = attempt(f, t, y, as_time(h));
+            stats.evaluations += 6;
+            if (error <= 1) {
+                std::swap(y, next_);
+                std::swap(k_[0], k_[6]);
+                elapsed = last ? span : elapsed + h;
+                ++stats.accepted;
+            } else {
+                ++stats.rejected;
+            }
+            const double factor = error == 0 ? 5.0 : std::clamp(0.9 * std::pow(error, -0.2), 0.2, 5.0);
+            h *= error <= 1 ? factor : std::min(factor, 1.0);
+            if (error > 1 && std::abs(h) <= std::abs(span) * 1e-14) {
+                throw std::runtime_error("Step size became too small");
+            }
+        }
+        return stats;
+    }
+
+  private:
+    /// Converts a number of base units of time to Time.
+    static auto as_time(double value) -> Time {
+        return Time(static_cast<std::remove_cvref_t<decltype(detail::numeric_value(std::declval<Time>()))>>(value));
+    }
+
+    /// Computes the stages of a step from y into next_ and k_[1..6] and returns the scaled error norm.
+    template <typename Function> auto attempt(Function &f, Time t, const State &y, Time h) -> double {
+        constexpr std::array<double, 6> c{1.0 / 5, 3.0 / 10, 4.0 / 5, 8.0 / 9, 1.0, 1.0};
+        const std::size_t n = y.size();
+        std::array<const derivative_value_type *, 7> k{};
+        for (std::size_t j = 0; j < 7; ++j) {
+            k[j] = k_[j].data();
+        }
+        detail::combine_stages<1>(stage_.data(), y.data(), h, {1.0 / 5}, {k[0]}, n);
+        detail::evaluate_rhs(f, t + static_cast<Time>(h * c[0]), stage_, k_[1]);
+        detail::combine_stages<2>(stage_.data(), y.data(), h, {3.0 / 40, 9.0 / 40}, {k[0], k[1]}, n);
+        detail::evaluate_rhs(f, t + static_cast<Time>(h * c[1]), stage_, k_[2]);
+        detail::combine_stages<3>(stage_.data(), y.data(), h, {44.0 / 45, -56.0 / 15, 32.0 / 9}, {k[0], k[1], k[2]},
+                                  n);
+        detail::evaluate_rhs(f, t + static_cast<Time>(h * c[2]), stage_, k_[3]);
+        detail::combine_stages<4>(stage_.data(), y.data(), h,
+                                  {19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729},
+                                  {k[0], k[1], k[2], k[3]}, n);
+        detail::evaluate_rhs(f, t + static_cast<Time>(h * c[3]), stage_, k_[4]);
+        detail::combine_stages<5>(stage_.data(), y.data(), h,
+                                  {9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656},
+                                  {k[0], k[1], k[2], k[3], k[4]}, n);
+        detail::evaluate_rhs(f, t + static_cast<Time>(h * c[4]), stage_, k_[5]);
+        detail::combine_stages<6>(next_.data(), y.data(), h,
+                                  {35.0 / 384, 0.0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84},
+                                  {k[0], k[1], k[2], k[3], k[4], k[5]}, n);
+        detail::evaluate_rhs(f, t + static_cast<Time>(h * c[5]), next_, k_[6]);
+        // Difference between the fifth- and fourth-order solutions
+        detail::combine_stages<7>(stage_.data(), next_.data(), h,
+                                  {-71.0 / 57600, 0.0, 71.0 / 16695, -71.0 / 1920, 17253.0 / 339200, -22.0 / 525,
+                                   1.0 / 40},
+                                  {k[0], k[1], k[2], k[3], k[4], k[5], k[6]}, n);
+        const auto *y0 = y.data();
+        const auto *y1 = next_.data();
+        const auto *y4 = stage_.data();
+        // The maximum keeps a NaN so that a step producing one is rejected
+        auto larger = [](double a, double b) { return std::isnan(b) || b > a ? b : a; };
+        return parallel_reduce(
+            0, n, std::size_t{1} << 14, 0.0,
+            [&](std::size_t first, std::size_t last) {
+                double partial = 0;
+                for (std::size_t i = first; i < last; ++i) {
+                    const auto fifth = static_cast<double>(detail::numeric_value(y1[i]));
+                    const double error = fifth - static_cast<double>(detail::numeric_value(y4[i]));
+                    const double scale =
+                        atol_ + rtol_ * std::max(std::abs(static_cast<double>(detail::numeric_value(y0[i]))),
+                                                 std::abs(fifth));
+                    partial = larger(partial, std::abs(error / scale));
+                }
+                return partial;
+            },
+            larger);
+    }
+
+    std::vector<std::size_t> shape_;
+    double rtol_;
+    double atol_;
+    State stage_;
+    State next_;
+    std::array<derivative_type, 7> k_;
+};
+
+/**
+ * @brief Integrates a state in place with a fixed number of classical Runge-Kutta steps.
+ * @param f The right-hand side, callable as f(t, y, dydt) or f(t, y).
+ * @param y The state at t0, replaced by the state at t1.
+ * @param t0 The initial time.
+ * @param t1 The final time.
+ * @param steps The number of equal steps.
+ */
+template <typename Function, host_tensor State, typename Time>
+void integrate_rk4(Function &&f, State &y, Time t0, Time t1, std::size_t steps) {
+    rk4_stepper<State, Time> stepper(y);
+    const auto dt = static_cast<Time>((t1 - t0) / static_cast<double>(std::max<std::size_t>(steps, 1)));
+    for (std::size_t s = 0; s < steps; ++s) {
+        stepper.step(f, t0 + static_cast<Time>(dt * static_cast<double>(s)), y, dt);
+    }
+}
+
+/**
+ * @brief Integrates a state in place with the adaptive Dormand-Prince method.
+ * @param f The right-hand side, callable as f(t, y, dydt) or f(t, y).
+ * @param y The state at t0, replaced by the state at t1.
+ * @param t0 The initial time.
+ * @param t1 The final time.
+ * @param rtol The relative tolerance.
+ * @param atol The absolute tolerance, in the base units of the state.
+ * @return The number of accepted and rejected steps and of right-hand side evaluations.
+ * @throws std::runtime_error if the integration fails to reach t1.
+ */
+template <typename Function, host_tensor State, typename Time>
+auto integrate_adaptive(Function &&f, State &y, Time t0, Time t1, double rtol = 1e-6, double atol = 1e-9)
+    -> integration_stats {
+    dormand_prince_stepper<State, Time> stepper(y, rtol, atol);
+    return stepper.integrate(f, y, t0, t1, static_cast<Time>((t1 - t0) / 100.0));
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_ODE_HPP
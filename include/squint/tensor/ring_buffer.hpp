@@ -0,0 +1,232 @@
+/**
+ * @file ring_buffer.hpp
+ * @brief Circular buffer of multi-channel samples with running statistics.
+ *
+ * This file provides a ring buffer holding the last W samples of an N-channel signal. Samples are
+ * stored as the columns of a column-major N×W tensor, so every sample is contiguous and the
+ * logical window (oldest to newest) is always made of at most two contiguous blocks of columns,
+ * which are exposed as tensor views.
+ *
+ * Pushing a sample overwrites the oldest one in place and updates the per-channel running mean
+ * and sum of squared deviations (Welford's algorithm, extended to removals), so a push costs O(N)
+ * and never allocates.
+ */
+#ifndef SQUINT_TENSOR_RING_BUFFER_HPP
+#define SQUINT_TENSOR_RING_BUFFER_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/layout.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/quantity/quantity_ops.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/tensor/tensor_op_compatibility.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace squint {
+
+/**
+ * @brief Fixed-capacity circular buffer of N-channel samples.
+ *
+ * The running statistics are updated incrementally and may accumulate rounding error over very
+ * long runs; recompute_statistics() rebuilds them from the samples in the window.
+ *
+ * @tparam T The element type, an arithmetic or quantity type with a floating-point representation.
+ */
+template <scalar T>
+    requires floating_point<blas_type_t<T>>
+class ring_buffer {
+  public:
+    using value_type = T; ///< The type of the samples.
+    /// @brief The type of the variance, the square of the sample type.
+    using variance_type = decltype(std::declval<T>() * std::declval<T>());
+    /// @brief Read-only view over a block of samples, one sample per column.
+    using const_view_type =
+        tensor<const T, dynamic, dynamic, error_checking::disabled, ownership_type::reference, memory_space::host>;
+
+    /**
+     * @brief Constructs an empty ring buffer.
+     * @param channels The number of channels of each sample.
+     * @param window The maximum number of samples held by the buffer.
+     * @throws std::invalid_argument if channels or window is zero.
+     */
+    ring_buffer(std::size_t channels, std::size_t window)
+        : channels_(channels), window_(window), data_(channels * window), mean_(channels), m2_(channels) {
+        if (channels == 0 || window == 0) {
+            throw std::invalid_argument("ring_buffer requires at least one channel and a non-empty window");
+        }
+    }
+
+    /// @brief Returns the number of channels of each sample.
+    [[nodiscard]] auto channels() const -> std::size_t { return channels_; }
+    /// @brief Returns the maximum number of samples held by the buffer.
+    [[nodiscard]] auto window() const -> std::size_t { return window_; }
+    /// @brief Returns the number of samples currently held by the buffer.
+    [[nodiscard]] auto size() const -> std::size_t { return size_; }
+    /// @brief Returns true if the buffer holds no samples.
+    [[nodiscard]] auto empty() const -> bool { return size_ == 0; }
+    /// @brief Returns true if the buffer holds window() samples.
+    [[nodiscard]] auto full() const -> bool { return size_ == window_; }
+
+    /**
+     * @brief Appends a sample, evicting the oldest one if the buffer is full.
+     * @param sample A tensor with channels() elements.
+     * @throws std::invalid_argument if the sample does not have channels() elements.
+     */
+    template <tensorial Sample> void push(const Sample &sample) {
+        if (sample.size() != channels_) {
+            throw std::invalid_argument("Sample size does not match the number of channels");
+        }
+        const bool evict = full();
+        const std::size_t slot = evict ? head_ : (head_ + size_) % window_;
+        if (evict) {
+            head_ = (head_ + 1) % window_;
+        } else {
+            ++size_;
+        }
+        const auto n = static_cast<blas_type_t<T>>(size_);
+        T *column = data_.data() + slot * channels_;
+        auto it = sample.begin();
+        for (std::size_t c = 0; c < channels_; ++c, ++it) {
+            const T x = *it;
+            if (evict) {
+                // Replace y by x: the count is unchanged.
+                const T y = column[c];
+                const T mean = mean_[c] + (x - y) / n;
+                m2_[c] += (x - y) * ((x - mean) + (y - mean_[c]));
+                mean_[c] = mean;
+            } else {
+                const T delta = x - mean_[c];
+                mean_[c] += delta / n;
+                m2_[c] += delta * (x - mean_[c]);
+            }
+            m2_[c] = std::max(m2_[c], variance_type{});
+            column[c] = x;
+        }
+    }
+
+    /**
+     * @brief Removes all samples from the buffer without releasing its storage.
+     */
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+        std::fill(mean_.begin(), mean_.end(), T{});
+        std::fill(m2_.begin(), m2_.end(), variance_type{});
+    }
+
+    /**
+     * @brief Accesses a sample value in logical order.
+     * @param channel The channel index.
+     * @param index The sample index, 0 being the oldest sample in the window.
+     * @return The value of the channel in the sample.
+     */
+    auto operator()(std::size_t channel, std::size_t index) const -> const T & {
+        return data_[((head_ + index) % window_) * channels_ + channel];
+    }
+
+    /**
+     * @brief Returns a view of the most recent sample.
+     * @return An N-element view, or an empty view if the buffer is empty.
+     */
+    [[nodiscard]] auto latest() const -> const_view_type {
+        const std::size_t slot = empty() ? 0 : (head_ + size_ - 1) % window_;
+        return const_view_type(data_.data() + slot * channels_, {empty() ? 0 : channels_}, {1});
+    }
+
+    /**
+     * @brief Returns the window as two contiguous blocks of samples.
+     *
+     * The first view holds the oldest samples and the second the most recent ones, one sample per
+     * column. The second view is empty unless the window wraps around the end of the storage.
+     *
+     * @return A pair of N×k views whose concatenation is the window in chronological order.
+     */
+    [[nodiscard]] auto segments() const -> std::pair<const_view_type, const_view_type> {
+        const std::size_t first = std::min(size_, window_ - head_);
+        return {std::piecewise_construct, block_arguments(head_, first), block_arguments(0, size_ - first)};
+    }
+
+    /**
+     * @brief Returns the per-channel sum of the samples in the window.
+     * @return An N-element tensor.
+     */
+    [[nodiscard]] auto sum() const -> tensor<T, dynamic, dynamic> {
+        tensor<T, dynamic, dynamic> result({channels_});
+        const auto n = static_cast<blas_type_t<T>>(size_);
+        for (std::size_t c = 0; c < channels_; ++c) {
+            result(c) = mean_[c] * n;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the per-channel mean of the samples in the window.
+     * @return An N-element tensor, zero if the buffer is empty.
+     */
+    [[nodiscard]] auto mean() const -> tensor<T, dynamic, dynamic> {
+        tensor<T, dynamic, dynamic> result({channels_});
+        std::copy(mean_.begin(), mean_.end(), result.data());
+        return result;
+    }
+
+    /**
+     * @brief Returns the per-channel population variance of the samples in the window.
+     * @return An N-element tensor, zero if the buffer is empty.
+     */
+    [[nodiscard]] auto variance() const -> tensor<variance_type, dynamic, dynamic> {
+        tensor<variance_type, dynamic, dynamic> result({channels_});
+        const auto n = static_cast<blas_type_t<T>>(std::max<std::size_t>(size_, 1));
+        for (std::size_t c = 0; c < channels_; ++c) {
+            result(c) = m2_[c] / n;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Recomputes the running statistics from the samples in the window.
+     *
+     * This costs O(N·W) and discards the rounding error accumulated by the incremental updates.
+     */
+    void recompute_statistics() {
+        const std::size_t count = size_;
+        const std::size_t head = head_;
+        clear();
+        for (std::size_t k = 0; k < count; ++k) {
+            const std::size_t slot = (head + k) % window_;
+            const auto n = static_cast<blas_type_t<T>>(k + 1);
+            for (std::size_t c = 0; c < channels_; ++c) {
+                const T x = data_[slot * channels_ + c];
+                const T delta = x - mean_[c];
+                mean_[c] += delta / n;
+                m2_[c] += delta * (x - mean_[c]);
+            }
+        }
+        head_ = head;
+        size_ = count;
+    }
+
+  private:
+    [[nodiscard]] auto block_arguments(std::size_t first, std::size_t count) const {
+        return std::make_tuple(data_.data() + first * channels_, std::vector<std::size_t>{channels_, count},
+                               std::vector<std::size_t>{1, channels_});
+    }
+
+    std::size_t channels_;
+    std::size_t window_;
+    std::size_t head_ = 0; ///< Storage column of the oldest sample.
+    std::size_t size_ = 0;
+    std::vector<T> data_;
+    std::vector<T> mean_;
+    std::vector<variance_type> m2_;
+};
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_RING_BUFFER_HPP
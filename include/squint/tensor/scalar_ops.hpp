@@ -15,6 +15,9 @@
 // NOLINTNEXTLINE
 #include "squint/tensor/tensor_op_compatibility.hpp"
 
+#include <type_traits>
+#include <utility>
+
 #ifdef SQUINT_USE_CUDA
 #include "squint/tensor/cuda/scalar.hpp"
 #endif
@@ -262,6 +265,53 @@ auto operator/(const tensor<T, Shape, Strides, ErrorChecking, OwnershipType, Mem
     }
 }
 
+// Scalar operations on expiring tensors
+/**
+ * @brief Tensor-scalar multiplication operator reusing the storage of an expiring tensor.
+ *
+ * Used when the product keeps the element type of the tensor, in which case the result has the
+ * same type as the one returned by the copying operator.
+ *
+ * @param t The tensor to be multiplied, whose storage holds the result.
+ * @param s The scalar to multiply by.
+ * @return The result of the multiplication.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, dimensionless_scalar U>
+    requires std::is_same_v<decltype(std::declval<T>() * std::declval<U>()), T>
+auto operator*(tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host> &&t, const U &s) {
+    t *= s;
+    return std::move(t);
+}
+
+/**
+ * @brief Scalar-tensor multiplication operator reusing the storage of an expiring tensor.
+ * @param s The scalar to multiply by.
+ * @param t The tensor to be multiplied, whose storage holds the result.
+ * @return The result of the multiplication.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, dimensionless_scalar U>
+    requires std::is_same_v<decltype(std::declval<T>() * std::declval<U>()), T>
+auto operator*(const U &s, tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host> &&t) {
+    return std::move(t) * s;
+}
+
+/**
+ * @brief Tensor-scalar division operator reusing the storage of an expiring tensor.
+ *
+ * Used when the quotient keeps the element type of the tensor, in which case the result has the
+ * same type as the one returned by the copying operator.
+ *
+ * @param t The tensor to be divided, whose storage holds the result.
+ * @param s The scalar to divide by.
+ * @return The result of the division.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, dimensionless_scalar U>
+    requires std::is_same_v<decltype(std::declval<T>() / std::declval<U>()), T>
+auto operator/(tensor<T, Shape, Strides, ErrorChecking, ownership_type::owner, memory_space::host> &&t, const U &s) {
+    t /= s;
+    return std::move(t);
+}
+
 } // namespace squint
 
 #endif // SQUINT_TENSOR_SCALAR_OPS_HPP
\ No newline at end of file
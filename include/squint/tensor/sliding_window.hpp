@@ -0,0 +1,294 @@
+/**
+ * @file sliding_window.hpp
+ * @brief Overlapping window views and moving-window reductions.
+ *
+ * This file provides sliding_window_view, which turns a rank-R tensor into a rank-2R reference
+ * view whose first R axes index the window position and whose last R axes index the element
+ * within the window. Windows overlap whenever the step is smaller than the window, which is
+ * expressed purely through strides, so no data is copied.
+ *
+ * The window_sum, window_mean, window_max and window_min kernels compute the same reductions as
+ * reducing such a view over its window axes, but in O(size) per axis independently of the window
+ * size: extrema use a monotonic queue, and sums split each line into blocks of the window length
+ * and add a suffix sum of one block to a prefix sum of the next (van Herk / Gil-Werman). Every
+ * window sum is then a sum of its own elements only, so unlike differences of prefix sums over
+ * the whole line it does not lose precision on long signals. N-D windows are reduced one axis at
+ * a time, since all four reductions are separable.
+ */
+#ifndef SQUINT_TENSOR_SLIDING_WINDOW_HPP
+#define SQUINT_TENSOR_SLIDING_WINDOW_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/tensor/tensor_op_compatibility.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace squint {
+
+namespace detail {
+
+/**
+ * @brief Checks a window shape and step against a tensor shape and fills in the default step.
+ * @param shape The shape of the tensor.
+ * @param window_shape The shape of the window.
+ * @param step The step between windows, or empty for a step of 1 along every axis.
+ * @return The step along every axis.
+ * @throws std::invalid_argument if the window or step is invalid (when error checking is enabled).
+ */
+template <error_checking ErrorChecking, typename ShapeRange>
+auto window_step(const ShapeRange &shape, const std::vector<std::size_t> &window_shape,
+                 const std::vector<std::size_t> &step) -> std::vector<std::size_t> {
+    if constexpr (ErrorChecking == error_checking::enabled) {
+        if (window_shape.size() != shape.size() || (!step.empty() && step.size() != shape.size())) {
+            throw std::invalid_argument("Window rank must match tensor rank");
+        }
+        for (std::size_t i = 0; i < shape.size(); ++i) {
+            if (window_shape[i] == 0 || window_shape[i] > shape[i] || (!step.empty() && step[i] == 0)) {
+                throw std::invalid_argument("Invalid window shape or step");
+            }
+        }
+    }
+    return step.empty() ? std::vector<std::size_t>(shape.size(), 1) : step;
+}
+
+/**
+ * @brief Returns the number of window positions along every axis.
+ */
+template <typename ShapeRange>
+auto window_positions(const ShapeRange &shape, const std::vector<std::size_t> &window_shape,
+                      const std::vector<std::size_t> &step) -> std::vector<std::size_t> {
+    std::vector<std::size_t> positions(shape.size());
+    for (std::size_t i = 0; i < shape.size(); ++i) {
+        positions[i] = (shape[i] - window_shape[i]) / step[i] + 1;
+    }
+    return positions;
+}
+
+/**
+ * @brief Operation used by the moving-window kernels.
+ */
+enum class window_reduction : std::uint8_t { sum, max, min };
+
+/**
+ * @brief Reduces every line of a column-major buffer along one axis over a moving window.
+ *
+ * @param input The input buffer, column-major with the given shape.
+ * @param shape The shape of the input, updated to the shape of the output.
+ * @param axis The axis to reduce along.
+ * @param window The window extent along the axis.
+ * @param step The step between windows along the axis.
+ * @return The output buffer, column-major.
+ */
+template <window_reduction Op, typename T>
+auto reduce_window_axis(const std::vector<T> &input, std::vector<std::size_t> &shape, std::size_t axis,
+                        std::size_t window, std::size_t step) -> std::vector<T> {
+    const std::size_t length = shape[axis];
+    const std::size_t positions = (length - window) / step + 1;
+    const std::size_t inner = std::accumulate(shape.begin(), shape.begin() + static_cast<std::ptrdiff_t>(axis),
+                                              std::size_t{1}, std::multiplies<>());
+    const std::size_t outer = std::accumulate(shape.begin() + static_cast<std::ptrdiff_t>(axis) + 1, shape.end(),
+                                              std::size_t{1}, std::multiplies<>());
+    std::vector<T> output(inner * positions * outer);
+    const std::size_t lines = inner * outer;
+    const std::size_t grain = std::max<std::size_t>(1, (std::size_t{1} << 14) / std::max<std::size_t>(1, length));
+    parallel_for(0, lines, grain, [&](std::size_t first, std::size_t last) {
+        // Scratch space reused by every line of the chunk: block prefix and suffix sums or the monotonic queue.
+        std::vector<T> prefix;
+        std::vector<T> suffix;
+        std::vector<std::size_t> queue;
+        if constexpr (Op == window_reduction::sum) {
+            prefix.resize(length);
+            suffix.resize(length);
+        } else {
+            queue.resize(length);
+        }
+        for (std::size_t line = first; line < last; ++line) {
+            const std::size_t i = line % inner;
+            const std::size_t o = line / inner;
+            const T *in = input.data() + i + o * inner * length;
+            T *out = output.data() + i + o * inner * positions;
+            if constexpr (Op == window_reduction::sum) {
+                // Sums run from the start of the block of k to k (prefix) and from k to the end of its block (suffix).
+                for (std::size_t k = 0; k < length; ++k) {
+                    prefix[k] = k % window == 0 ? in[k * inner] : prefix[k - 1] + in[k * inner];
+                }
+                for (std::size_t k = length; k-- > 0;) {
+                    const bool block_end = k % window == window - 1 || k + 1 == length;
+                    suffix[k] = block_end ? in[k * inner] : suffix[k + 1] + in[k * inner];
+                }
+                // A window either is a whole block or spans the end of one block and the start of the next.
+                for (std::size_t p = 0; p < positions; ++p) {
+                    const std::size_t start = p * step;
+                    out[p * inner] =
+                        start % window == 0 ? suffix[start] : suffix[start] + prefix[start + window - 1];
+                }
+            } else {
+                // The queue holds indices of a decreasing (max) or increasing (min) run of values.
+                auto dominates = [](const T &a, const T &b) {
+                    if constexpr (Op == window_reduction::max) {
+                        return a >= b;
+                    } else {
+                        return a <= b;
+                    }
+                };
+                std::size_t head = 0;
+                std::size_t tail = 0;
+                std::size_t p = 0;
+                for (std::size_t k = 0; k < length && p < positions; ++k) {
+                    while (tail > head && dominates(in[k * inner], in[queue[tail - 1] * inner])) {
+                        --tail;
+                    }
+                    queue[tail++] = k;
+                    if (k + 1 == p * step + window) {
+                        while (queue[head] < p * step) {
+                            ++head;
+                        }
+                        out[p * inner] = in[queue[head] * inner];
+                        ++p;
+                    }
+                }
+            }
+        }
+    });
+    shape[axis] = positions;
+    return output;
+}
+
+/**
+ * @brief Reduces a tensor over a moving window, one axis at a time.
+ */
+template <window_reduction Op, host_tensor Tensor>
+auto reduce_window(const Tensor &t, const std::vector<std::size_t> &window_shape, const std::vector<std::size_t> &step)
+    -> tensor<std::remove_const_t<typename Tensor::value_type>, dynamic, dynamic> {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    const auto tensor_shape = t.shape();
+    const auto steps = window_step<Tensor::error_checking()>(tensor_shape, window_shape, step);
+    std::vector<std::size_t> shape(tensor_shape.begin(), tensor_shape.end());
+    std::vector<value_type> buffer;
+    buffer.reserve(t.size());
+    for (const auto &element : t) {
+        buffer.push_back(element);
+    }
+    for (std::size_t axis = 0; axis < shape.size(); ++axis) {
+        if (window_shape[axis] > 1 || steps[axis] > 1) {
+            buffer = reduce_window_axis<Op>(buffer, shape, axis, window_shape[axis], steps[axis]);
+        }
+    }
+    return tensor<value_type, dynamic, dynamic>(shape, buffer);
+}
+
+} // namespace detail
+
+/**
+ * @brief Creates a view of all windows of a tensor.
+ *
+ * For a tensor of shape (n_0, ..., n_{R-1}), a window shape (w_0, ..., w_{R-1}) and a step
+ * (s_0, ..., s_{R-1}), the view has shape (p_0, ..., p_{R-1}, w_0, ..., w_{R-1}) with
+ * p_i = (n_i - w_i) / s_i + 1, and element (j..., k...) is element (j_i * s_i + k_i)... of the
+ * tensor. Windows share elements when the step is smaller than the window, so writing through
+ * the view writes every window containing the element.
+ *
+ * @param t The tensor to view.
+ * @param window_shape The shape of the window.
+ * @param step The step between windows, 1 along every axis by default.
+ * @return A reference view of rank 2R over the data of t.
+ * @throws std::invalid_argument if the window or step is invalid (when error checking is enabled).
+ */
+template <typename Tensor>
+    requires tensorial<std::remove_const_t<Tensor>> && host_tensor<std::remove_const_t<Tensor>>
+auto sliding_window_view(Tensor &t, const std::vector<std::size_t> &window_shape,
+                         const std::vector<std::size_t> &step = {}) {
+    using tensor_type = std::remove_const_t<Tensor>;
+    using element_type = std::remove_pointer_t<decltype(t.data())>;
+    constexpr auto checking = tensor_type::error_checking();
+    const auto tensor_shape = t.shape();
+    const auto tensor_strides = t.strides();
+    const auto steps = detail::window_step<checking>(tensor_shape, window_shape, step);
+    const std::size_t rank = tensor_shape.size();
+    std::vector<std::size_t> shape = detail::window_positions(tensor_shape, window_shape, steps);
+    std::vector<std::size_t> strides(2 * rank);
+    shape.insert(shape.end(), window_shape.begin(), window_shape.end());
+    for (std::size_t i = 0; i < rank; ++i) {
+        strides[i] = tensor_strides[i] * steps[i];
+        strides[rank + i] = tensor_strides[i];
+    }
+    return tensor<element_type, dynamic, dynamic, checking, ownership_type::reference, memory_space::host>(
+        t.data(), shape, strides);
+}
+
+/**
+ * @brief Sums a tensor over a moving window.
+ * @param t The tensor to reduce.
+ * @param window_shape The shape of the window.
+ * @param step The step between windows, 1 along every axis by default.
+ * @return A column-major tensor with one element per window position.
+ * @throws std::invalid_argument if the window or step is invalid (when error checking is enabled).
+ */
+template <host_tensor Tensor>
+auto window_sum(const Tensor &t, const std::vector<std::size_t> &window_shape,
+                const std::vector<std::size_t> &step = {}) {
+    return detail::reduce_window<detail::window_reduction::sum>(t, window_shape, step);
+}
+
+/**
+ * @brief Averages a tensor over a moving window.
+ * @param t The tensor to reduce.
+ * @param window_shape The shape of the window.
+ * @param step The step between windows, 1 along every axis by default.
+ * @return A column-major tensor with one element per window position.
+ * @throws std::invalid_argument if the window or step is invalid (when error checking is enabled).
+ */
+template <host_tensor Tensor>
+    requires floating_point<blas_type_t<std::remove_const_t<typename Tensor::value_type>>>
+auto window_mean(const Tensor &t, const std::vector<std::size_t> &window_shape,
+                 const std::vector<std::size_t> &step = {}) {
+    using scalar_type = blas_type_t<std::remove_const_t<typename Tensor::value_type>>;
+    auto result = window_sum(t, window_shape, step);
+    const auto count = static_cast<scalar_type>(
+        std::accumulate(window_shape.begin(), window_shape.end(), std::size_t{1}, std::multiplies<>()));
+    result /= count;
+    return result;
+}
+
+/**
+ * @brief Takes the maximum of a tensor over a moving window.
+ * @param t The tensor to reduce.
+ * @param window_shape The shape of the window.
+ * @param step The step between windows, 1 along every axis by default.
+ * @return A column-major tensor with one element per window position.
+ * @throws std::invalid_argument if the window or step is invalid (when error checking is enabled).
+ */
+template <host_tensor Tensor>
+auto window_max(const Tensor &t, const std::vector<std::size_t> &window_shape,
+                const std::vector<std::size_t> &step = {}) {
+    return detail::reduce_window<detail::window_reduction::max>(t, window_shape, step);
+}
+
+/**
+ * @brief Takes the minimum of a tensor over a moving window.
+ * @param t The tensor to reduce.
+ * @param window_shape The shape of the window.
+ * @param step The step between windows, 1 along every axis by default.
+ * @return A column-major tensor with one element per window position.
+ * @throws std::invalid_argument if the window or step is invalid (when error checking is enabled).
+ */
+template <host_tensor Tensor>
+auto window_min(const Tensor &t, const std::vector<std::size_t> &window_shape,
+                const std::vector<std::size_t> &step = {}) {
+    return detail::reduce_window<detail::window_reduction::min>(t, window_shape, step);
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_SLIDING_WINDOW_HPP
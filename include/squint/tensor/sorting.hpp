@@ -0,0 +1,220 @@
+/**
+ * @file sorting.hpp
+ * @brief Sorting, partitioning and top-k selection along an axis.
+ *
+ * This file provides sort, argsort, partition and topk, which treat every line of a tensor along
+ * an axis as an independent sequence. Lines may be strided, so the functions work on views such
+ * as transposes and subviews; each line is gathered into a contiguous buffer, processed there and
+ * written back. Lines are distributed over threads.
+ *
+ * Short lines of arithmetic elements sorted in ascending or descending order use a sorting network
+ * made of branch-free compare-exchanges, which is faster than a general sort at these sizes.
+ * Top-k selection keeps a heap of the k best elements, so it costs O(n log k) per line.
+ */
+#ifndef SQUINT_TENSOR_SORTING_HPP
+#define SQUINT_TENSOR_SORTING_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/layout.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/tensor/indexing.hpp"
+#include "squint/tensor/tensor.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace squint {
+
+namespace detail {
+
+/// Longest line sorted with a sorting network.
+inline constexpr std::size_t sorting_network_length = 16;
+
+/**
+ * @brief Checks whether a comparator orders arithmetic values with < or > so a network can sort them.
+ */
+template <typename T, typename Compare>
+inline constexpr bool network_sortable =
+    arithmetic<T> && (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>> ||
+                      std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<T>>);
+
+/**
+ * @brief Sorts a short buffer with an odd-even transposition network.
+ *
+ * Every compare-exchange selects both outputs from one comparison, so the network has no data-dependent
+ * branches and only ever permutes the values; signed zeros and NaNs are kept.
+ */
+template <typename T, typename Compare> void network_sort(T *data, std::size_t n) {
+    constexpr bool ascending = std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>;
+    for (std::size_t round = 0; round < n; ++round) {
+        for (std::size_t i = round % 2; i + 1 < n; i += 2) {
+            const T a = data[i];
+            const T b = data[i + 1];
+            const bool swap = ascending ? b < a : a < b;
+            data[i] = swap ? b : a;
+            data[i + 1] = swap ? a : b;
+        }
+    }
+}
+
+/**
+ * @brief Writes the values of a line of a column-major output with the given shape.
+ */
+template <typename T>
+void store_line(std::vector<T> &out, const std::vector<std::size_t> &shape, std::size_t axis, std::size_t line,
+                const T *values) {
+    std::size_t inner = 1;
+    for (std::size_t k = 0; k < axis; ++k) {
+        inner *= shape[k];
+    }
+    const std::size_t base = (line % inner) + (line / inner) * inner * shape[axis];
+    for (std::size_t j = 0; j < shape[axis]; ++j) {
+        out[base + j * inner] = values[j];
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Sorts every line of a tensor along an axis in place.
+ * @param t The tensor or view to sort.
+ * @param axis The axis along which to sort.
+ * @param comp The strict weak ordering, std::less<>{} for ascending order.
+ * @throws std::invalid_argument if the axis is out of range (when error checking is enabled).
+ */
+template <host_tensor Tensor, typename Compare = std::less<>>
+void sort(Tensor &t, std::size_t axis = 0, Compare comp = {}) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    detail::for_each_axis_line<true>(t, axis, [&](std::vector<value_type> &line, std::size_t /*unused*/) {
+        if constexpr (detail::network_sortable<value_type, Compare>) {
+            if (line.size() <= detail::sorting_network_length) {
+                detail::network_sort<value_type, Compare>(line.data(), line.size());
+                return;
+            }
+        }
+        std::sort(line.begin(), line.end(), comp);
+    });
+}
+
+/**
+ * @brief Computes the indices that sort every line of a tensor along an axis.
+ *
+ * The sort is stable, so equal elements keep their order.
+ *
+ * @param t The tensor.
+ * @param axis The axis along which to sort.
+ * @param comp The strict weak ordering, std::less<>{} for ascending order.
+ * @return A column-major tensor of the shape of t holding, along every line, the indices of the elements in
+ * sorted order.
+ * @throws std::invalid_argument if the axis is out of range (when error checking is enabled).
+ */
+template <host_tensor Tensor, typename Compare = std::less<>>
+auto argsort(const Tensor &t, std::size_t axis = 0, Compare comp = {}) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    const std::vector<std::size_t> shape(t.shape().begin(), t.shape().end());
+    std::vector<std::size_t> indices(t.size());
+    detail::for_each_axis_line<false>(t, axis, [&](std::vector<value_type> &line, std::size_t index) {
+        std::vector<std::size_t> order(line.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::stable_sort(order.begin(), order.end(),
+                         [&](std::size_t a, std::size_t b) { return comp(line[a], line[b]); });
+        detail::store_line(indices, shape, axis, index, order.data());
+    });
+    return tensor<std::size_t, dynamic, dynamic, Tensor::error_checking()>(shape, indices, layout::column_major);
+}
+
+/**
+ * @brief Partitions every line of a tensor along an axis in place around its kth element.
+ *
+ * Afterwards the element at index kth of every line is the one that would be there if the line
+ * were sorted, no element before it compares greater and no element after it compares less, as
+ * with std::nth_element.
+ *
+ * @param t The tensor or view to partition.
+ * @param kth The index of the element to place.
+ * @param axis The axis along which to partition.
+ * @param comp The strict weak ordering, std::less<>{} for ascending order.
+ * @throws std::invalid_argument if the axis or kth is out of range (when error checking is enabled).
+ */
+template <host_tensor Tensor, typename Compare = std::less<>>
+void partition(Tensor &t, std::size_t kth, std::size_t axis = 0, Compare comp = {}) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    if constexpr (Tensor::error_checking() == error_checking::enabled) {
+        if (axis < t.rank() && kth >= t.shape()[axis]) {
+            throw std::invalid_argument("Partition index out of range");
+        }
+    }
+    detail::for_each_axis_line<true>(t, axis, [&](std::vector<value_type> &line, std::size_t /*unused*/) {
+        std::nth_element(line.begin(), line.begin() + static_cast<std::ptrdiff_t>(kth), line.end(), comp);
+    });
+}
+
+/**
+ * @brief Result of topk: the selected values and their indices along the axis.
+ */
+template <typename T, error_checking ErrorChecking> struct topk_result {
+    tensor<T, dynamic, dynamic, ErrorChecking> values;
+    tensor<std::size_t, dynamic, dynamic, ErrorChecking> indices;
+};
+
+/**
+ * @brief Selects the k largest or smallest elements of every line of a tensor along an axis.
+ *
+ * @param t The tensor.
+ * @param k The number of elements to select from every line.
+ * @param axis The axis along which to select.
+ * @param largest True to select the largest elements, false for the smallest.
+ * @return The selected values, best first, and their indices along the axis; both are column-major tensors with
+ * the shape of t except for an extent of k along axis. Ties are broken in favor of the lower index.
+ * @throws std::invalid_argument if the axis or k is out of range (when error checking is enabled).
+ */
+template <host_tensor Tensor> auto topk(const Tensor &t, std::size_t k, std::size_t axis = 0, bool largest = true) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    constexpr auto checking = Tensor::error_checking();
+    std::vector<std::size_t> shape(t.shape().begin(), t.shape().end());
+    if constexpr (checking == error_checking::enabled) {
+        if (axis < shape.size() && k > shape[axis]) {
+            throw std::invalid_argument("k exceeds the extent of the axis");
+        }
+    }
+    std::vector<std::size_t> result_shape = shape;
+    if (axis < shape.size()) {
+        result_shape[axis] = k;
+    }
+    const std::size_t result_size =
+        std::accumulate(result_shape.begin(), result_shape.end(), std::size_t{1}, std::multiplies<>());
+    std::vector<value_type> values(result_size);
+    std::vector<std::size_t> indices(result_size);
+    detail::for_each_axis_line<false>(t, axis, [&](std::vector<value_type> &line, std::size_t index) {
+        // Orders indices from best to worst, breaking ties by index
+        auto better = [&](std::size_t a, std::size_t b) {
+            if (line[a] == line[b]) {
+                return a < b;
+            }
+            return largest ? line[b] < line[a] : line[a] < line[b];
+        };
+        std::vector<std::size_t> order(line.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k), order.end(), better);
+        std::vector<value_type> best(k);
+        for (std::size_t j = 0; j < k; ++j) {
+            best[j] = line[order[j]];
+        }
+        detail::store_line(values, result_shape, axis, index, best.data());
+        detail::store_line(indices, result_shape, axis, index, order.data());
+    });
+    return topk_result<value_type, checking>{
+        tensor<value_type, dynamic, dynamic, checking>(result_shape, values),
+        tensor<std::size_t, dynamic, dynamic, checking>(result_shape, indices, layout::column_major)};
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_SORTING_HPP
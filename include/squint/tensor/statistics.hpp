@@ -0,0 +1,638 @@
+/**
+ * @file statistics.hpp
+ * @brief Means, variances, covariance and correlation matrices, histograms and quantiles.
+ *
+ * This file provides moments, which computes the mean and variance of every line of a tensor along
+ * an axis with Welford's single-pass update, and covariance and correlation, which treat the rows
+ * of an N×D tensor as N observations of D variables.
+ *
+ * The covariance computation is built on moment_accumulator, a streaming accumulator of the count,
+ * mean and scatter matrix of observations that arrive in chunks. Each chunk is centered on its own
+ * mean and its scatter matrix is computed with a symmetric rank-k update (SYRK, see gram), then the
+ * chunk is merged into the running totals with the pairwise update of Chan, Golub and LeVeque.
+ * Accumulators built on different threads or different data merge the same way, which is how
+ * covariance splits its input across threads.
+ *
+ * histogram counts elements into equal-width bins in parallel, with each thread counting into
+ * private bins that are summed at the end. p2_quantile estimates a quantile of a stream in a
+ * single pass with constant memory using the P² algorithm of Jain and Chlamtac, and
+ * approx_quantile applies it to the elements of a tensor without copying or sorting them.
+ */
+#ifndef SQUINT_TENSOR_STATISTICS_HPP
+#define SQUINT_TENSOR_STATISTICS_HPP
+
+#include "squint/core/concepts.hpp"
+#include "squint/core/error_checking.hpp"
+#include "squint/core/layout.hpp"
+#include "squint/core/memory.hpp"
+#include "squint/tensor/indexing.hpp"
+#include "squint/tensor/tensor.hpp"
+#include "squint/tensor/tensor_math.hpp"
+#include "squint/tensor/tensor_op_compatibility.hpp"
+#include "squint/util/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace squint {
+
+/**
+ * @brief Streaming accumulator of the mean and covariance of D-dimensional observations.
+ *
+ * Observations are added one at a time or in chunks, and accumulators over disjoint data can be
+ * merged, so partial results computed on several threads or for data arriving over time combine
+ * into the statistics of all observations.
+ *
+ * @tparam T The floating-point type of the observations.
+ */
+template <floating_point T> class moment_accumulator {
+  public:
+    /**
+     * @brief Constructs an empty accumulator.
+     * @param dimension The number of variables D of every observation.
+     */
+    explicit moment_accumulator(std::size_t dimension)
+        : dimension_(dimension), mean_(dimension), scatter_(dimension * dimension) {}
+
+    /**
+     * @brief Adds observations.
+     * @param observations A tensor of shape {D} holding one observation or of shape {N, D} holding one per row.
+     * @throws std::invalid_argument if the observations do not have D variables.
+     */
+    template <host_tensor Tensor> void add(const Tensor &observations) {
+        const auto shape = observations.shape();
+        const std::size_t variables = shape.size() == 1 ? shape[0] : shape.size() == 2 ? shape[1] : 0;
+        if (variables != dimension_) {
+            throw std::invalid_argument("Observations must have one element per variable");
+        }
+        if (shape.size() == 1) {
+            std::vector<T> x;
+            x.reserve(dimension_);
+            for (const auto &element : observations) {
+                x.push_back(static_cast<T>(element));
+            }
+            add_observation(x);
+            return;
+        }
+        const std::size_t rows = shape[0];
+        std::vector<T> block(rows * dimension_);
+        for (std::size_t j = 0; j < dimension_; ++j) {
+            for (std::size_t i = 0; i < rows; ++i) {
+                block[i + j * rows] = static_cast<T>(observations(i, j));
+            }
+        }
+        add_block(block, rows);
+    }
+
+    /**
+     * @brief Adds a chunk of observations stored column-major, one observation per row.
+     * @param block The rows × D observations, overwritten with the observations centered on their mean.
+     * @param rows The number of observations.
+     */
+    void add_block(std::vector<T> &block, std::size_t rows) {
+        if (rows == 0) {
+            return;
+        }
+        std::vector<T> block_mean(dimension_);
+        for (std::size_t j = 0; j < dimension_; ++j) {
+            T total = 0;
+            for (std::size_t i = 0; i < rows; ++i) {
+                total += block[i + j * rows];
+            }
+            block_mean[j] = total / static_cast<T>(rows);
+            for (std::size_t i = 0; i < rows; ++i) {
+                block[i + j * rows] -= block_mean[j];
+            }
+        }
+        const tensor<T, dynamic, dynamic, error_checking::disabled, ownership_type::reference, memory_space::host>
+            centered(block.data(), std::vector<std::size_t>{rows, dimension_}, std::vector<std::size_t>{1, rows});
+        const auto block_scatter = gram(centered, fill_mode::full);
+        std::vector<T> scatter(dimension_ * dimension_);
+        std::size_t index = 0;
+        for (const auto &element : block_scatter) {
+            scatter[index++] = element;
+        }
+        merge(rows, block_mean, scatter);
+    }
+
+    /**
+     * @brief Merges the observations of another accumulator into this one.
+     * @param other An accumulator over observations with the same number of variables.
+     * @throws std::invalid_argument if the numbers of variables differ.
+     */
+    void merge(const moment_accumulator &other) {
+        if (other.dimension_ != dimension_) {
+            throw std::invalid_argument("Accumulators must have the same number of variables");
+        }
+        merge(other.count_, other.mean_, other.scatter_);
+    }
+
+    /// @brief Returns the number of observations.
+    [[nodiscard]] auto count() const -> std::size_t { return count_; }
+    /// @brief Returns the number of variables.
+    [[nodiscard]] auto dimension() const -> std::size_t { return dimension_; }
+
+    /// @brief Returns the mean of the observations, of shape {D}.
+    [[nodiscard]] auto mean() const -> tensor<T, dynamic, dynamic> {
+        return tensor<T, dynamic, dynamic>(std::vector<std::size_t>{dimension_}, mean_);
+    }
+
+    /**
+     * @brief Returns the covariance matrix of the observations, of shape {D, D}.
+     * @param ddof The delta degrees of freedom: the scatter is divided by count() - ddof.
+     * @throws std::invalid_argument if count() <= ddof.
+     */
+    [[nodiscard]] auto covariance(std::size_t ddof = 1) const -> tensor<T, dynamic, dynamic> {
+        if (count_ <= ddof) {
+            throw std::invalid_argument("Not enough observations for the covariance");
+        }
+        tensor<T, dynamic, dynamic> result(std::vector<std::size_t>{dimension_, dimension_}, scatter_);
+        result /= static_cast<T>(count_ - ddof);
+        return result;
+    }
+
+    /**
+     * @brief Returns the correlation matrix of the observations, of shape {D, D}.
+     *
+     * Variables with zero variance have NaN correlations.
+     *
+     * @throws std::invalid_argument if there are fewer than two observations.
+     */
+    [[nodiscard]] auto correlation() const -> tensor<T, dynamic, dynamic> {
+        auto result = covariance();
+        std::vector<T> deviation(dimension_);
+        for (std::size_t j = 0; j < dimension_; ++j) {
+            deviation[j] = std::sqrt(result(j, j));
+        }
+        for (std::size_t j = 0; j < dimension_; ++j) {
+            for (std::size_t i = 0; i < dimension_; ++i) {
+                result(i, j) = i == j ? T{1} : result(i, j) / (deviation[i] * deviation[j]);
+            }
+        }
+        return result;
+    }
+
+  private:
+    /// Welford's update for a single observation.
+    void add_observation(const std::vector<T> &x) {
+        ++count_;
+        std::vector<T> delta(dimension_);
+        for (std::size_t j = 0; j < dimension_; ++j) {
+            delta[j] = x[j] - mean_[j];
+            mean_[j] += delta[j] / static_cast<T>(count_);
+        }
+        for (std::size_t j = 0; j < dimension_; ++j) {
+            for (std::size_t i = 0; i < dimension_; ++i) {
+                scatter_[i + j * dimension_] += delta[i] * (x[j] - mean_[j]);
+            }
+        }
+    }
+
+    /// Pairwise update combining the statistics of two disjoint sets of observations.
+    void merge(std::size_t count, const std::vector<T> &mean, const std::vector<T> &scatter) {
+        if (count == 0) {
+            return;
+        }
+        const std::size_t total = count_ + count;
+        const T weight = static_cast<T>(count_) * static_cast<T>(count) / static_cast<T>(total);
+        std::vector<T> delta(dimension_);
+        for (std::size_t j = 0; j < dimension_; ++j) {
+            delta[j] = mean[j] - mean_[j];
+            mean_[j] += delta[j] * static_cast<T>(count) / static_cast<T>(total);
+        }
+        for (std::size_t j = 0; j < dimension_; ++j) {
+            for (std::size_t i = 0; i < dimension_; ++i) {
+                scatter_[i + j * dimension_] += scatter[i + j * dimension_] + weight * delta[i] * delta[j];
+            }
+        }
+        count_ = total;
+    }
+
+    std::size_t dimension_;
+    std::size_t count_ = 0;
+    std::vector<T> mean_;
+    std::vector<T> scatter_; ///< Sum of outer products of the centered observations, column-major.
+};
+
+namespace detail {
+
+/**
+ * @brief Accumulates the rows of an N×D tensor, splitting them across threads.
+ */
+template <host_tensor Tensor> auto accumulate_rows(const Tensor &X) {
+    using scalar_type = std::remove_const_t<typename Tensor::value_type>;
+    static_assert(floating_point<scalar_type>, "Covariance requires floating-point elements");
+    if constexpr (fixed_tensor<Tensor>) {
+        static_assert(Tensor::shape_type::size() == 2, "Covariance requires a matrix of observations");
+    } else if constexpr (Tensor::error_checking() == error_checking::enabled) {
+        if (X.rank() != 2) {
+            throw std::invalid_argument("Covariance requires a matrix of observations");
+        }
+    }
+    const std::size_t rows = X.shape()[0];
+    const std::size_t variables = X.shape()[1];
+    const std::size_t grain = std::max<std::size_t>(64, (std::size_t{1} << 14) / std::max<std::size_t>(1, variables));
+    return parallel_reduce(
+        0, rows, grain, moment_accumulator<scalar_type>(variables),
+        [&](std::size_t first, std::size_t last) {
+            moment_accumulator<scalar_type> partial(variables);
+            const std::size_t count = last - first;
+            std::vector<scalar_type> block(count * variables);
+            for (std::size_t j = 0; j < variables; ++j) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    block[i + j * count] = X(first + i, j);
+                }
+            }
+            partial.add_block(block, count);
+            return partial;
+        },
+        [](moment_accumulator<scalar_type> a, const moment_accumulator<scalar_type> &b) {
+            a.merge(b);
+            return a;
+        });
+}
+
+} // namespace detail
+
+/**
+ * @brief Computes the covariance matrix of the rows of a tensor.
+ * @param X A tensor of shape {N, D} holding N observations of D variables, one per row.
+ * @param ddof The delta degrees of freedom: the scatter is divided by N - ddof.
+ * @return The D×D covariance matrix.
+ * @throws std::invalid_argument if N <= ddof.
+ */
+template <host_tensor Tensor> auto covariance(const Tensor &X, std::size_t ddof = 1) {
+    return detail::accumulate_rows(X).covariance(ddof);
+}
+
+/**
+ * @brief Computes the correlation matrix of the rows of a tensor.
+ * @param X A tensor of shape {N, D} holding N observations of D variables, one per row.
+ * @return The D×D matrix of Pearson correlation coefficients.
+ * @throws std::invalid_argument if N < 2.
+ */
+template <host_tensor Tensor> auto correlation(const Tensor &X) { return detail::accumulate_rows(X).correlation(); }
+
+/**
+ * @brief Mean and variance along an axis.
+ */
+template <typename Mean, typename Variance, error_checking ErrorChecking> struct moments_result {
+    tensor<Mean, dynamic, dynamic, ErrorChecking> mean;
+    tensor<Variance, dynamic, dynamic, ErrorChecking> variance;
+};
+
+/**
+ * @brief Computes the mean and variance of every line of a tensor along an axis in a single pass.
+ * @param t The tensor.
+ * @param axis The axis along which to reduce.
+ * @param ddof The delta degrees of freedom: the variance divides by the extent along axis minus ddof.
+ * @return Column-major tensors of the mean and variance with the shape of t except for an extent of 1 along axis.
+ * Variances of quantities have the squared unit.
+ * @throws std::invalid_argument if the axis is out of range (when error checking is enabled).
+ * @throws std::invalid_argument if the extent along axis is not greater than ddof.
+ */
+template <host_tensor Tensor> auto moments(const Tensor &t, std::size_t axis = 0, std::size_t ddof = 0) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    using variance_type = decltype(std::declval<value_type>() * std::declval<value_type>());
+    using scalar_type = blas_type_t<value_type>;
+    static_assert(floating_point<scalar_type>, "Moments require floating-point elements");
+    constexpr auto checking = Tensor::error_checking();
+    std::vector<std::size_t> shape(t.shape().begin(), t.shape().end());
+    detail::check_axis<checking>(axis, shape.size());
+    const std::size_t length = shape[axis];
+    if (length <= ddof) {
+        throw std::invalid_argument("Moments require more elements along the axis than ddof");
+    }
+    shape[axis] = 1;
+    moments_result<value_type, variance_type, checking> result{
+        tensor<value_type, dynamic, dynamic, checking>(shape), tensor<variance_type, dynamic, dynamic, checking>(shape)};
+    auto *mean = result.mean.data();
+    auto *variance = result.variance.data();
+    detail::for_each_axis_line<false>(t, axis, [&](std::vector<value_type> &line, std::size_t index) {
+        value_type m{};
+        variance_type m2{};
+        for (std::size_t k = 0; k < length; ++k) {
+            const value_type delta = line[k] - m;
+            m += delta / static_cast<scalar_type>(k + 1);
+            m2 += delta * (line[k] - m);
+        }
+        mean[index] = m;
+        variance[index] = m2 / static_cast<scalar_type>(length - ddof);
+    });
+    return result;
+}
+
+namespace detail {
+
+/**
+ * @brief Reduces the elements of a tensor in parallel, visiting them as strided runs.
+ *
+ * A contiguous tensor is visited as runs of adjacent elements; any other tensor as its lines along
+ * the first axis. Each chunk of work starts from a copy of init, calls run(accumulator, base, stride,
+ * count) for its runs, and the chunk results are combined with combine.
+ */
+template <typename Tensor, typename R, typename Run, typename Combine>
+auto reduce_runs(const Tensor &t, R init, Run run, Combine combine) -> R {
+    constexpr std::size_t grain = std::size_t{1} << 14;
+    const auto *data = t.data();
+    if (t.is_contiguous()) {
+        return parallel_reduce(
+            0, t.size(), grain, init,
+            [&](std::size_t first, std::size_t last) {
+                R partial = init;
+                run(partial, data + first, std::size_t{1}, last - first);
+                return partial;
+            },
+            combine);
+    }
+    const auto offsets = make_axis_offsets(t.shape(), t.strides(), 0);
+    const std::size_t inner = offsets.inner.size();
+    const std::size_t length = t.shape()[0];
+    return parallel_reduce(
+        0, inner * offsets.outer.size(), std::max<std::size_t>(1, grain / std::max<std::size_t>(1, length)), init,
+        [&](std::size_t first, std::size_t last) {
+            R partial = init;
+            for (std::size_t line = first; line < last; ++line) {
+                run(partial, data + offsets.inner[line % inner] + offsets.outer[line / inner], offsets.stride, length);
+            }
+            return partial;
+        },
+        combine);
+}
+
+} // namespace detail
+
+/**
+ * @brief Result of histogram: the count of every bin and the bin edges.
+ */
+template <typename Edge, error_checking ErrorChecking> struct histogram_result {
+    tensor<std::size_t, dynamic, dynamic, ErrorChecking> counts; ///< Shape {bins}.
+    tensor<Edge, dynamic, dynamic, ErrorChecking> edges;         ///< Shape {bins + 1}, ascending.
+};
+
+/**
+ * @brief Counts the elements of a tensor into equal-width bins over a range.
+ *
+ * Bin i holds the elements in [edges(i), edges(i + 1)), except that the last bin also holds elements
+ * equal to high. Elements outside [low, high] and NaNs are not counted.
+ *
+ * @param t The tensor of arithmetic elements.
+ * @param bins The number of bins.
+ * @param low The lower edge of the first bin.
+ * @param high The upper edge of the last bin.
+ * @return The counts and edges of the bins.
+ * @throws std::invalid_argument if bins is zero or low >= high (when error checking is enabled).
+ */
+template <host_tensor Tensor>
+auto histogram(const Tensor &t, std::size_t bins, double low, double high) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    using edge_type = std::conditional_t<floating_point<value_type>, value_type, double>;
+    static_assert(arithmetic<value_type>, "Histograms require arithmetic elements");
+    constexpr auto checking = Tensor::error_checking();
+    if constexpr (checking == error_checking::enabled) {
+        if (bins == 0 || !(low < high)) {
+            throw std::invalid_argument("Histogram requires at least one bin and low < high");
+        }
+    }
+    const double scale = static_cast<double>(bins) / (high - low);
+    const std::size_t last_bin = bins - 1;
+    auto counts = detail::reduce_runs(
+        t, std::vector<std::size_t>(bins),
+        [&](std::vector<std::size_t> &partial, const value_type *base, std::size_t stride, std::size_t count) {
+            for (std::size_t k = 0; k < count; ++k) {
+                const auto x = static_cast<double>(base[k * stride]);
+                if (x >= low && x <= high) {
+                    ++partial[std::min(static_cast<std::size_t>((x - low) * scale), last_bin)];
+                }
+            }
+        },
+        [](std::vector<std::size_t> a, const std::vector<std::size_t> &b) {
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                a[i] += b[i];
+            }
+            return a;
+        });
+    std::vector<edge_type> edges(bins + 1);
+    for (std::size_t i = 0; i <= bins; ++i) {
+        edges[i] = static_cast<edge_type>(low + (high - low) * static_cast<double>(i) / static_cast<double>(bins));
+    }
+    return histogram_result<edge_type, checking>{
+        tensor<std::size_t, dynamic, dynamic, checking>(std::vector<std::size_t>{bins}, counts, layout::column_major),
+        tensor<edge_type, dynamic, dynamic, checking>(std::vector<std::size_t>{bins + 1}, edges)};
+}
+
+/**
+ * @brief Counts the elements of a tensor into equal-width bins spanning its smallest to largest element.
+ *
+ * The range is found in an extra parallel pass; NaNs are ignored. If all elements are equal, the
+ * range is widened by 0.5 on either side.
+ *
+ * @param t The tensor of arithmetic elements.
+ * @param bins The number of bins.
+ * @return The counts and edges of the bins.
+ * @throws std::invalid_argument if bins is zero or t has no elements other than NaN (when error checking is
+ * enabled).
+ */
+template <host_tensor Tensor> auto histogram(const Tensor &t, std::size_t bins) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    static_assert(arithmetic<value_type>, "Histograms require arithmetic elements");
+    using range = std::array<double, 2>;
+    constexpr range empty{std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+    auto [low, high] = detail::reduce_runs(
+        t, empty,
+        [](range &partial, const value_type *base, std::size_t stride, std::size_t count) {
+            for (std::size_t k = 0; k < count; ++k) {
+                const auto x = static_cast<double>(base[k * stride]);
+                partial[0] = x < partial[0] ? x : partial[0];
+                partial[1] = x > partial[1] ? x : partial[1];
+            }
+        },
+        [](range a, const range &b) { return range{std::min(a[0], b[0]), std::max(a[1], b[1])}; });
+    if constexpr (Tensor::error_checking() == error_checking::enabled) {
+        if (!(low <= high)) {
+            throw std::invalid_argument("Histogram of a tensor without numbers");
+        }
+    }
+    if (!(low < high)) {
+        low -= 0.5;
+        high += 0.5;
+    }
+    return histogram(t, bins, low, high);
+}
+
+/**
+ * @brief Streaming estimator of a quantile using the P² algorithm.
+ *
+ * The estimator keeps five markers whose heights approximate the minimum, the p/2, p and (1 + p)/2
+ * quantiles and the maximum of the observations so far, and adjusts them with piecewise-parabolic
+ * interpolation as observations arrive. It uses constant memory and never stores the observations.
+ * Until five observations have been added, the exact quantile is returned.
+ *
+ * @tparam T The floating-point type of the estimate.
+ */
+template <floating_point T> class p2_quantile {
+  public:
+    /**
+     * @brief Constructs an estimator of the p quantile.
+     * @param p The probability of the quantile, in [0, 1].
+     * @throws std::invalid_argument if p is outside [0, 1].
+     */
+    explicit p2_quantile(double p)
+        : p_(p), increments_{0.0, p / 2, p, (1 + p) / 2, 1.0},
+          desired_{1.0, 1 + 2 * p, 1 + 4 * p, 3 + 2 * p, 5.0} {
+        if (!(p >= 0 && p <= 1)) {
+            throw std::invalid_argument("Quantile probability must be in [0, 1]");
+        }
+    }
+
+    /**
+     * @brief Adds an observation.
+     * @param x The observation. NaNs are ignored.
+     */
+    void add(T x) {
+        if (std::isnan(x)) {
+            return;
+        }
+        if (count_ < 5) {
+            heights_[count_++] = x;
+            if (count_ == 5) {
+                std::sort(heights_.begin(), heights_.end());
+            }
+            return;
+        }
+        ++count_;
+        std::size_t cell = 0;
+        if (x < heights_[0]) {
+            heights_[0] = x;
+        } else if (x >= heights_[4]) {
+            heights_[4] = x;
+            cell = 3;
+        } else {
+            while (x >= heights_[cell + 1]) {
+                ++cell;
+            }
+        }
+        for (std::size_t i = cell + 1; i < 5; ++i) {
+            positions_[i] += 1;
+        }
+        for (std::size_t i = 0; i < 5; ++i) {
+            desired_[i] += increments_[i];
+        }
+        for (std::size_t i = 1; i < 4; ++i) {
+            const double offset = desired_[i] - positions_[i];
+            if ((offset >= 1 && positions_[i + 1] - positions_[i] > 1) ||
+                (offset <= -1 && positions_[i - 1] - positions_[i] < -1)) {
+                adjust(i, offset > 0 ? 1 : -1);
+            }
+        }
+    }
+
+    /// @brief Returns the number of observations added.
+    [[nodiscard]] auto count() const -> std::size_t { return count_; }
+
+    /**
+     * @brief Returns the estimate of the quantile; the minimum and maximum (p = 0 and p = 1) are exact.
+     * @throws std::invalid_argument if no observations have been added.
+     */
+    [[nodiscard]] auto value() const -> T {
+        if (count_ == 0) {
+            throw std::invalid_argument("Quantile of no observations");
+        }
+        if (count_ >= 5) {
+            // The outer markers track the extremes exactly, which the middle marker cannot reach.
+            if (p_ == 0) {
+                return heights_[0];
+            }
+            if (p_ == 1) {
+                return heights_[4];
+            }
+            return heights_[2];
+        }
+        // Exact quantile of the first observations, interpolating between order statistics
+        std::array<T, 5> sorted = heights_;
+        std::sort(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(count_));
+        const double position = p_ * static_cast<double>(count_ - 1);
+        const auto below = static_cast<std::size_t>(position);
+        const std::size_t above = std::min(below + 1, count_ - 1);
+        const auto fraction = static_cast<T>(position - static_cast<double>(below));
+        return sorted[below] + fraction * (sorted[above] - sorted[below]);
+    }
+
+  private:
+    /// Moves marker i one position in direction d, updating its height.
+    void adjust(std::size_t i, int d) {
+        const double n_prev = positions_[i - 1];
+        const double n = positions_[i];
+        const double n_next = positions_[i + 1];
+        const double q_prev = heights_[i - 1];
+        const double q = heights_[i];
+        const double q_next = heights_[i + 1];
+        const double parabolic =
+            q + d / (n_next - n_prev) *
+                    ((n - n_prev + d) * (q_next - q) / (n_next - n) + (n_next - n - d) * (q - q_prev) / (n - n_prev));
+        if (q_prev < parabolic && parabolic < q_next) {
+            heights_[i] = static_cast<T>(parabolic);
+        } else {
+            const std::size_t j = d > 0 ? i + 1 : i - 1;
+            heights_[i] = static_cast<T>(q + d * (heights_[j] - q) / (positions_[j] - n));
+        }
+        positions_[i] += d;
+    }
+
+    double p_;
+    std::size_t count_ = 0;
+    std::array<T, 5> heights_{};
+    std::array<double, 5> positions_{1.0, 2.0, 3.0, 4.0, 5.0};
+    std::array<double, 5> increments_;
+    std::array<double, 5> desired_;
+};
+
+/**
+ * @brief Estimates quantiles of the elements of a tensor in a single pass without copying them.
+ * @param t The tensor of arithmetic elements.
+ * @param probabilities The probabilities of the quantiles, each in [0, 1].
+ * @return The estimates, in the order of probabilities.
+ * @throws std::invalid_argument if a probability is outside [0, 1] or t has no elements other than NaN.
+ */
+template <host_tensor Tensor> auto approx_quantiles(const Tensor &t, const std::vector<double> &probabilities) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    using estimate_type = std::conditional_t<floating_point<value_type>, value_type, double>;
+    static_assert(arithmetic<value_type>, "Quantiles require arithmetic elements");
+    std::vector<p2_quantile<estimate_type>> estimators;
+    estimators.reserve(probabilities.size());
+    for (const double p : probabilities) {
+        estimators.emplace_back(p);
+    }
+    for (const auto &element : t) {
+        for (auto &estimator : estimators) {
+            estimator.add(static_cast<estimate_type>(element));
+        }
+    }
+    std::vector<estimate_type> result;
+    result.reserve(estimators.size());
+    for (const auto &estimator : estimators) {
+        result.push_back(estimator.value());
+    }
+    return result;
+}
+
+/**
+ * @brief Estimates a quantile of the elements of a tensor in a single pass without copying them.
+ * @param t The tensor of arithmetic elements.
+ * @param p The probability of the quantile, in [0, 1]; 0.5 for the median.
+ * @return The estimate.
+ * @throws std::invalid_argument if p is outside [0, 1] or t has no elements other than NaN.
+ */
+template <host_tensor Tensor> auto approx_quantile(const Tensor &t, double p) {
+    return approx_quantiles(t, std::vector<double>{p}).front();
+}
+
+} // namespace squint
+
+#endif // SQUINT_TENSOR_STATISTICS_HPP
@@ -87,6 +87,17 @@ class tensor {
         std::conditional_t<fixed_shape<Strides>, std::integral_constant<std::monostate, std::monostate{}>, Strides>;
     using device_strides_storage = std::conditional_t<MemorySpace == memory_space::device, std::size_t *,
                                                       std::integral_constant<std::monostate, std::monostate{}>>;
+    /// @brief Type alias for layout storage: owning dynamic tensors remember their layout, since the strides of
+    /// shapes such as {1, 1} are the same in both layouts.
+    using layout_storage = std::conditional_t<dynamic_shape<Shape> && OwnershipType == ownership_type::owner, layout,
+                                              std::integral_constant<std::monostate, std::monostate{}>>;
+    static constexpr auto default_layout() -> layout_storage {
+        if constexpr (std::is_same_v<layout_storage, layout>) {
+            return layout::column_major;
+        } else {
+            return {};
+        }
+    }
     /// @brief Type alias for data storage, using std::array for fixed shapes and std::vector for dynamic shapes.
     using data_storage =
         std::conditional_t<OwnershipType == ownership_type::owner,
@@ -100,6 +111,7 @@ class tensor {
     NO_UNIQUE_ADDRESS strides_storage strides_; ///< Storage for tensor strides.
     NO_UNIQUE_ADDRESS device_shape_storage device_shape_;
     NO_UNIQUE_ADDRESS device_strides_storage device_strides_;
+    NO_UNIQUE_ADDRESS layout_storage layout_ = default_layout(); ///< Layout of owning dynamic tensors.
     data_storage data_;
 
   public:
@@ -498,6 +510,21 @@ class tensor {
         requires(dynamic_shape<Shape>);
     auto set_shape(const std::vector<size_t> &new_shape, layout l = layout::column_major)
         requires(dynamic_shape<Shape>);
+    // Growth methods
+    auto reserve(std::size_t extent) -> void
+        requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host);
+    [[nodiscard]] auto capacity() const -> std::size_t
+        requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host);
+    auto shrink_to_fit() -> void
+        requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host);
+    template <tensorial Slab>
+    auto append(const Slab &slab) -> tensor &
+        requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host);
+    template <tensorial Rows>
+    auto append_row(const Rows &rows) -> tensor &
+        requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host);
+    [[nodiscard]] auto growth_axis() const -> std::size_t
+        requires(dynamic_shape<Shape>);
     template <valid_index_permutation IndexPermutation>
     auto permute()
         requires fixed_shape<Shape>;
@@ -596,7 +623,8 @@ class tensor {
         const tensor<U, OtherShape, OtherStrides, OtherErrorChecking, OtherOwnershipType, MemorySpace> &other) const
         -> tensor<std::uint8_t, Shape, Strides, ErrorChecking, ownership_type::owner, MemorySpace>;
     // Unary operators
-    auto operator-() const -> tensor;
+    auto operator-() const & -> tensor;
+    auto operator-() && -> tensor;
     // scalar operations
     template <dimensionless_scalar U> auto operator*=(const U &s) -> tensor &;
     template <dimensionless_scalar U> auto operator/=(const U &s) -> tensor &;
@@ -679,6 +707,17 @@ class tensor {
                                                      std::index_sequence<Is...> /*unused*/) const -> std::size_t;
     [[nodiscard]] constexpr auto compute_offset(const index_type &indices) const -> std::size_t;
     constexpr auto check_bounds(const index_type &indices) const -> void;
+    [[nodiscard]] auto slab_extent(const std::vector<std::size_t> &slab_shape, std::size_t axis) const
+        -> std::size_t
+        requires dynamic_shape<Shape>;
+    template <tensorial Slab>
+    auto write_slab(const Slab &slab, std::size_t axis, std::size_t start, std::size_t extent) -> void
+        requires dynamic_shape<Shape>;
+    template <tensorial Slab>
+    [[nodiscard]] auto aliases(const Slab &slab) const -> bool
+        requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner);
+    auto pack() -> void
+        requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host);
     [[nodiscard]] auto compute_strides(layout l) const -> std::vector<std::size_t>
         requires dynamic_shape<Shape>
     {
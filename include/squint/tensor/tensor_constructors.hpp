@@ -115,6 +115,9 @@ template <typename T, typename Shape, typename Strides, error_checking ErrorChec
 tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::tensor(Shape shape, Strides strides)
     requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner)
     : shape_(std::move(shape)), strides_(std::move(strides)) {
+    if (strides_ != compute_strides(layout::column_major) && strides_ == compute_strides(layout::row_major)) {
+        layout_ = layout::row_major;
+    }
     data_.resize(std::accumulate(shape_.begin(), shape_.end(), 1ULL, std::multiplies<>()));
 }
 
@@ -128,7 +131,7 @@ template <typename T, typename Shape, typename Strides, error_checking ErrorChec
           memory_space MemorySpace>
 tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::tensor(Shape shape, layout l)
     requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner)
-    : shape_(std::move(shape)), strides_(compute_strides(l)) {
+    : shape_(std::move(shape)), strides_(compute_strides(l)), layout_(l) {
     data_.resize(std::accumulate(shape_.begin(), shape_.end(), 1ULL, std::multiplies<>()));
 }
 
@@ -145,7 +148,7 @@ template <typename T, typename Shape, typename Strides, error_checking ErrorChec
 tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::tensor(std::vector<size_t> shape,
                                                                              const std::vector<T> &elements, layout l)
     requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner)
-    : shape_(std::move(shape)), strides_(compute_strides(l)), data_(elements) {
+    : shape_(std::move(shape)), strides_(compute_strides(l)), layout_(l), data_(elements) {
     if constexpr (ErrorChecking == error_checking::enabled) {
         size_t total_size = std::accumulate(shape_.begin(), shape_.end(), 1ULL, std::multiplies<>());
         if (elements.size() != total_size) {
@@ -166,7 +169,7 @@ template <typename T, typename Shape, typename Strides, error_checking ErrorChec
 tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::tensor(std::vector<size_t> shape, const T &value,
                                                                              layout l)
     requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner)
-    : shape_(std::move(shape)), strides_(compute_strides(l)) {
+    : shape_(std::move(shape)), strides_(compute_strides(l)), layout_(l) {
     size_t total_size = std::accumulate(shape_.begin(), shape_.end(), 1ULL, std::multiplies<>());
     data_.resize(total_size, value);
 }
@@ -14,6 +14,7 @@
 #include "squint/core/memory.hpp"
 #include "squint/quantity/quantity_math.hpp"
 #include "squint/tensor/blas_backend.hpp"
+#include "squint/tensor/comparison.hpp"
 #include "squint/tensor/tensor.hpp"
 #include "squint/tensor/tensor_op_compatibility.hpp"
 #include "squint/util/math_utils.hpp"
@@ -21,7 +22,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <numeric>
 #include <ranges>
@@ -46,6 +49,8 @@ template <host_tensor T1, host_tensor T2> auto solve(T1 &A, T2 &B) {
     static_assert(dimensionless_scalar<typename T1::value_type>);
     using blas_type = std::remove_const_t<
         std::common_type_t<blas_type_t<typename T1::value_type>, blas_type_t<typename T2::value_type>>>;
+    static_assert(std::is_same_v<blas_type, float> || std::is_same_v<blas_type, double>,
+                  "LAPACK solvers require float or double elements");
 
     // Compute dimensions
     auto n = static_cast<BLAS_INT>(A.shape()[0]);
@@ -95,6 +100,8 @@ template <host_tensor T1, host_tensor T2> auto solve_general(T1 &A, T2 &B) {
     static_assert(dimensionless_scalar<typename T1::value_type>);
     using blas_type = std::remove_const_t<
         std::common_type_t<blas_type_t<typename T1::value_type>, blas_type_t<typename T2::value_type>>>;
+    static_assert(std::is_same_v<blas_type, float> || std::is_same_v<blas_type, double>,
+                  "LAPACK solvers require float or double elements");
 
     // Compute dimensions
     auto m = static_cast<BLAS_INT>(A.shape()[0]);
@@ -134,6 +141,131 @@ template <host_tensor T1, host_tensor T2> auto solve_general(T1 &A, T2 &B) {
     return info;
 }
 
+/**
+ * @brief Result of a mixed-precision solve.
+ */
+struct refinement_info {
+    std::size_t iterations; ///< Number of refinement steps taken in double precision.
+    bool fell_back;         ///< True if the system was re-solved with a double-precision factorization.
+};
+
+/**
+ * @brief Solves a square system of linear equations by mixed-precision iterative refinement.
+ *
+ * The matrix is factorized once in single precision and the solution is refined with residuals
+ * computed in double precision, which reaches double-precision accuracy at roughly the cost of a
+ * single-precision factorization for well-conditioned systems. If the single-precision factorization
+ * fails or the refinement does not converge within max_iterations steps, the system is solved again
+ * with a double-precision factorization.
+ *
+ * @param A The matrix of coefficients, left unchanged.
+ * @param B The right-hand side of the equations, overwritten with the solution.
+ * @param max_iterations The maximum number of refinement steps before falling back.
+ * @return The number of refinement steps and whether the double-precision fallback was used.
+ * @throws std::runtime_error if the system is singular or an error occurs during the solution.
+ */
+template <host_tensor T1, host_tensor T2>
+auto solve_mixed(const T1 &A, T2 &B, std::size_t max_iterations = 30) -> refinement_info {
+    blas_compatible(A, B);
+    solve_compatible(A, B);
+    static_assert(dimensionless_scalar<typename T1::value_type>);
+    static_assert(dimensionless_scalar<typename T2::value_type>);
+    static_assert(std::is_same_v<std::remove_const_t<blas_type_t<typename T1::value_type>>, double> &&
+                      std::is_same_v<std::remove_const_t<blas_type_t<typename T2::value_type>>, double>,
+                  "Mixed-precision solve requires double-precision tensors");
+
+    const std::size_t order = A.shape()[0];
+    const std::size_t columns = B.rank() == 1 ? 1 : B.shape()[1];
+    auto n = static_cast<BLAS_INT>(order);
+    auto nrhs = static_cast<BLAS_INT>(columns);
+
+    // Gather A and B into column-major buffers
+    std::vector<double> a(order * order);
+    std::vector<float> a_single(order * order);
+    double a_norm = 0;
+    for (std::size_t i = 0; i < order; ++i) {
+        double row_sum = 0;
+        for (std::size_t j = 0; j < order; ++j) {
+            const auto value = static_cast<double>(A(i, j));
+            a[i + j * order] = value;
+            a_single[i + j * order] = static_cast<float>(value);
+            row_sum += std::abs(value);
+        }
+        a_norm = std::max(a_norm, row_sum);
+    }
+    std::vector<double> b;
+    b.reserve(order * columns);
+    for (const auto &element : B) {
+        b.push_back(static_cast<double>(element));
+    }
+
+    std::vector<double> x(order * columns);
+    std::vector<double> r(order * columns);
+    std::vector<float> correction(order * columns);
+    std::vector<BLAS_INT> ipiv(order);
+    const double tolerance = a_norm * std::numeric_limits<double>::epsilon() * std::sqrt(static_cast<double>(order));
+
+    // A residual is small enough when it is within rounding of the solution in every column
+    auto converged = [&]() {
+        for (std::size_t k = 0; k < columns; ++k) {
+            double x_max = 0;
+            double r_max = 0;
+            for (std::size_t i = 0; i < order; ++i) {
+                x_max = std::max(x_max, std::abs(x[i + k * order]));
+                r_max = std::max(r_max, std::abs(r[i + k * order]));
+            }
+            if (!std::isfinite(r_max) || r_max > x_max * tolerance) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    refinement_info result{0, true};
+    // NOLINTBEGIN
+    int info = LAPACKE_sgetrf(LAPACK_COL_MAJOR, n, n, a_single.data(), n, ipiv.data());
+    if (info == 0) {
+        std::transform(b.begin(), b.end(), correction.begin(), [](double v) { return static_cast<float>(v); });
+        info = LAPACKE_sgetrs(LAPACK_COL_MAJOR, 'N', n, nrhs, a_single.data(), n, ipiv.data(), correction.data(), n);
+        std::copy(correction.begin(), correction.end(), x.begin());
+        while (info == 0) {
+            // r = b - A x in double precision
+            r = b;
+            cblas_dgemm(CBLAS_ORDER::CblasColMajor, CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasNoTrans, n,
+                        nrhs, n, -1.0, a.data(), n, x.data(), n, 1.0, r.data(), n);
+            if (converged()) {
+                result.fell_back = false;
+                break;
+            }
+            if (result.iterations == max_iterations) {
+                break;
+            }
+            std::transform(r.begin(), r.end(), correction.begin(), [](double v) { return static_cast<float>(v); });
+            info =
+                LAPACKE_sgetrs(LAPACK_COL_MAJOR, 'N', n, nrhs, a_single.data(), n, ipiv.data(), correction.data(), n);
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                x[i] += static_cast<double>(correction[i]);
+            }
+            ++result.iterations;
+        }
+    }
+    if (result.fell_back) {
+        x = b;
+        info = LAPACKE_dgesv(LAPACK_COL_MAJOR, n, nrhs, a.data(), n, ipiv.data(), x.data(), n);
+        if (info != 0) {
+            throw std::runtime_error("LAPACKE_gesv error code: " + std::to_string(info));
+        }
+    }
+    // NOLINTEND
+
+    // Scatter the solution back into B
+    std::size_t index = 0;
+    for (auto &element : B) {
+        element = static_cast<std::remove_reference_t<decltype(element)>>(x[index++]);
+    }
+    return result;
+}
+
 #ifdef SQUINT_BLAS_BACKEND_NONE
 /**
  * @brief Computes the inverse of a square matrix.
@@ -221,6 +353,8 @@ template <host_tensor T> auto inv(const T &A) {
     inversion_compatible(A);
     static_assert(dimensionless_scalar<typename T::value_type>);
     using blas_type = blas_type_t<std::remove_const_t<typename T::value_type>>;
+    static_assert(std::is_same_v<blas_type, float> || std::is_same_v<blas_type, double>,
+                  "LAPACK inversion requires float or double elements");
     using result_type =
         tensor<std::remove_const_t<typename T::value_type>, typename T::shape_type, typename T::strides_type,
                T::error_checking(), ownership_type::owner, memory_space::host>;
@@ -280,6 +414,135 @@ template <host_tensor T> auto inv(const T &A) {
 }
 #endif
 
+/**
+ * @brief Which part of a symmetric product is written.
+ */
+enum class fill_mode : std::uint8_t {
+    upper, ///< Only the upper triangle; the strictly lower triangle is left zero.
+    full,  ///< Both triangles.
+};
+
+namespace detail {
+
+/**
+ * @brief Computes A Aᵀ or Aᵀ A into a column-major square matrix with a symmetric rank-k update.
+ *
+ * SYRK computes only the upper triangle, half the work of the equivalent GEMM; the lower triangle
+ * is mirrored from it when requested. Element types other than float and double use a generic loop.
+ *
+ * @param a The matrix A, of rank 1 or 2, row-major or column-major.
+ * @param transpose_first True for Aᵀ A, false for A Aᵀ.
+ * @param result A column-major square matrix of the size of the product.
+ * @param fill Whether to mirror the upper triangle into the lower one.
+ */
+template <host_tensor Tensor, host_tensor Result>
+void symmetric_product(const Tensor &a, bool transpose_first, Result &result, fill_mode fill) {
+    check_blas_layout(a);
+    using blas_type = std::remove_const_t<blas_type_t<typename Tensor::value_type>>;
+    const auto rows = static_cast<BLAS_INT>(a.shape()[0]);
+    const auto cols = static_cast<BLAS_INT>(a.rank() == 1 ? 1 : a.shape()[1]);
+    // The column-major matrix M seen by BLAS is A when op is NoTrans and Aᵀ otherwise.
+    CBLAS_TRANSPOSE op = (a.strides()[0] == 1) ? CBLAS_TRANSPOSE::CblasNoTrans : CBLAS_TRANSPOSE::CblasTrans;
+    BLAS_INT lda = compute_leading_dimension_blas(op, a);
+    const bool memory_transposed = op == CBLAS_TRANSPOSE::CblasTrans;
+    CBLAS_TRANSPOSE trans =
+        (transpose_first != memory_transposed) ? CBLAS_TRANSPOSE::CblasTrans : CBLAS_TRANSPOSE::CblasNoTrans;
+    const BLAS_INT n = transpose_first ? cols : rows;
+    const BLAS_INT k = transpose_first ? rows : cols;
+    auto *c = reinterpret_cast<blas_type *>(result.data());
+    const auto *m = reinterpret_cast<const blas_type *>(a.data());
+    // NOLINTBEGIN
+    if constexpr (std::is_same_v<blas_type, float>) {
+        cblas_ssyrk(CBLAS_ORDER::CblasColMajor, CBLAS_UPLO::CblasUpper, trans, n, k, 1.0F, m, lda, 0.0F, c, n);
+    } else if constexpr (std::is_same_v<blas_type, double>) {
+        cblas_dsyrk(CBLAS_ORDER::CblasColMajor, CBLAS_UPLO::CblasUpper, trans, n, k, 1.0, m, lda, 0.0, c, n);
+    } else {
+        // No SYRK for this element type (long double, complex, dual numbers): form the upper triangle directly.
+        const bool columns = trans == CBLAS_TRANSPOSE::CblasTrans;
+        for (BLAS_INT j = 0; j < n; ++j) {
+            for (BLAS_INT i = 0; i <= j; ++i) {
+                blas_type sum{};
+                for (BLAS_INT l = 0; l < k; ++l) {
+                    sum += columns ? m[i * lda + l] * m[j * lda + l] : m[l * lda + i] * m[l * lda + j];
+                }
+                c[j * n + i] = sum;
+            }
+        }
+    }
+    // NOLINTEND
+    const auto size = static_cast<std::size_t>(n);
+    for (std::size_t j = 0; j < size; ++j) {
+        for (std::size_t i = j + 1; i < size; ++i) {
+            c[j * size + i] = fill == fill_mode::full ? c[i * size + j] : blas_type{};
+        }
+    }
+}
+
+/**
+ * @brief Allocates the column-major result of a symmetric product of the given order.
+ */
+template <host_tensor Tensor, std::size_t FixedOrder> auto symmetric_product_result(std::size_t order) {
+    using value_type = std::remove_const_t<typename Tensor::value_type>;
+    using result_value_type = decltype(std::declval<value_type>() * std::declval<value_type>());
+    if constexpr (fixed_tensor<Tensor>) {
+        using shape_type = shape<FixedOrder, FixedOrder>;
+        return tensor<result_value_type, shape_type, strides::column_major<shape_type>, Tensor::error_checking()>{};
+    } else {
+        return tensor<result_value_type, dynamic, dynamic, Tensor::error_checking()>({order, order});
+    }
+}
+
+/// @brief Returns the number of columns of a fixed matrix or vector shape.
+template <typename Tensor> constexpr auto fixed_columns() -> std::size_t {
+    if constexpr (fixed_tensor<Tensor>) {
+        constexpr auto dims = make_array(typename Tensor::shape_type{});
+        return dims.size() > 1 ? dims[1] : 1;
+    } else {
+        return 0;
+    }
+}
+
+/// @brief Returns the number of rows of a fixed matrix or vector shape.
+template <typename Tensor> constexpr auto fixed_rows() -> std::size_t {
+    if constexpr (fixed_tensor<Tensor>) {
+        return make_array(typename Tensor::shape_type{})[0];
+    } else {
+        return 0;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Computes the Gram matrix Aᵀ A of the columns of a matrix.
+ *
+ * The product is computed with SYRK, which evaluates one triangle of the symmetric result in half
+ * the flops of a general matrix product.
+ *
+ * @param A The matrix, row-major or column-major; a vector is treated as a single column.
+ * @param fill Whether to write both triangles or only the upper one.
+ * @return A column-major square matrix, fixed-size if A is.
+ */
+template <host_tensor T> auto gram(const T &A, fill_mode fill = fill_mode::upper) {
+    const std::size_t cols = A.rank() == 1 ? 1 : A.shape()[1];
+    auto result = detail::symmetric_product_result<T, detail::fixed_columns<T>()>(cols);
+    detail::symmetric_product(A, true, result, fill);
+    return result;
+}
+
+/**
+ * @brief Computes the Gram matrix A Aᵀ of the rows of a matrix.
+ * @param A The matrix, row-major or column-major; a vector is treated as a single column.
+ * @param fill Whether to write both triangles or only the upper one.
+ * @return A column-major square matrix, fixed-size if A is.
+ */
+template <host_tensor T> auto outer_gram(const T &A, fill_mode fill = fill_mode::upper) {
+    const std::size_t rows = A.shape()[0];
+    auto result = detail::symmetric_product_result<T, detail::fixed_rows<T>()>(rows);
+    detail::symmetric_product(A, false, result, fill);
+    return result;
+}
+
 /**
  * @brief Computes the Moore-Penrose pseudoinverse of a matrix.
  *
@@ -302,11 +565,11 @@ template <fixed_tensor T> auto pinv(const T &A) {
 
     if constexpr (m >= n) {
         // Overdetermined or square system: pinv(A) = (A^T * A)^-1 * A^T
-        auto AtA = A.transpose() * A;
+        auto AtA = gram(A, fill_mode::full);
         return inv(AtA) * A.transpose();
     } else {
         // Underdetermined system: pinv(A) = A^T * (A * A^T)^-1
-        auto AAt = A * A.transpose();
+        auto AAt = outer_gram(A, fill_mode::full);
         return A.transpose() * inv(AAt);
     }
 }
@@ -318,11 +581,11 @@ template <dynamic_tensor T> auto pinv(const T &A) {
 
     if (m >= n) {
         // Overdetermined or square system: pinv(A) = (A^T * A)^-1 * A^T
-        auto AtA = A.transpose() * A;
+        auto AtA = gram(A, fill_mode::full);
         return inv(AtA) * A.transpose();
     }
     // Underdetermined system: pinv(A) = A^T * (A * A^T)^-1
-    auto AAt = A * A.transpose();
+    auto AAt = outer_gram(A, fill_mode::full);
     return A.transpose() * inv(AAt);
 }
 
@@ -602,13 +865,8 @@ auto approx_equal(
         }
     }
 
-    for (size_t i = 0; i < a.size(); ++i) {
-        if (!squint::approx_equal(a.data()[i], b.data()[i], tol)) {
-            return false;
-        }
-    }
-
-    return true;
+    auto differs = [tol](const auto &x, const auto &y) { return !squint::approx_equal(x, y, tol); };
+    return detail::count_matches(a, b, differs, 1) == 0;
 }
 
 /**
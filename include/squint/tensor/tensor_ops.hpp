@@ -17,7 +17,10 @@
 #include "squint/tensor/tensor_math.hpp"
 #include "squint/tensor/tensor_op_compatibility.hpp"
 
+#include <array>
 #include <cstddef>
+#include <limits>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -30,8 +33,55 @@
 
 namespace squint {
 
+namespace detail {
+
+/**
+ * @brief Checks whether the second operand of a product is a transposed view of the first.
+ *
+ * This matches X.transpose() * X and X * X.transpose(), whose products are symmetric.
+ */
+template <tensorial Tensor1, tensorial Tensor2> auto is_transpose_pair(const Tensor1 &t1, const Tensor2 &t2) -> bool {
+    if constexpr (!std::is_same_v<std::remove_const_t<typename Tensor1::value_type>,
+                                  std::remove_const_t<typename Tensor2::value_type>>) {
+        return false;
+    } else {
+        return t1.rank() == 2 && t2.rank() == 2 && t1.data() == t2.data() && t1.shape()[0] == t2.shape()[1] &&
+               t1.shape()[1] == t2.shape()[0] && t1.strides()[0] == t2.strides()[1] &&
+               t1.strides()[1] == t2.strides()[0];
+    }
+}
+
+/**
+ * @brief Column-major C = op(A) op(B) for element types without a BLAS routine.
+ *
+ * Used for long double, complex and other scalars that the float/double GEMM cannot handle, so
+ * that their products are computed rather than left as zeros.
+ */
+template <typename T>
+void generic_gemm(CBLAS_TRANSPOSE op_a, CBLAS_TRANSPOSE op_b, BLAS_INT m, BLAS_INT n, BLAS_INT k, const T *a,
+                  BLAS_INT lda, const T *b, BLAS_INT ldb, T *c, BLAS_INT ldc) {
+    const bool trans_a = op_a != CBLAS_TRANSPOSE::CblasNoTrans;
+    const bool trans_b = op_b != CBLAS_TRANSPOSE::CblasNoTrans;
+    for (BLAS_INT j = 0; j < n; ++j) {
+        for (BLAS_INT i = 0; i < m; ++i) {
+            T sum{};
+            for (BLAS_INT l = 0; l < k; ++l) {
+                sum += a[trans_a ? i * lda + l : l * lda + i] * b[trans_b ? l * ldb + j : j * ldb + l];
+            }
+            c[j * ldc + i] = sum;
+        }
+    }
+}
+
+} // namespace detail
+
 /**
  * @brief General matrix-matrix multiplication operator.
+ *
+ * Products of a host matrix with its own transpose (X.transpose() * X or X * X.transpose()) are
+ * detected and computed with SYRK, as with gram and outer_gram. Float and double elements use
+ * BLAS; other host element types such as complex numbers fall back to a generic loop.
+ *
  * @param t1 The first tensor to multiply.
  * @param t2 The second tensor to multiply.
  * @return A new tensor containing the result of the multiplication.
@@ -70,6 +120,10 @@ template <tensorial Tensor1, tensorial Tensor2> auto operator*(const Tensor1 &t1
             using result_type = tensor<result_value_type, result_shape_type, strides_type, result_error_checking::value,
                                        ownership_type::owner, memory_space::host>;
             result_type result{};
+            if (detail::is_transpose_pair(t1, t2)) {
+                detail::symmetric_product(t1, false, result, fill_mode::full);
+                return result;
+            }
             if constexpr (std::is_same_v<blas_type, float>) {
                 // NOLINTBEGIN
                 cblas_sgemm(CBLAS_ORDER::CblasColMajor, op_a, op_b, m, n, k, alpha,
@@ -93,10 +147,19 @@ template <tensorial Tensor1, tensorial Tensor2> auto operator*(const Tensor1 &t1
                                 const_cast<std::remove_const_t<typename result_type::value_type> *>(result.data())),
                             ldc);
                 // NOLINTEND
+            } else {
+                using result_blas_type = std::remove_const_t<blas_type>;
+                // NOLINTBEGIN
+                detail::generic_gemm(op_a, op_b, m, n, k, reinterpret_cast<const result_blas_type *>(t1.data()), lda,
+                                     reinterpret_cast<const result_blas_type *>(t2.data()), ldb,
+                                     reinterpret_cast<result_blas_type *>(result.data()), ldc);
+                // NOLINTEND
             }
             return std::move(result);
         } else {
 #ifdef SQUINT_USE_CUDA
+            static_assert(std::is_same_v<blas_type, float> || std::is_same_v<blas_type, double>,
+                          "Device matrix multiplication requires float or double elements");
             // NOLINTBEGIN
             using strides_type = strides::column_major<result_shape_type>;
             using result_type = tensor<result_value_type, result_shape_type, strides_type, result_error_checking::value,
@@ -125,6 +188,10 @@ template <tensorial Tensor1, tensorial Tensor2> auto operator*(const Tensor1 &t1
             using result_type = tensor<result_value_type, result_shape_type, strides_type, result_error_checking::value,
                                        ownership_type::owner, memory_space::host>;
             result_type result({static_cast<std::size_t>(m), static_cast<std::size_t>(n)}, layout::column_major);
+            if (detail::is_transpose_pair(t1, t2)) {
+                detail::symmetric_product(t1, false, result, fill_mode::full);
+                return result;
+            }
             if constexpr (std::is_same_v<blas_type, float>) {
                 // NOLINTBEGIN
                 cblas_sgemm(CBLAS_ORDER::CblasColMajor, op_a, op_b, m, n, k, alpha,
@@ -151,10 +218,19 @@ template <tensorial Tensor1, tensorial Tensor2> auto operator*(const Tensor1 &t1
                                 const_cast<std::remove_const_t<typename result_type::value_type> *>(result.data())),
                             ldc);
                 // NOLINTEND
+            } else {
+                using result_blas_type = std::remove_const_t<blas_type>;
+                // NOLINTBEGIN
+                detail::generic_gemm(op_a, op_b, m, n, k, reinterpret_cast<const result_blas_type *>(t1.data()), lda,
+                                     reinterpret_cast<const result_blas_type *>(t2.data()), ldb,
+                                     reinterpret_cast<result_blas_type *>(result.data()), ldc);
+                // NOLINTEND
             }
             return std::move(result);
         } else {
 #ifdef SQUINT_USE_CUDA
+            static_assert(std::is_same_v<blas_type, float> || std::is_same_v<blas_type, double>,
+                          "Device matrix multiplication requires float or double elements");
             // NOLINTBEGIN
             using strides_type = std::vector<std::size_t>;
             using result_type = tensor<result_value_type, result_shape_type, strides_type, result_error_checking::value,
@@ -180,6 +256,119 @@ template <tensorial Tensor1, tensorial Tensor2> auto operator*(const Tensor1 &t1
     }
 }
 
+namespace detail {
+
+/**
+ * @brief Finds the cheapest parenthesization of a chain of N matrix products.
+ *
+ * Factor i has dims[i] rows and dims[i + 1] columns. This is the classic O(N³) dynamic program
+ * over the cost m·k·n of each product; it is constexpr so that fixed-size chains are ordered at
+ * compile time.
+ *
+ * @param dims The N + 1 chain dimensions.
+ * @return split[i * N + j], the last factor of the left operand in the best order for factors i..j.
+ */
+template <std::size_t N>
+constexpr auto chain_splits(const std::array<std::size_t, N + 1> &dims) -> std::array<std::size_t, N * N> {
+    std::array<std::size_t, N * N> cost{};
+    std::array<std::size_t, N * N> split{};
+    for (std::size_t length = 2; length <= N; ++length) {
+        for (std::size_t i = 0; i + length <= N; ++i) {
+            const std::size_t j = i + length - 1;
+            cost[i * N + j] = std::numeric_limits<std::size_t>::max();
+            for (std::size_t k = i; k < j; ++k) {
+                const std::size_t c = cost[i * N + k] + cost[(k + 1) * N + j] + dims[i] * dims[k + 1] * dims[j + 1];
+                if (c < cost[i * N + j]) {
+                    cost[i * N + j] = c;
+                    split[i * N + j] = k;
+                }
+            }
+        }
+    }
+    return split;
+}
+
+/**
+ * @brief Evaluates factors I..J of a chain in the order given by a compile-time split table.
+ * @return A reference to the factor when I == J, otherwise the product.
+ */
+template <std::size_t I, std::size_t J, auto Split, typename Tuple>
+auto fixed_chain_product(const Tuple &factors) -> decltype(auto) {
+    if constexpr (I == J) {
+        return std::get<I>(factors);
+    } else {
+        constexpr std::size_t N = std::tuple_size_v<Tuple>;
+        constexpr std::size_t K = Split[I * N + J];
+        return fixed_chain_product<I, K, Split>(factors) * fixed_chain_product<K + 1, J, Split>(factors);
+    }
+}
+
+template <std::size_t I, std::size_t J, typename Tuple, std::size_t N>
+auto chain_product(const Tuple &factors, const std::array<std::size_t, N> &split) -> decltype(auto);
+
+/**
+ * @brief Selects the runtime split of factors I..J, trying candidate K and the ones after it.
+ */
+template <std::size_t I, std::size_t J, std::size_t K, typename Tuple, std::size_t N>
+auto chain_split_product(const Tuple &factors, const std::array<std::size_t, N> &split) {
+    constexpr std::size_t count = std::tuple_size_v<Tuple>;
+    if constexpr (K + 1 == J) {
+        return chain_product<I, K>(factors, split) * chain_product<K + 1, J>(factors, split);
+    } else {
+        if (split[I * count + J] == K) {
+            return chain_product<I, K>(factors, split) * chain_product<K + 1, J>(factors, split);
+        }
+        return chain_split_product<I, J, K + 1>(factors, split);
+    }
+}
+
+/**
+ * @brief Evaluates factors I..J of a chain in the order given by a runtime split table.
+ * @return A reference to the factor when I == J, otherwise the product.
+ */
+template <std::size_t I, std::size_t J, typename Tuple, std::size_t N>
+auto chain_product(const Tuple &factors, const std::array<std::size_t, N> &split) -> decltype(auto) {
+    if constexpr (I == J) {
+        return std::get<I>(factors);
+    } else {
+        return chain_split_product<I, J, I>(factors, split);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Multiplies a chain of matrices and vectors in the cheapest order.
+ *
+ * The result equals t_0 * t_1 * ... * t_{N-1}, but the products are grouped to minimize the number
+ * of scalar multiplications, e.g. A * (B * v) instead of (A * B) * v. The order is chosen at compile
+ * time when every factor has a fixed shape and at runtime otherwise.
+ *
+ * @param factors The factors, each a matrix or (column) vector.
+ * @return The product of all factors.
+ */
+template <tensorial... Tensors>
+    requires(sizeof...(Tensors) >= 2)
+auto multi_dot(const Tensors &...factors) {
+    constexpr std::size_t N = sizeof...(Tensors);
+    const auto operands = std::forward_as_tuple(factors...);
+    if constexpr ((fixed_tensor<Tensors> && ...)) {
+        constexpr std::array<std::size_t, N + 1> dims = [] {
+            using first = std::tuple_element_t<0, std::tuple<Tensors...>>;
+            return std::array<std::size_t, N + 1>{detail::fixed_rows<first>(), detail::fixed_columns<Tensors>()...};
+        }();
+        constexpr auto split = detail::chain_splits<N>(dims);
+        return detail::fixed_chain_product<0, N - 1, split>(operands);
+    } else {
+        const auto &first = std::get<0>(operands);
+        const std::array<std::size_t, N + 1> dims{first.shape()[0],
+                                                  (factors.rank() == 1 ? std::size_t{1} : factors.shape()[1])...};
+        const auto split = detail::chain_splits<N>(dims);
+        return detail::chain_product<0, N - 1>(operands, split);
+    }
+}
+
+
 // NOLINTBEGIN
 /**
  * @brief General least squares or least norm solution operator.
@@ -40,6 +40,20 @@ inline auto all_less_than(const std::vector<size_t> &vec, size_t value) -> bool
     return std::ranges::all_of(vec, [value](size_t x) { return x < value; });
 }
 
+/**
+ * @brief Returns the number of elements in a slice of a shape perpendicular to an axis.
+ * @param shape The shape.
+ * @param axis The axis the slice is perpendicular to.
+ * @return The product of all extents except the one along the axis.
+ */
+inline auto slice_size(const std::vector<size_t> &shape, size_t axis) -> size_t {
+    size_t result = 1;
+    for (size_t i = 0; i < shape.size(); ++i) {
+        result *= i == axis ? 1 : shape[i];
+    }
+    return result;
+}
+
 /**
  * @brief Applies an index permutation to a std::vector.
  * @param vec The vector to permute.
@@ -298,6 +312,9 @@ auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::set_s
 
     this->shape_ = new_shape;
     this->strides_ = compute_strides(l, new_shape);
+    if constexpr (OwnershipType == ownership_type::owner) {
+        this->layout_ = l;
+    }
     if constexpr (MemorySpace == memory_space::device && OwnershipType == ownership_type::reference) {
 #ifdef SQUINT_USE_CUDA
         // If the tensor is a device reference, we need to update the device shape and strides as well
@@ -459,6 +476,258 @@ auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::trans
     }
 }
 
+/**
+ * @brief Returns the axis along which a dynamic tensor grows.
+ *
+ * This is the axis with the outermost stride, i.e. the last axis for column-major tensors and the
+ * first axis for row-major tensors. Appending along this axis only adds elements at the end of the
+ * underlying storage. Owning tensors use the layout they were created with, which stays defined
+ * when both layouts have the same strides, as for a 1×1 matrix; views are classified by their strides.
+ *
+ * @return The growth axis.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::growth_axis() const -> std::size_t
+    requires(dynamic_shape<Shape>)
+{
+    if (shape_.empty()) {
+        return 0;
+    }
+    if constexpr (OwnershipType == ownership_type::owner) {
+        return layout_ == layout::row_major ? 0 : shape_.size() - 1;
+    } else {
+        return strides_ == compute_strides(layout::column_major) ? shape_.size() - 1 : 0;
+    }
+}
+
+/**
+ * @brief Reserves storage for a number of slices along the growth axis.
+ *
+ * Subsequent calls to append do not reallocate until the extent of the growth axis exceeds the
+ * reserved extent.
+ *
+ * @param extent The extent of the growth axis to reserve storage for.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::reserve(std::size_t extent) -> void
+    requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host)
+{
+    if (shape_.empty()) {
+        return;
+    }
+    data_.reserve(extent * slice_size(shape_, growth_axis()));
+}
+
+/**
+ * @brief Returns the extent of the growth axis the current storage can hold without reallocating.
+ * @return The capacity along the growth axis.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::capacity() const -> std::size_t
+    requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host)
+{
+    if (shape_.empty()) {
+        return 0;
+    }
+    const std::size_t axis = growth_axis();
+    const std::size_t slice = slice_size(shape_, axis);
+    return slice == 0 ? shape_[axis] : data_.capacity() / slice;
+}
+
+/**
+ * @brief Releases storage reserved beyond the current size of the tensor.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::shrink_to_fit() -> void
+    requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host)
+{
+    data_.shrink_to_fit();
+}
+
+/**
+ * @brief Appends a slab to the tensor along its growth axis.
+ *
+ * The slab either has the shape of the tensor with the growth axis removed, in which case a single
+ * slice is appended, or the full rank of the tensor with any extent along the growth axis. Existing
+ * elements are never moved apart, so growth is amortized O(1) per appended element. A slab that views
+ * this tensor is copied before the storage grows, and a tensor whose strides differ from those of its
+ * layout is first repacked into that layout.
+ *
+ * @param slab The slab to append.
+ * @return Reference to the grown tensor.
+ * @throws std::invalid_argument if the slab shape does not match the tensor (when error checking is enabled).
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+template <tensorial Slab>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::append(const Slab &slab) -> tensor &
+    requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host)
+{
+    if (aliases(slab)) {
+        return append(slab.copy());
+    }
+    pack();
+    const std::size_t axis = growth_axis();
+    const auto slab_shape = slab.shape();
+    const std::size_t extent = slab_extent(std::vector<std::size_t>(slab_shape.begin(), slab_shape.end()), axis);
+    const std::size_t start = shape_[axis];
+    shape_[axis] += extent;
+    data_.resize(std::accumulate(shape_.begin(), shape_.end(), 1ULL, std::multiplies<>()));
+    strides_ = compute_strides(layout_);
+    write_slab(slab, axis, start, extent);
+    return *this;
+}
+
+/**
+ * @brief Appends one or more rows to the tensor along its first axis.
+ *
+ * For row-major tensors this is the same as append. Column-major tensors store rows interleaved,
+ * so every existing column is moved to make room and the cost is O(size) per call; prefer
+ * appending columns to a column-major tensor, or using a row-major tensor, for streaming input.
+ *
+ * @param rows A single row, with the shape of the tensor with the first axis removed, or a tensor
+ *             of the full rank holding several rows.
+ * @return Reference to the grown tensor.
+ * @throws std::invalid_argument if the row shape does not match the tensor (when error checking is enabled).
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+template <tensorial Rows>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::append_row(const Rows &rows) -> tensor &
+    requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host)
+{
+    if (growth_axis() == 0) {
+        return append(rows);
+    }
+    if (aliases(rows)) {
+        return append_row(rows.copy());
+    }
+    pack();
+    const auto rows_shape = rows.shape();
+    const std::size_t extent = slab_extent(std::vector<std::size_t>(rows_shape.begin(), rows_shape.end()), 0);
+    const std::size_t old_rows = shape_[0];
+    const std::size_t new_rows = old_rows + extent;
+    const std::size_t columns = std::accumulate(shape_.begin() + 1, shape_.end(), 1ULL, std::multiplies<>());
+    data_.resize(new_rows * columns);
+    // Spread the columns out from the back so that no column is overwritten before it is moved.
+    for (std::size_t j = columns; j-- > 1;) {
+        auto first = data_.begin() + static_cast<std::ptrdiff_t>(j * old_rows);
+        std::move_backward(first, first + static_cast<std::ptrdiff_t>(old_rows),
+                           data_.begin() + static_cast<std::ptrdiff_t>(j * new_rows + old_rows));
+    }
+    shape_[0] = new_rows;
+    strides_ = compute_strides(layout::column_major);
+    write_slab(rows, 0, old_rows, extent);
+    return *this;
+}
+
+/**
+ * @brief Checks whether a slab views the storage of this tensor, which appending would invalidate.
+ * @param slab The slab to append.
+ * @return True if the first element of the slab lies in the storage of this tensor.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+template <tensorial Slab>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::aliases(const Slab &slab) const -> bool
+    requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner)
+{
+    if constexpr (std::is_same_v<std::remove_const_t<typename Slab::value_type>, T>) {
+        const std::less<const T *> before;
+        const T *first = slab.data();
+        return !before(first, data_.data()) && before(first, data_.data() + data_.size());
+    } else {
+        return false;
+    }
+}
+
+/**
+ * @brief Moves the elements into the strides of the layout of the tensor.
+ *
+ * An owning tensor constructed with explicit strides may store its elements in another order than
+ * its layout. Growth assumes the strides of the layout, so such a tensor is repacked first.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::pack() -> void
+    requires(dynamic_shape<Shape> && OwnershipType == ownership_type::owner && MemorySpace == memory_space::host)
+{
+    if (strides_ == compute_strides(layout_)) {
+        return;
+    }
+    tensor packed(shape_, layout_);
+    auto source = std::as_const(*this).begin();
+    for (auto &element : packed) {
+        element = *source++;
+    }
+    *this = std::move(packed);
+}
+
+/**
+ * @brief Returns the extent of a slab along an axis of the tensor.
+ * @param slab_shape The shape of the slab, either of full rank or with the axis removed.
+ * @param axis The axis the slab is appended along.
+ * @return The extent of the slab along the axis.
+ * @throws std::invalid_argument if the slab shape does not match the tensor (when error checking is enabled).
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::slab_extent(
+    const std::vector<std::size_t> &slab_shape, std::size_t axis) const -> std::size_t
+    requires dynamic_shape<Shape>
+{
+    const bool full_rank = slab_shape.size() == shape_.size();
+    if constexpr (ErrorChecking == error_checking::enabled) {
+        if (shape_.empty() || (!full_rank && slab_shape.size() + 1 != shape_.size())) {
+            throw std::invalid_argument("Slab rank does not match tensor rank");
+        }
+        for (std::size_t i = 0, j = 0; i < shape_.size(); ++i) {
+            if (i == axis && !full_rank) {
+                continue;
+            }
+            if (i != axis && slab_shape[j] != shape_[i]) {
+                throw std::invalid_argument("Slab shape does not match tensor shape");
+            }
+            ++j;
+        }
+    }
+    if (!full_rank) {
+        return std::accumulate(slab_shape.begin(), slab_shape.end(), 1ULL, std::multiplies<>()) == 0 ? 0 : 1;
+    }
+    return slab_shape[axis];
+}
+
+/**
+ * @brief Copies a slab into the elements of the tensor starting at an index along an axis.
+ * @param slab The slab to copy.
+ * @param axis The axis the slab was appended along.
+ * @param start The index along the axis of the first slice of the slab.
+ * @param extent The extent of the slab along the axis.
+ */
+template <typename T, typename Shape, typename Strides, error_checking ErrorChecking, ownership_type OwnershipType,
+          memory_space MemorySpace>
+template <tensorial Slab>
+auto tensor<T, Shape, Strides, ErrorChecking, OwnershipType, MemorySpace>::write_slab(const Slab &slab,
+                                                                                      std::size_t axis,
+                                                                                      std::size_t start,
+                                                                                      std::size_t extent) -> void
+    requires dynamic_shape<Shape>
+{
+    auto region_shape = shape_;
+    region_shape[axis] = extent;
+    tensor<T, std::vector<std::size_t>, std::vector<std::size_t>, ErrorChecking, ownership_type::reference,
+           MemorySpace>
+        region(data() + start * strides_[axis], region_shape, strides_);
+    auto slab_it = slab.begin();
+    for (auto &element : region) {
+        element = *slab_it++;
+    }
+}
+
 } // namespace squint
 
 #endif // SQUINT_TENSOR_TENSOR_SHAPE_MANIPULATIONS_HPP
\ No newline at end of file
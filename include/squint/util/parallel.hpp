@@ -0,0 +1,126 @@
+/**
+ * @file parallel.hpp
+ * @brief Minimal helpers for splitting loops across threads.
+ *
+ * This file provides parallel_for and parallel_reduce, which split an index range into
+ * contiguous chunks and run them on std::thread workers. The calling thread processes one of
+ * the chunks itself, and ranges that are too small to be worth splitting run inline. Exceptions
+ * thrown by a chunk are rethrown on the calling thread.
+ */
+
+#ifndef SQUINT_UTIL_PARALLEL_HPP
+#define SQUINT_UTIL_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace squint {
+
+/**
+ * @brief Returns the number of worker threads used by the parallel helpers.
+ * @return The number of hardware threads, or 1 if it cannot be determined.
+ */
+inline auto hardware_threads() -> std::size_t {
+    static const std::size_t count = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    return count;
+}
+
+/**
+ * @brief Returns the number of chunks a range is split into.
+ * @param count The number of indices in the range.
+ * @param grain The minimum number of indices per chunk.
+ * @return The number of chunks, at least 1.
+ */
+inline auto parallel_chunks(std::size_t count, std::size_t grain) -> std::size_t {
+    grain = std::max<std::size_t>(1, grain);
+    return std::max<std::size_t>(1, std::min(hardware_threads(), count / grain));
+}
+
+/**
+ * @brief Runs a function over contiguous chunks of an index range in parallel.
+ *
+ * @tparam F The callable type, invoked as f(chunk_begin, chunk_end).
+ * @param begin The first index of the range.
+ * @param end One past the last index of the range.
+ * @param grain The minimum number of indices per chunk.
+ * @param f The function to run on each chunk.
+ */
+template <typename F> void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, F &&f) {
+    if (end <= begin) {
+        return;
+    }
+    const std::size_t count = end - begin;
+    const std::size_t chunks = parallel_chunks(count, grain);
+    if (chunks == 1) {
+        f(begin, end);
+        return;
+    }
+    std::vector<std::exception_ptr> errors(chunks);
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    auto chunk_begin = [&](std::size_t c) { return begin + (count * c) / chunks; };
+    auto run = [&](std::size_t c) {
+        try {
+            f(chunk_begin(c), chunk_begin(c + 1));
+        } catch (...) {
+            errors[c] = std::current_exception();
+        }
+    };
+    for (std::size_t c = 1; c < chunks; ++c) {
+        workers.emplace_back(run, c);
+    }
+    run(0);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (const auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+/**
+ * @brief Reduces contiguous chunks of an index range in parallel.
+ *
+ * Each chunk is mapped to a partial result which are then combined in chunk order on the calling
+ * thread, so the result is deterministic for a given number of hardware threads.
+ *
+ * @tparam R The result type.
+ * @tparam Map The callable type, invoked as map(chunk_begin, chunk_end) -> R.
+ * @tparam Combine The callable type, invoked as combine(R, R) -> R.
+ * @param begin The first index of the range.
+ * @param end One past the last index of the range.
+ * @param grain The minimum number of indices per chunk.
+ * @param init The initial value of the reduction.
+ * @param map The function producing a partial result for each chunk.
+ * @param combine The function combining two partial results.
+ * @return The combined result.
+ */
+template <typename R, typename Map, typename Combine>
+auto parallel_reduce(std::size_t begin, std::size_t end, std::size_t grain, R init, Map &&map, Combine &&combine)
+    -> R {
+    if (end <= begin) {
+        return init;
+    }
+    const std::size_t count = end - begin;
+    const std::size_t chunks = parallel_chunks(count, grain);
+    std::vector<R> partials(chunks, init);
+    parallel_for(0, chunks, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t c = first; c < last; ++c) {
+            partials[c] = map(begin + (count * c) / chunks, begin + (count * (c + 1)) / chunks);
+        }
+    });
+    R result = init;
+    for (auto &partial : partials) {
+        result = combine(result, partial);
+    }
+    return result;
+}
+
+} // namespace squint
+
+#endif // SQUINT_UTIL_PARALLEL_HPP
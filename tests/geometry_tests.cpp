@@ -5,6 +5,9 @@
 #include "squint/quantity.hpp"
 #include "squint/tensor.hpp"
 
+#include <algorithm>
+#include <random>
+
 using namespace squint;
 using namespace squint::geometry;
 
@@ -119,4 +122,723 @@ TEST_CASE("Perspective Projection") {
         CHECK(result(3, 2) == doctest::Approx(-1.0F));
     }
 }
+
+TEST_CASE("Bounding volumes") {
+    auto box = aabb<float>{vec3_t<length>{{length(-1.0F), length(-2.0F), length(-3.0F)}},
+                           vec3_t<length>{{length(1.0F), length(2.0F), length(3.0F)}}};
+
+    SUBCASE("AABB queries") {
+        CHECK(box.contains(vec3_t<length>{{length(0.5F), length(-1.5F), length(2.0F)}}));
+        CHECK_FALSE(box.contains(vec3_t<length>{{length(1.5F), length(0.0F), length(0.0F)}}));
+        CHECK(box.center()(1).value() == doctest::Approx(0.0F));
+        CHECK(box.extents()(2).value() == doctest::Approx(3.0F));
+        auto other = aabb<float>{vec3_t<length>{{length(0.5F), length(1.0F), length(2.0F)}},
+                                 vec3_t<length>{{length(4.0F), length(4.0F), length(4.0F)}}};
+        CHECK(box.intersects(other));
+        other.min(0) = length(1.5F);
+        CHECK_FALSE(box.intersects(other));
+        box.expand(vec3_t<length>{{length(5.0F), length(0.0F), length(0.0F)}});
+        CHECK(box.max(0).value() == doctest::Approx(5.0F));
+    }
+
+    SUBCASE("Sphere queries") {
+        auto sphere = bounding_sphere<float>{vec3_t<length>{{length(0.0F), length(0.0F), length(0.0F)}}, length(2.0F)};
+        CHECK(sphere.contains(vec3_t<length>{{length(1.0F), length(1.0F), length(1.0F)}}));
+        CHECK_FALSE(sphere.contains(vec3_t<length>{{length(2.0F), length(1.0F), length(0.0F)}}));
+        auto other = bounding_sphere<float>{vec3_t<length>{{length(3.0F), length(0.0F), length(0.0F)}}, length(1.5F)};
+        CHECK(sphere.intersects(other));
+    }
+}
+
+TEST_CASE("Frustum culling") {
+    float fovy = static_cast<float>(pi) / 2.0F; // 90 degrees
+    auto projection = perspective(fovy, 1.0F, length(1.0F), length(100.0F));
+    auto f = frustum<float>::from_matrix(projection);
+
+    SUBCASE("Plane extraction") {
+        // Near plane faces -z and passes through z = -1
+        CHECK(f.normals()(4, 2) == doctest::Approx(-1.0F).epsilon(0.0001F));
+        CHECK(f.offsets()(4).value() == doctest::Approx(-1.0F).epsilon(0.0001F));
+        // Far plane faces +z and passes through z = -100
+        CHECK(f.normals()(5, 2) == doctest::Approx(1.0F).epsilon(0.0001F));
+        CHECK(f.offsets()(5).value() == doctest::Approx(100.0F).epsilon(0.0001F));
+        // Left plane of a 90 degree frustum is tilted by 45 degrees
+        CHECK(f.normals()(0, 0) == doctest::Approx(0.70710678F).epsilon(0.0001F));
+        CHECK(f.normals()(0, 2) == doctest::Approx(-0.70710678F).epsilon(0.0001F));
+    }
+
+    SUBCASE("Point and volume tests") {
+        CHECK(f.contains(vec3_t<length>{{length(0.0F), length(0.0F), length(-10.0F)}}));
+        CHECK(f.contains(vec3_t<length>{{length(9.0F), length(-9.0F), length(-10.0F)}}));
+        CHECK_FALSE(f.contains(vec3_t<length>{{length(11.0F), length(0.0F), length(-10.0F)}}));
+        CHECK_FALSE(f.contains(vec3_t<length>{{length(0.0F), length(0.0F), length(10.0F)}}));
+        CHECK_FALSE(f.contains(vec3_t<length>{{length(0.0F), length(0.0F), length(-200.0F)}}));
+        CHECK_FALSE(f.contains(vec3_t<length>{{length(0.0F), length(0.0F), length(-0.5F)}}));
+
+        auto straddling = bounding_sphere<float>{vec3_t<length>{{length(11.0F), length(0.0F), length(-10.0F)}},
+                                                 length(2.0F)};
+        CHECK(f.intersects(straddling));
+        auto box = aabb<float>{vec3_t<length>{{length(10.5F), length(-1.0F), length(-11.0F)}},
+                               vec3_t<length>{{length(12.0F), length(1.0F), length(-9.0F)}}};
+        CHECK(f.intersects(box));
+        box.min(0) = length(20.0F);
+        box.max(0) = length(22.0F);
+        CHECK_FALSE(f.intersects(box));
+    }
+
+    SUBCASE("Custom unit length") {
+        auto unit_length = length(2.0F);
+        auto scaled = perspective(fovy, 1.0F, length(1.0F), length(100.0F), unit_length);
+        auto g = frustum<float>::from_matrix(scaled, unit_length);
+        CHECK(g.offsets()(4).value() == doctest::Approx(-1.0F).epsilon(0.0001F));
+        CHECK(g.offsets()(5).value() == doctest::Approx(100.0F).epsilon(0.0001F));
+    }
+
+    SUBCASE("Batched culling matches scalar tests") {
+        const std::size_t n = 1000;
+        tens_t<length> centers({n, 3});
+        tens_t<length> extents({n, 3});
+        tens_t<length> radii({n});
+        for (std::size_t i = 0; i < n; ++i) {
+            float t = static_cast<float>(i);
+            centers(i, 0) = length(std::sin(t) * 40.0F);
+            centers(i, 1) = length(std::cos(t * 0.7F) * 40.0F);
+            centers(i, 2) = length(std::sin(t * 0.3F) * 120.0F);
+            for (std::size_t j = 0; j < 3; ++j) {
+                extents(i, j) = length(1.0F + static_cast<float>((i + j) % 5));
+            }
+            radii(i) = length(0.5F + static_cast<float>(i % 7));
+        }
+        auto box_mask = cull_aabbs(f, centers, extents);
+        auto sphere_mask = cull_spheres(f, centers, radii);
+        CHECK(box_mask.size() == (n + 63) / 64);
+        std::size_t visible = 0;
+        bool all_match = true;
+        for (std::size_t i = 0; i < n; ++i) {
+            vec3_t<length> c{{centers(i, 0), centers(i, 1), centers(i, 2)}};
+            vec3_t<length> e{{extents(i, 0), extents(i, 1), extents(i, 2)}};
+            aabb<float> b{c - e, c + e};
+            bounding_sphere<float> s{c, radii(i)};
+            all_match = all_match && (test_bit(box_mask, i) == f.intersects(b));
+            all_match = all_match && (test_bit(sphere_mask, i) == f.intersects(s));
+            visible += test_bit(box_mask, i) ? 1 : 0;
+        }
+        CHECK(all_match);
+        CHECK(visible > 0);
+        CHECK(visible < n);
+        // Bits past the last volume are cleared
+        CHECK((box_mask.back() >> (n % 64)) == 0);
+    }
+
+    SUBCASE("Batched culling with row-major input") {
+        tens_t<length> centers({2, 3}, layout::row_major);
+        tens_t<length> extents({2, 3}, layout::row_major);
+        centers(0, 2) = length(-10.0F);
+        centers(1, 2) = length(10.0F);
+        for (std::size_t j = 0; j < 3; ++j) {
+            extents(0, j) = length(1.0F);
+            extents(1, j) = length(1.0F);
+        }
+        auto mask = cull_aabbs(f, centers, extents);
+        CHECK(test_bit(mask, 0));
+        CHECK_FALSE(test_bit(mask, 1));
+    }
+}
+
+TEST_CASE("k-d tree") {
+    const std::size_t n = 5000;
+    tens_t<length_t<double>> points({n, 3});
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-10.0, 10.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            points(i, j) = length_t<double>(dist(gen));
+        }
+    }
+    kd_tree<double> tree(points, 8);
+    CHECK(tree.size() == n);
+
+    auto brute_force = [&](const vec3_t<length_t<double>> &q) {
+        std::vector<std::pair<double, std::size_t>> d;
+        for (std::size_t i = 0; i < n; ++i) {
+            double d2 = 0;
+            for (std::size_t j = 0; j < 3; ++j) {
+                double diff = points(i, j).value() - q(j).value();
+                d2 += diff * diff;
+            }
+            d.emplace_back(std::sqrt(d2), i);
+        }
+        std::sort(d.begin(), d.end());
+        return d;
+    };
+
+    SUBCASE("Reordered layout") {
+        const auto &reordered = tree.points();
+        bool same = true;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                same = same && reordered(i, j) == points(tree.permutation()[i], j);
+            }
+        }
+        CHECK(same);
+    }
+
+    SUBCASE("Nearest neighbours") {
+        vec3_t<length_t<double>> q{{length_t<double>(1.0), length_t<double>(-2.0), length_t<double>(0.5)}};
+        auto result = tree.nearest(q, 5);
+        auto expected = brute_force(q);
+        for (std::size_t j = 0; j < 5; ++j) {
+            CHECK(result.indices(j) == expected[j].second);
+            CHECK(result.distances(j).value() == doctest::Approx(expected[j].first));
+        }
+        CHECK_THROWS_AS(tree.nearest(q, n + 1), std::invalid_argument);
+    }
+
+    SUBCASE("Radius search") {
+        vec3_t<length_t<double>> q{{length_t<double>(0.0), length_t<double>(0.0), length_t<double>(0.0)}};
+        auto result = tree.within_radius(q, length_t<double>(2.0));
+        auto expected = brute_force(q);
+        std::size_t count = 0;
+        while (count < n && expected[count].first <= 2.0) {
+            ++count;
+        }
+        REQUIRE(result.indices.size() == count);
+        for (std::size_t j = 0; j < count; ++j) {
+            CHECK(result.indices(j) == expected[j].second);
+        }
+    }
+
+    SUBCASE("Batched queries") {
+        const std::size_t m = 300;
+        tens_t<length_t<double>> queries({m, 3}, layout::row_major);
+        for (std::size_t i = 0; i < m; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                queries(i, j) = length_t<double>(dist(gen));
+            }
+        }
+        auto knn = tree.knn(queries, 3);
+        auto balls = tree.within_radius(queries, length_t<double>(1.0));
+        CHECK(knn.indices.shape() == std::vector<std::size_t>{m, 3});
+        CHECK(balls.size() == m);
+        bool all_match = true;
+        for (std::size_t i = 0; i < m; ++i) {
+            vec3_t<length_t<double>> q{{queries(i, 0), queries(i, 1), queries(i, 2)}};
+            auto single = tree.nearest(q, 3);
+            auto ball = tree.within_radius(q, length_t<double>(1.0));
+            for (std::size_t j = 0; j < 3; ++j) {
+                all_match = all_match && knn.indices(i, j) == single.indices(j);
+                all_match = all_match && knn.distances(i, j) == single.distances(j);
+            }
+            all_match = all_match && balls[i].indices.size() == ball.indices.size();
+        }
+        CHECK(all_match);
+    }
+}
+
+TEST_CASE("Batched vector and mesh kernels") {
+    SUBCASE("Batched cross and normalize") {
+        const std::size_t n = 20000;
+        tens_t<length> a({n, 3});
+        tens_t<double> b({n, 3}, layout::row_major);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                a(i, j) = length(static_cast<float>((i * 7 + j * 3) % 11) - 5.0F);
+                b(i, j) = static_cast<double>((i * 5 + j * 2) % 13) - 6.0;
+            }
+        }
+        tens_t<float> bf({n, 3});
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                bf(i, j) = static_cast<float>(b(i, j));
+            }
+        }
+        auto c = batched_cross(a, bf);
+        static_assert(std::is_same_v<typename decltype(c)::value_type, length>);
+        auto u = batched_normalize(a);
+        static_assert(std::is_same_v<typename decltype(u)::value_type, float>);
+        bool all_match = true;
+        for (std::size_t i = 0; i < n; i += 37) {
+            vec3_t<length> ai{{a(i, 0), a(i, 1), a(i, 2)}};
+            vec3 bi{{bf(i, 0), bf(i, 1), bf(i, 2)}};
+            auto expected = cross(ai, bi);
+            float len = std::sqrt(a(i, 0).value() * a(i, 0).value() + a(i, 1).value() * a(i, 1).value() +
+                                  a(i, 2).value() * a(i, 2).value());
+            for (std::size_t j = 0; j < 3; ++j) {
+                all_match = all_match && c(i, j) == expected(j);
+                float expected_unit = len > 0 ? a(i, j).value() / len : 0.0F;
+                all_match = all_match && std::abs(u(i, j) - expected_unit) < 1e-6F;
+            }
+        }
+        CHECK(all_match);
+    }
+
+    // Unit square in the xy plane split into two triangles, plus a vertex not used by any face
+    tens_t<length> vertices({5, 3});
+    vertices(1, 0) = length(2.0F);
+    vertices(2, 0) = length(2.0F);
+    vertices(2, 1) = length(2.0F);
+    vertices(3, 1) = length(2.0F);
+    vertices(4, 2) = length(9.0F);
+    tens_t<std::uint32_t> faces({2, 3}, layout::row_major);
+    faces(0, 0) = 0;
+    faces(0, 1) = 1;
+    faces(0, 2) = 2;
+    faces(1, 0) = 0;
+    faces(1, 1) = 2;
+    faces(1, 2) = 3;
+
+    SUBCASE("Face normals, areas and centroids") {
+        auto normals = face_normals(vertices, faces);
+        CHECK(normals(0, 2) == doctest::Approx(1.0F));
+        CHECK(normals(1, 2) == doctest::Approx(1.0F));
+        CHECK(normals(0, 0) == doctest::Approx(0.0F));
+
+        auto areas = face_areas(vertices, faces);
+        static_assert(std::is_same_v<typename decltype(areas)::value_type, area>);
+        CHECK(areas(0).value() == doctest::Approx(2.0F));
+        CHECK(areas(1).value() == doctest::Approx(2.0F));
+
+        auto centroids = face_centroids(vertices, faces);
+        static_assert(std::is_same_v<typename decltype(centroids)::value_type, length>);
+        CHECK(centroids(0, 0).value() == doctest::Approx(4.0F / 3.0F));
+        CHECK(centroids(0, 1).value() == doctest::Approx(2.0F / 3.0F));
+        CHECK(centroids(1, 0).value() == doctest::Approx(2.0F / 3.0F));
+    }
+
+    SUBCASE("Triangle soup matches indexed mesh") {
+        tens_t<length> p0({2, 3});
+        tens_t<length> p1({2, 3});
+        tens_t<length> p2({2, 3});
+        for (std::size_t f = 0; f < 2; ++f) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                p0(f, j) = vertices(faces(f, 0), j);
+                p1(f, j) = vertices(faces(f, 1), j);
+                p2(f, j) = vertices(faces(f, 2), j);
+            }
+        }
+        auto areas = face_areas(p0, p1, p2);
+        auto normals = face_normals(p0, p1, p2);
+        auto centroids = face_centroids(p0, p1, p2);
+        CHECK(areas(1).value() == doctest::Approx(2.0F));
+        CHECK(normals(1, 2) == doctest::Approx(1.0F));
+        CHECK(centroids(1, 1).value() == doctest::Approx(4.0F / 3.0F));
+    }
+
+    SUBCASE("Vertex normals") {
+        // Fold the second triangle up so that shared vertices average the two face normals
+        vertices(3, 1) = length(0.0F);
+        vertices(3, 2) = length(2.0F);
+        auto normals = vertex_normals(vertices, faces);
+        // Vertex 1 only belongs to the flat face
+        CHECK(normals(1, 2) == doctest::Approx(1.0F));
+        // Vertex 0 is shared, its normal is the area-weighted average of both faces
+        auto face_n = face_normals(vertices, faces);
+        auto face_a = face_areas(vertices, faces);
+        float a0 = face_a(0).value();
+        float a1 = face_a(1).value();
+        float sx = a0 * face_n(0, 0) + a1 * face_n(1, 0);
+        float sy = a0 * face_n(0, 1) + a1 * face_n(1, 1);
+        float sz = a0 * face_n(0, 2) + a1 * face_n(1, 2);
+        float len = std::sqrt(sx * sx + sy * sy + sz * sz);
+        CHECK(normals(0, 1) == doctest::Approx(sy / len));
+        CHECK(normals(0, 2) == doctest::Approx(sz / len));
+        // Unused vertex
+        CHECK(normals(4, 0) == 0.0F);
+        CHECK(normals(4, 2) == 0.0F);
+    }
+
+    SUBCASE("Face indices are validated before use") {
+        tensor<std::int32_t, dynamic, dynamic, error_checking::enabled> bad({2, 3}, layout::row_major);
+        bad(0, 1) = 1;
+        bad(0, 2) = 7;
+        bad(1, 2) = 2;
+        CHECK_THROWS_AS(face_normals(vertices, bad), std::out_of_range);
+        CHECK_THROWS_AS(face_areas(vertices, bad), std::out_of_range);
+        CHECK_THROWS_AS(face_centroids(vertices, bad), std::out_of_range);
+        CHECK_THROWS_AS(vertex_normals(vertices, bad), std::out_of_range);
+        bad(0, 2) = 2;
+        bad(1, 0) = -1;
+        CHECK_THROWS_AS(face_areas(vertices, bad), std::out_of_range);
+        bad(1, 0) = 3;
+        CHECK(face_areas(vertices, bad)(1).value() == doctest::Approx(2.0F));
+
+        tens_t<std::uint32_t> unchecked = faces;
+        unchecked(1, 2) = 5;
+        CHECK_THROWS_AS(vertex_normals(vertices, unchecked), std::out_of_range);
+    }
+}
+
+TEST_CASE("Orthonormalization") {
+    auto orthonormality_error = [](const auto &m) {
+        float error = 0.0F;
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                float d = 0.0F;
+                for (std::size_t k = 0; k < 3; ++k) {
+                    d += m(k, i) * m(k, j);
+                }
+                error = std::max(error, std::abs(d - (i == j ? 1.0F : 0.0F)));
+            }
+        }
+        return error;
+    };
+
+    // Accumulate drift with many small rotations
+    auto drifted = mat4::eye();
+    translate(drifted, vec3_t<length>{{length(1.0F), length(2.0F), length(3.0F)}});
+    for (int i = 0; i < 2000; ++i) {
+        rotate(drifted, 0.01F, vec3{{1.0F, 2.0F, 3.0F}});
+        drifted(0, 1) += 1e-4F;
+    }
+    CHECK(orthonormality_error(drifted) > 1e-3F);
+
+    SUBCASE("Polar decomposition") {
+        auto m = drifted;
+        orthonormalize(m);
+        CHECK(orthonormality_error(m) < 1e-5F);
+        // Translation is untouched and the result stays close to the input
+        CHECK(m(0, 3) == drifted(0, 3));
+        CHECK(m(3, 3) == 1.0F);
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                CHECK(m(i, j) == doctest::Approx(drifted(i, j)).epsilon(0.2F));
+            }
+        }
+    }
+
+    SUBCASE("Gram-Schmidt") {
+        auto m = mat3{{1.0F, 0.1F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 2.0F}};
+        orthonormalize(m, orthonormalization::gram_schmidt);
+        CHECK(orthonormality_error(m) < 1e-6F);
+        // First column keeps its direction and the result is right-handed
+        CHECK(m(1, 0) == doctest::Approx(0.1F / std::sqrt(1.01F)));
+        CHECK(m(2, 2) == doctest::Approx(1.0F));
+    }
+
+    SUBCASE("Singular input falls back to Gram-Schmidt") {
+        auto m = mat3{{1.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 0.0F}};
+        orthonormalize(m);
+        CHECK(orthonormality_error(m) < 1e-6F);
+        // The input is used as is, not the shrunken result of the polar iteration
+        CHECK(m(0, 0) == doctest::Approx(1.0F));
+        CHECK(m(1, 1) == doctest::Approx(1.0F));
+    }
+
+    SUBCASE("Rank-deficient and zero columns") {
+        auto determinant = [](const auto &m) {
+            return m(0, 0) * (m(1, 1) * m(2, 2) - m(2, 1) * m(1, 2)) -
+                   m(0, 1) * (m(1, 0) * m(2, 2) - m(2, 0) * m(1, 2)) +
+                   m(0, 2) * (m(1, 0) * m(2, 1) - m(2, 0) * m(1, 1));
+        };
+        const std::array<mat3, 4> inputs{
+            mat3{{0.0F, 0.0F, 0.0F, 0.0F, 2.0F, 0.0F, 0.0F, 0.0F, 1.0F}},  // Zero first column
+            mat3{{0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F}},  // Zero matrix
+            mat3{{1.0F, 1.0F, 0.0F, 2.0F, 2.0F, 0.0F, 0.0F, 0.0F, 0.0F}},  // Parallel columns
+            mat3{{0.0F, 0.0F, 3.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F}}}; // Zero second column
+        for (const auto method : {orthonormalization::polar, orthonormalization::gram_schmidt}) {
+            for (const auto &input : inputs) {
+                auto m = input;
+                orthonormalize(m, method);
+                CHECK(orthonormality_error(m) < 1e-6F);
+                CHECK(determinant(m) == doctest::Approx(1.0F));
+            }
+        }
+        auto m = inputs[0];
+        orthonormalize(m, orthonormalization::gram_schmidt);
+        CHECK(m(1, 1) == doctest::Approx(1.0F));
+
+        tens_t<float> batch({3, 3, 3});
+        batch(0, 0, 0) = 1.0F;
+        batch(0, 1, 1) = 1.0F;
+        batch(0, 2, 2) = 1.0F;
+        batch(2, 1, 1) = 1.0F;
+        orthonormalize(batch);
+        for (std::size_t b = 0; b < 3; ++b) {
+            mat3 lane;
+            for (std::size_t i = 0; i < 3; ++i) {
+                for (std::size_t j = 0; j < 3; ++j) {
+                    lane(i, j) = batch(b, i, j);
+                }
+            }
+            CHECK(orthonormality_error(lane) < 1e-6F);
+        }
+        CHECK(batch(0, 0, 0) == doctest::Approx(1.0F));
+    }
+
+    SUBCASE("Ill-conditioned input and reflections") {
+        auto determinant = [](const auto &m) {
+            return m(0, 0) * (m(1, 1) * m(2, 2) - m(2, 1) * m(1, 2)) -
+                   m(0, 1) * (m(1, 0) * m(2, 2) - m(2, 0) * m(1, 2)) +
+                   m(0, 2) * (m(1, 0) * m(2, 1) - m(2, 0) * m(1, 1));
+        };
+        auto error = [](const dmat3 &m) {
+            double e = 0.0;
+            for (std::size_t i = 0; i < 3; ++i) {
+                for (std::size_t j = 0; j < 3; ++j) {
+                    double d = 0.0;
+                    for (std::size_t k = 0; k < 3; ++k) {
+                        d += m(k, i) * m(k, j);
+                    }
+                    e = std::max(e, std::abs(d - (i == j ? 1.0 : 0.0)));
+                }
+            }
+            return e;
+        };
+        // A rotation times diag(1, 1e-3, 1e-9), and the same matrix reflected
+        auto rotation = dmat4::eye();
+        rotate(rotation, 0.8, dvec3{{1.0, -2.0, 0.5}});
+        dmat3 skewed;
+        const std::array<double, 3> stretch{1.0, 1e-3, 1e-9};
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                skewed(i, j) = rotation(i, j) * stretch[j];
+            }
+        }
+        dmat3 reflected = skewed;
+        for (std::size_t i = 0; i < 3; ++i) {
+            reflected(i, 0) = -reflected(i, 0);
+        }
+        const std::array<dmat3, 5> inputs{dmat3{{1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1e-6}},
+                                          dmat3{{1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, -1.0}},
+                                          dmat3{{1e-7, 0.0, 0.0, 0.0, 1e-7, 0.0, 0.0, 0.0, 1e-7}}, skewed,
+                                          reflected};
+        for (const auto method : {orthonormalization::polar, orthonormalization::gram_schmidt}) {
+            for (const auto &input : inputs) {
+                auto m = input;
+                orthonormalize(m, method);
+                CHECK(error(m) < 1e-14);
+                CHECK(determinant(m) == doctest::Approx(1.0));
+            }
+        }
+        // The polar factor of a diagonal matrix with positive entries is the identity
+        for (std::size_t k = 0; k < 3; ++k) {
+            auto m = inputs[k];
+            orthonormalize(m);
+            CHECK(m(0, 0) == doctest::Approx(1.0));
+            CHECK(m(1, 1) == doctest::Approx(1.0));
+            CHECK(m(2, 2) == doctest::Approx(1.0));
+        }
+        // The polar factor of R diag(s) is R, and both methods agree on the reflection
+        auto m = skewed;
+        orthonormalize(m);
+        auto g = reflected;
+        orthonormalize(g, orthonormalization::gram_schmidt);
+        auto p = reflected;
+        orthonormalize(p);
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                CHECK(m(i, j) == doctest::Approx(rotation(i, j)).epsilon(1e-9));
+                CHECK(p(i, j) == doctest::Approx(g(i, j)).epsilon(1e-6));
+            }
+        }
+
+        tens_t<double> batch({inputs.size(), 3, 3});
+        for (std::size_t b = 0; b < inputs.size(); ++b) {
+            for (std::size_t i = 0; i < 3; ++i) {
+                for (std::size_t j = 0; j < 3; ++j) {
+                    batch(b, i, j) = inputs[b](i, j);
+                }
+            }
+        }
+        orthonormalize(batch);
+        for (std::size_t b = 0; b < inputs.size(); ++b) {
+            dmat3 lane;
+            for (std::size_t i = 0; i < 3; ++i) {
+                for (std::size_t j = 0; j < 3; ++j) {
+                    lane(i, j) = batch(b, i, j);
+                }
+            }
+            CHECK(error(lane) < 1e-14);
+            CHECK(determinant(lane) == doctest::Approx(1.0));
+        }
+    }
+
+    SUBCASE("Batched") {
+        const std::size_t n = 150;
+        tens_t<double> batch({n, 4, 4});
+        for (std::size_t b = 0; b < n; ++b) {
+            auto m = dmat4::eye();
+            rotate(m, 0.01 * static_cast<double>(b), dvec3{{1.0, 0.0, 1.0}});
+            m(0, 0) += 0.01;
+            m(2, 1) -= 0.02;
+            m(1, 3) = static_cast<double>(b);
+            for (std::size_t i = 0; i < 4; ++i) {
+                for (std::size_t j = 0; j < 4; ++j) {
+                    batch(b, i, j) = m(i, j);
+                }
+            }
+        }
+        auto copy = batch;
+        orthonormalize(batch);
+        bool all_match = true;
+        for (std::size_t b = 0; b < n; ++b) {
+            dmat4 m;
+            for (std::size_t i = 0; i < 4; ++i) {
+                for (std::size_t j = 0; j < 4; ++j) {
+                    m(i, j) = copy(b, i, j);
+                }
+            }
+            orthonormalize(m);
+            for (std::size_t i = 0; i < 4; ++i) {
+                for (std::size_t j = 0; j < 4; ++j) {
+                    all_match = all_match && std::abs(batch(b, i, j) - m(i, j)) < 1e-12;
+                }
+            }
+        }
+        CHECK(all_match);
+        CHECK(batch(7, 1, 3) == 7.0);
+        tens_t<double> wrong({n, 2, 2});
+        CHECK_THROWS_AS(orthonormalize(wrong), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Point set registration") {
+    const std::size_t n = 50000;
+    tens_t<length_t<double>> p({n, 3});
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(-5.0, 5.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < 3; ++j) {
+            p(i, j) = length_t<double>(dist(gen) + 1000.0);
+        }
+    }
+    auto rotation = dmat4::eye();
+    rotate(rotation, 0.7, dvec3{{0.3, -1.0, 0.5}});
+    dvec3 translation{{3.0, -2.0, 10.0}};
+
+    auto transform_points = [&](double s) {
+        tens_t<length_t<double>> q({n, 3});
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t r = 0; r < 3; ++r) {
+                double v = translation(r);
+                for (std::size_t c = 0; c < 3; ++c) {
+                    v += s * rotation(r, c) * p(i, c).value();
+                }
+                q(i, r) = length_t<double>(v);
+            }
+        }
+        return q;
+    };
+
+    SUBCASE("Kabsch") {
+        auto q = transform_points(1.0);
+        auto result = kabsch(p, q);
+        for (std::size_t r = 0; r < 3; ++r) {
+            for (std::size_t c = 0; c < 3; ++c) {
+                CHECK(result.rotation(r, c) == doctest::Approx(rotation(r, c)).epsilon(1e-9));
+            }
+            CHECK(result.translation(r).value() == doctest::Approx(translation(r)).epsilon(1e-6));
+        }
+        CHECK(result.scale == 1.0);
+        vec3_t<length_t<double>> p0{{p(5, 0), p(5, 1), p(5, 2)}};
+        auto mapped = result.apply(p0);
+        CHECK(mapped(1).value() == doctest::Approx(q(5, 1).value()).epsilon(1e-9));
+        auto m = result.matrix();
+        CHECK(m(0, 3) == doctest::Approx(translation(0)).epsilon(1e-6));
+        CHECK(m(3, 3) == 1.0);
+    }
+
+    SUBCASE("Umeyama") {
+        auto q = transform_points(2.5);
+        auto result = umeyama(p, q);
+        CHECK(result.scale == doctest::Approx(2.5).epsilon(1e-9));
+        CHECK(result.rotation(0, 1) == doctest::Approx(rotation(0, 1)).epsilon(1e-9));
+        CHECK(result.translation(2).value() == doctest::Approx(translation(2)).epsilon(1e-6));
+    }
+
+    SUBCASE("Reflections are rejected") {
+        // Mirror a planar-ish configuration; the best proper rotation has determinant +1
+        auto q = transform_points(1.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            q(i, 0) = -q(i, 0);
+        }
+        auto result = kabsch(p, q);
+        auto r = result.rotation;
+        double det = r(0, 0) * (r(1, 1) * r(2, 2) - r(1, 2) * r(2, 1)) -
+                     r(0, 1) * (r(1, 0) * r(2, 2) - r(1, 2) * r(2, 0)) +
+                     r(0, 2) * (r(1, 0) * r(2, 1) - r(1, 1) * r(2, 0));
+        CHECK(det == doctest::Approx(1.0));
+    }
+
+    SUBCASE("Planar point sets") {
+        tens_t<length_t<double>> planar_p({n, 3});
+        tens_t<length_t<double>> planar_q({n, 3});
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t r = 0; r < 3; ++r) {
+                double v = translation(r);
+                for (std::size_t c = 0; c < 2; ++c) {
+                    v += rotation(r, c) * p(i, c).value();
+                }
+                planar_q(i, r) = length_t<double>(v);
+                planar_p(i, r) = r < 2 ? p(i, r) : length_t<double>(0.0);
+            }
+        }
+        auto result = kabsch(planar_p, planar_q);
+        for (std::size_t r = 0; r < 3; ++r) {
+            for (std::size_t c = 0; c < 3; ++c) {
+                CHECK(result.rotation(r, c) == doctest::Approx(rotation(r, c)).epsilon(1e-8));
+            }
+        }
+    }
+
+    SUBCASE("Tiny point clouds") {
+        // The result must not depend on the units: micrometre-scale clouds and smaller
+        auto small_rotation = dmat4::eye();
+        rotate(small_rotation, 0.5, dvec3{{0.0, 0.0, 1.0}});
+        for (const double scale : {1e-3, 1e-6, 1e-8, 1e-12}) {
+            const std::size_t m = 200;
+            tens_t<length_t<double>> small_p({m, 3});
+            tens_t<length_t<double>> small_q({m, 3});
+            tens_t<length_t<double>> flat_p({m, 3});
+            tens_t<length_t<double>> flat_q({m, 3});
+            for (std::size_t i = 0; i < m; ++i) {
+                for (std::size_t c = 0; c < 3; ++c) {
+                    small_p(i, c) = length_t<double>(scale * (p(i, c).value() - 1000.0));
+                    flat_p(i, c) = c < 2 ? small_p(i, c) : length_t<double>(0.0);
+                }
+                for (std::size_t r = 0; r < 3; ++r) {
+                    double v = scale * translation(r);
+                    double w = v;
+                    for (std::size_t c = 0; c < 3; ++c) {
+                        v += small_rotation(r, c) * small_p(i, c).value();
+                        w += small_rotation(r, c) * flat_p(i, c).value();
+                    }
+                    small_q(i, r) = length_t<double>(v);
+                    flat_q(i, r) = length_t<double>(w);
+                }
+            }
+            auto result = kabsch(small_p, small_q);
+            auto flat = kabsch(flat_p, flat_q);
+            for (std::size_t r = 0; r < 3; ++r) {
+                for (std::size_t c = 0; c < 3; ++c) {
+                    CHECK(result.rotation(r, c) == doctest::Approx(small_rotation(r, c)).epsilon(1e-9));
+                    CHECK(flat.rotation(r, c) == doctest::Approx(small_rotation(r, c)).epsilon(1e-8));
+                }
+            }
+            CHECK(result.rotation(0, 0) == doctest::Approx(std::cos(0.5)).epsilon(1e-9));
+            CHECK(umeyama(small_p, small_q).scale == doctest::Approx(1.0).epsilon(1e-9));
+        }
+    }
+
+    SUBCASE("Float input and errors") {
+        tens_t<length> pf({4, 3});
+        tens_t<length> qf({4, 3});
+        float coords[4][3] = {{0, 0, 0}, {1, 0, 0}, {0, 2, 0}, {0, 0, 3}};
+        for (std::size_t i = 0; i < 4; ++i) {
+            // Rotate by 90 degrees about z and shift along x
+            pf(i, 0) = length(coords[i][0]);
+            pf(i, 1) = length(coords[i][1]);
+            pf(i, 2) = length(coords[i][2]);
+            qf(i, 0) = length(-coords[i][1] + 1.0F);
+            qf(i, 1) = length(coords[i][0]);
+            qf(i, 2) = length(coords[i][2]);
+        }
+        auto result = kabsch(pf, qf);
+        CHECK(result.rotation(0, 1) == doctest::Approx(-1.0F).epsilon(1e-5F));
+        CHECK(result.rotation(1, 0) == doctest::Approx(1.0F).epsilon(1e-5F));
+        CHECK(result.translation(0).value() == doctest::Approx(1.0F).epsilon(1e-5F));
+        tens_t<length> wrong({3, 3});
+        CHECK_THROWS_AS(kabsch(pf, wrong), std::invalid_argument);
+    }
+}
 // NOLINTEND
@@ -6,6 +6,12 @@
 #include "squint/quantity.hpp"
 #include "squint/tensor.hpp"
 
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <type_traits>
+#include <vector>
+
 using namespace squint;
 
 TEST_CASE("solve()") {
@@ -805,4 +811,473 @@ TEST_CASE("tensor_einsum") {
     }
 }
 
+TEST_CASE("Fast Fourier transforms") {
+    using complex = std::complex<double>;
+    auto naive_dft = [](const std::vector<complex> &x, double sign) {
+        const std::size_t n = x.size();
+        std::vector<complex> y(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            for (std::size_t j = 0; j < n; ++j) {
+                y[k] += x[j] * std::polar(1.0, sign * 2.0 * std::numbers::pi * static_cast<double>((j * k) % n) /
+                                                   static_cast<double>(n));
+            }
+        }
+        return y;
+    };
+    auto signal = [](std::size_t n) {
+        std::vector<complex> x(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            x[i] = complex(std::sin(0.3 * static_cast<double>(i)) + 0.1 * static_cast<double>(i % 7),
+                           std::cos(1.7 * static_cast<double>(i)));
+        }
+        return x;
+    };
+
+    SUBCASE("Complex transform matches the DFT for mixed-radix and prime lengths") {
+        for (std::size_t n : {1, 2, 3, 8, 12, 15, 17, 30, 97, 1000}) {
+            const auto x = signal(n);
+            const auto expected = naive_dft(x, -1.0);
+            tens_t<complex> input({n}, x);
+            auto output = fft(input);
+            REQUIRE(output.shape() == std::vector<std::size_t>{n});
+            for (std::size_t k = 0; k < n; ++k) {
+                CHECK(std::abs(output(k) - expected[k]) < 1e-9 * static_cast<double>(n));
+            }
+            auto restored = ifft(output);
+            for (std::size_t i = 0; i < n; ++i) {
+                CHECK(std::abs(restored(i) - x[i]) < 1e-12 * static_cast<double>(n));
+            }
+        }
+    }
+
+    SUBCASE("Real transform and inverse for even and odd lengths") {
+        for (std::size_t n : {1, 2, 7, 16, 18, 19}) {
+            tens_t<double> input({n});
+            std::vector<complex> x(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                input(i) = std::sin(0.5 * static_cast<double>(i)) + static_cast<double>(i % 3);
+                x[i] = input(i);
+            }
+            const auto expected = naive_dft(x, -1.0);
+            auto spectrum = rfft(input);
+            REQUIRE(spectrum.shape() == std::vector<std::size_t>{n / 2 + 1});
+            for (std::size_t k = 0; k <= n / 2; ++k) {
+                CHECK(std::abs(spectrum(k) - expected[k]) < 1e-10);
+            }
+            auto restored = irfft(spectrum, n);
+            for (std::size_t i = 0; i < n; ++i) {
+                CHECK(restored(i) == doctest::Approx(input(i)));
+            }
+        }
+    }
+
+    SUBCASE("Batched transforms along an axis of a strided view") {
+        tens_t<double> data({6, 5});
+        for (std::size_t j = 0; j < 5; ++j) {
+            for (std::size_t i = 0; i < 6; ++i) {
+                data(i, j) = static_cast<double>(i * i) - static_cast<double>(3 * j);
+            }
+        }
+        auto rows = data.transpose(); // 5x6 view, each column of data is a row of the view
+        auto spectra = rfft(rows, 1);
+        REQUIRE(spectra.shape() == std::vector<std::size_t>{5, 4});
+        for (std::size_t j = 0; j < 5; ++j) {
+            auto column = rfft(data.subview({6, 1}, {0, j}));
+            for (std::size_t k = 0; k < 4; ++k) {
+                CHECK(std::abs(spectra(j, k) - column(k, 0)) < 1e-12);
+            }
+        }
+        auto full = fft(data, 1);
+        for (std::size_t i = 0; i < 6; ++i) {
+            std::vector<complex> row(5);
+            for (std::size_t j = 0; j < 5; ++j) {
+                row[j] = data(i, j);
+            }
+            const auto expected = naive_dft(row, -1.0);
+            for (std::size_t k = 0; k < 5; ++k) {
+                CHECK(std::abs(full(i, k) - expected[k]) < 1e-12);
+            }
+        }
+    }
+
+    SUBCASE("Two dimensional transform") {
+        tens_t<complex> image({4, 6});
+        for (std::size_t j = 0; j < 6; ++j) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                image(i, j) = complex(static_cast<double>(i + 2 * j), static_cast<double>(i) * 0.5);
+            }
+        }
+        auto spectrum = fft2(image);
+        complex expected{};
+        for (std::size_t j = 0; j < 6; ++j) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                expected += image(i, j) * std::polar(1.0, -2.0 * std::numbers::pi * (i / 4.0 + 2.0 * j / 6.0));
+            }
+        }
+        CHECK(std::abs(spectrum(1, 2) - expected) < 1e-12);
+        auto restored = ifft2(spectrum);
+        for (std::size_t j = 0; j < 6; ++j) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                CHECK(std::abs(restored(i, j) - image(i, j)) < 1e-12);
+            }
+        }
+    }
+
+    SUBCASE("Large transform runs in parallel") {
+        const std::size_t n = std::size_t{1} << 16;
+        tens_t<double> input({n});
+        for (std::size_t i = 0; i < n; ++i) {
+            input(i) = std::cos(2.0 * std::numbers::pi * 100.0 * static_cast<double>(i) / static_cast<double>(n));
+        }
+        auto spectrum = rfft(input);
+        CHECK(std::abs(spectrum(100)) == doctest::Approx(static_cast<double>(n) / 2));
+        CHECK(std::abs(spectrum(99)) < 1e-6);
+        auto restored = irfft(spectrum, n);
+        CHECK(restored(12345) == doctest::Approx(input(12345)));
+    }
+
+    SUBCASE("Quantities keep their dimension") {
+        tens_t<length_t<double>> displacement({8});
+        for (std::size_t i = 0; i < 8; ++i) {
+            displacement(i) = length_t<double>(static_cast<double>(i));
+        }
+        auto spectrum = rfft(displacement);
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(spectrum(0))>,
+                                     quantity<std::complex<double>, dimensions::L>>);
+        CHECK(spectrum(0).value().real() == doctest::Approx(28.0));
+        auto restored = irfft(spectrum, 8);
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(restored(0))>, length_t<double>>);
+        CHECK(restored(3).value() == doctest::Approx(3.0));
+
+        auto f = fftfreq(4, duration_t<double>(0.5));
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(f(0))>, frequency_t<double>>);
+        CHECK(f(1).value() == doctest::Approx(0.5));
+        CHECK(f(2).value() == doctest::Approx(-1.0));
+        CHECK(f(3).value() == doctest::Approx(-0.5));
+        auto rf = rfftfreq(5, 0.1);
+        REQUIRE(rf.size() == 3);
+        CHECK(rf(2) == doctest::Approx(4.0));
+    }
+
+    SUBCASE("Complex quantities") {
+        using complex_length = quantity<std::complex<double>, dimensions::L>;
+        const complex_length a(complex(1.0, 2.0));
+        const complex_length b(complex(-2.0, 1.0));
+        CHECK((a + b).value() == complex(-1.0, 3.0));
+        CHECK((a * 2.0).value() == complex(2.0, 4.0));
+        CHECK((a * b).value() == complex(-4.0, -3.0));
+    }
+}
+
+TEST_CASE("Convolution and correlation") {
+    const std::vector<convolution_method> methods{convolution_method::direct, convolution_method::fft};
+
+    SUBCASE("1D modes") {
+        tens_t<double> x({5}, std::vector<double>{1, 2, 3, 4, 5});
+        tens_t<double> k({3}, std::vector<double>{1, 0, -1});
+        for (auto method : methods) {
+            auto full = convolve(x, k, convolution_mode::full, method);
+            const std::vector<double> expected_full{1, 2, 2, 2, 2, -4, -5};
+            REQUIRE(full.size() == 7);
+            for (std::size_t i = 0; i < 7; ++i) {
+                CHECK(full(i) == doctest::Approx(expected_full[i]));
+            }
+            auto same = convolve(x, k, convolution_mode::same, method);
+            REQUIRE(same.size() == 5);
+            CHECK(same(0) == doctest::Approx(2));
+            CHECK(same(4) == doctest::Approx(-4));
+            auto valid = convolve(x, k, convolution_mode::valid, method);
+            REQUIRE(valid.size() == 3);
+            CHECK(valid(0) == doctest::Approx(2));
+            CHECK(valid(2) == doctest::Approx(2));
+
+            auto corr = correlate(x, k, convolution_mode::valid, method);
+            REQUIRE(corr.size() == 3);
+            CHECK(corr(0) == doctest::Approx(-2));
+            CHECK(corr(1) == doctest::Approx(-2));
+        }
+    }
+
+    SUBCASE("Direct and FFT agree on long signals with channels") {
+        tens_t<double> x({300, 3});
+        for (std::size_t c = 0; c < 3; ++c) {
+            for (std::size_t i = 0; i < 300; ++i) {
+                x(i, c) = std::sin(0.05 * static_cast<double>(i * (c + 1))) + static_cast<double>(c);
+            }
+        }
+        tens_t<double> k({41});
+        for (std::size_t j = 0; j < 41; ++j) {
+            k(j) = 1.0 / (1.0 + static_cast<double>(j));
+        }
+        for (auto mode : {convolution_mode::full, convolution_mode::same, convolution_mode::valid}) {
+            auto direct = convolve(x, k, mode, convolution_method::direct);
+            auto spectral = convolve(x, k, mode, convolution_method::fft);
+            auto automatic = convolve(x, k, mode);
+            REQUIRE(direct.shape() == spectral.shape());
+            REQUIRE(direct.shape()[1] == 3);
+            for (std::size_t c = 0; c < 3; ++c) {
+                for (std::size_t i = 0; i < direct.shape()[0]; ++i) {
+                    CHECK(spectral(i, c) == doctest::Approx(direct(i, c)).epsilon(1e-9));
+                    CHECK(automatic(i, c) == doctest::Approx(direct(i, c)).epsilon(1e-9));
+                }
+            }
+        }
+    }
+
+    SUBCASE("2D kernels") {
+        tens_t<double> image({6, 7});
+        for (std::size_t j = 0; j < 7; ++j) {
+            for (std::size_t i = 0; i < 6; ++i) {
+                image(i, j) = static_cast<double>((i * 3 + j * 5) % 11);
+            }
+        }
+        tens_t<double> kernel({3, 2}, std::vector<double>{1, 2, 3, 4, 5, 6});
+        for (auto method : methods) {
+            auto full = convolve(image, kernel, convolution_mode::full, method);
+            REQUIRE(full.shape() == std::vector<std::size_t>{8, 8});
+            for (std::size_t o1 = 0; o1 < 8; ++o1) {
+                for (std::size_t o0 = 0; o0 < 8; ++o0) {
+                    double expected = 0;
+                    for (std::size_t j1 = 0; j1 < 2; ++j1) {
+                        for (std::size_t j0 = 0; j0 < 3; ++j0) {
+                            if (o0 >= j0 && o0 - j0 < 6 && o1 >= j1 && o1 - j1 < 7) {
+                                expected += image(o0 - j0, o1 - j1) * kernel(j0, j1);
+                            }
+                        }
+                    }
+                    CHECK(full(o0, o1) == doctest::Approx(expected));
+                }
+            }
+            auto valid = correlate(image, kernel, convolution_mode::valid, method);
+            REQUIRE(valid.shape() == std::vector<std::size_t>{4, 6});
+            double expected = 0;
+            for (std::size_t j1 = 0; j1 < 2; ++j1) {
+                for (std::size_t j0 = 0; j0 < 3; ++j0) {
+                    expected += image(1 + j0, 2 + j1) * kernel(j0, j1);
+                }
+            }
+            CHECK(valid(1, 2) == doctest::Approx(expected));
+        }
+    }
+
+    SUBCASE("Integer, complex and quantity elements") {
+        tensor<int, shape<4>> x{1, 2, 3, 4};
+        tensor<int, shape<2>> k{1, 1};
+        auto sums = convolve(x, k, convolution_mode::valid);
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(sums(0))>, int>);
+        CHECK(sums(0) == 3);
+        CHECK(sums(2) == 7);
+
+        using complex = std::complex<double>;
+        tens_t<complex> z({3}, std::vector<complex>{{1, 1}, {0, 2}, {3, 0}});
+        tens_t<complex> w({2}, std::vector<complex>{{0, 1}, {1, 0}});
+        for (auto method : methods) {
+            auto corr = correlate(z, w, convolution_mode::valid, method);
+            CHECK(std::abs(corr(0) - (z(0) * std::conj(w(0)) + z(1) * std::conj(w(1)))) < 1e-12);
+        }
+
+        tens_t<length_t<double>> position({4});
+        for (std::size_t i = 0; i < 4; ++i) {
+            position(i) = length_t<double>(static_cast<double>(i * i));
+        }
+        tens_t<double> difference({2}, std::vector<double>{1, -1});
+        auto steps = convolve(position, difference, convolution_mode::valid);
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(steps(0))>, length_t<double>>);
+        CHECK(steps(2).value() == doctest::Approx(5.0));
+    }
+}
+
+TEST_CASE("Banded and tridiagonal solvers") {
+    SUBCASE("Band storage round trip") {
+        banded_matrix<double> A(4, 1, 2);
+        A(0, 0) = 1;
+        A(2, 1) = 5;
+        A(0, 2) = 7;
+        CHECK_THROWS_AS(A(3, 0), std::out_of_range);
+        const auto &view = A;
+        CHECK(view(3, 0) == 0);
+        auto dense = A.to_dense();
+        CHECK(dense(2, 1) == 5);
+        CHECK(dense(0, 2) == 7);
+        auto copy = banded_matrix<double>::from_dense(dense, 1, 2);
+        CHECK(copy(2, 1) == 5);
+        CHECK(copy.leading_dimension() == 5);
+    }
+
+    SUBCASE("General banded solve matches the dense solve") {
+        const std::size_t n = 8;
+        tens_t<double> dense({n, n}, 0.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = i > 2 ? i - 2 : 0; j < std::min(n, i + 2); ++j) {
+                dense(i, j) = static_cast<double>((3 * i + 5 * j) % 7) - 2.0;
+            }
+        }
+        auto A = banded_matrix<double>::from_dense(dense, 2, 1);
+        auto residual_matrix = A.to_dense();
+        tens_t<double> B({n, 2});
+        for (std::size_t i = 0; i < n; ++i) {
+            B(i, 0) = static_cast<double>(i) + 1.0;
+            B(i, 1) = std::cos(static_cast<double>(i));
+        }
+        auto X = B.copy();
+        solve_banded(A, X);
+        auto original = banded_matrix<double>::from_dense(residual_matrix, 2, 1);
+        auto AX = original.multiply(X);
+        for (std::size_t k = 0; k < 2; ++k) {
+            for (std::size_t i = 0; i < n; ++i) {
+                CHECK(AX(i, k) == doctest::Approx(B(i, k)));
+            }
+        }
+    }
+
+    SUBCASE("Symmetric positive definite banded solve") {
+        const std::size_t n = 10;
+        banded_matrix<double> A(n, 2, 2);
+        for (std::size_t i = 0; i < n; ++i) {
+            A(i, i) = 6.0;
+            if (i + 1 < n) {
+                A(i, i + 1) = A(i + 1, i) = -2.0;
+            }
+            if (i + 2 < n) {
+                A(i, i + 2) = A(i + 2, i) = 0.5;
+            }
+        }
+        const auto original = A.to_dense();
+        tens_t<double> b({n}, 1.0);
+        solve_banded_spd(A, b);
+        auto check = banded_matrix<double>::from_dense(original, 2, 2).multiply(b);
+        for (std::size_t i = 0; i < n; ++i) {
+            CHECK(check(i) == doctest::Approx(1.0));
+        }
+
+        banded_matrix<double> indefinite(2, 0, 1);
+        indefinite(0, 0) = 1.0;
+        indefinite(0, 1) = 2.0;
+        indefinite(1, 1) = 1.0;
+        tens_t<double> rhs({2}, 1.0);
+        CHECK_THROWS_AS(solve_banded_spd(indefinite, rhs), std::runtime_error);
+    }
+
+    SUBCASE("Thomas algorithm") {
+        // 1D Poisson problem -u'' = 2 on (0, 1) with u(0) = u(1) = 0, exact solution x (1 - x).
+        const std::size_t n = 9;
+        const double h = 1.0 / static_cast<double>(n + 1);
+        tens_t<double> lower({n - 1}, -1.0);
+        tens_t<double> diagonal({n}, 2.0);
+        tens_t<double> upper({n - 1}, -1.0);
+        tens_t<double> rhs({n}, 2.0 * h * h);
+        auto u = solve_tridiagonal(lower, diagonal, upper, rhs);
+        for (std::size_t i = 0; i < n; ++i) {
+            const double x = static_cast<double>(i + 1) * h;
+            CHECK(u(i) == doctest::Approx(x * (1.0 - x)));
+        }
+
+        tens_t<double> two({n, 2}, 2.0 * h * h);
+        auto both = solve_tridiagonal(lower, diagonal, upper, two);
+        CHECK(both(4, 1) == doctest::Approx(u(4)));
+
+        tens_t<double> zero({2}, 0.0);
+        tens_t<double> off({1}, 1.0);
+        tens_t<double> ones({2}, 1.0);
+        CHECK_THROWS_AS(solve_tridiagonal(off, zero, off, ones), std::runtime_error);
+    }
+
+    SUBCASE("Thomas algorithm with quantities") {
+        // Springs in series: stiffness matrix times displacement equals force.
+        using stiffness = quantity<double, dim_div_t<dimensions::force_dim, dimensions::L>>;
+        tens_t<stiffness> lower({2}, stiffness(-1.0));
+        tens_t<stiffness> diagonal({3}, stiffness(2.0));
+        tens_t<stiffness> upper({2}, stiffness(-1.0));
+        tens_t<force_t<double>> load({3}, force_t<double>(1.0));
+        auto displacement = solve_tridiagonal(lower, diagonal, upper, load);
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(displacement(0))>, length_t<double>>);
+        CHECK(displacement(0).value() == doctest::Approx(1.5));
+        CHECK(displacement(1).value() == doctest::Approx(2.0));
+    }
+
+    SUBCASE("Batched systems match individual solves") {
+        const std::size_t n = 7;
+        const std::size_t m = 5;
+        tens_t<double> a({n - 1, m});
+        tens_t<double> b({n, m});
+        tens_t<double> c({n - 1, m});
+        tens_t<double> d({n, m});
+        for (std::size_t s = 0; s < m; ++s) {
+            for (std::size_t i = 0; i < n; ++i) {
+                b(i, s) = 4.0 + static_cast<double>(s);
+                d(i, s) = static_cast<double>(i * s) - 1.0;
+                if (i + 1 < n) {
+                    a(i, s) = -1.0 - 0.1 * static_cast<double>(i);
+                    c(i, s) = 0.5 * static_cast<double>(s);
+                }
+            }
+        }
+        auto x = solve_tridiagonal_batched(a, b, c, d);
+        REQUIRE(x.shape() == std::vector<std::size_t>{n, m});
+        for (std::size_t s = 0; s < m; ++s) {
+            auto single = solve_tridiagonal(a.subview({n - 1, 1}, {0, s}), b.subview({n, 1}, {0, s}),
+                                            c.subview({n - 1, 1}, {0, s}), d.subview({n, 1}, {0, s}));
+            for (std::size_t i = 0; i < n; ++i) {
+                CHECK(x(i, s) == doctest::Approx(single(i, 0)));
+            }
+        }
+        b(3, 2) = 0.0;
+        a(2, 2) = 0.0;
+        CHECK_THROWS_AS(solve_tridiagonal_batched(a, b, c, d), std::runtime_error);
+    }
+}
+
+TEST_CASE("Mixed-precision solve") {
+    SUBCASE("Refinement reaches double precision") {
+        const std::size_t n = 40;
+        tens_t<double> A({n, n});
+        tens_t<double> B({n, 2});
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                A(i, j) = (i == j ? 2.0 * n : 0.0) + std::sin(static_cast<double>(i * n + j) + 0.3);
+            }
+            B(i, 0) = std::cos(static_cast<double>(i));
+            B(i, 1) = 1.0 / (1.0 + static_cast<double>(i));
+        }
+        tens_t<double> A_copy = A;
+        tens_t<double> X = B;
+        auto info = solve_mixed(A, X);
+        CHECK_FALSE(info.fell_back);
+        CHECK(info.iterations >= 1);
+        CHECK(info.iterations <= 5);
+        CHECK(approx_equal(A, A_copy));
+        tens_t<double> expected = B;
+        solve(A_copy, expected);
+        for (std::size_t i = 0; i < n; ++i) {
+            CHECK(X(i, 0) == doctest::Approx(expected(i, 0)).epsilon(1e-13));
+            CHECK(X(i, 1) == doctest::Approx(expected(i, 1)).epsilon(1e-13));
+        }
+    }
+
+    SUBCASE("Fixed row major") {
+        tensor<double, shape<2, 2>, strides::row_major<shape<2, 2>>> A{{1.0, 3.0, 2.0, 4.0}};
+        tensor<double, shape<2>> B{5.0, 6.0};
+        auto info = solve_mixed(A, B);
+        CHECK_FALSE(info.fell_back);
+        CHECK(B(0) == doctest::Approx(-1));
+        CHECK(B(1) == doctest::Approx(2));
+    }
+
+    SUBCASE("Falls back when single precision is singular") {
+        tens_t<double> A({2, 2}, std::vector<double>{1.0, 1.0, 1.0, 1.0 + 1e-10});
+        tens_t<double> B({2}, std::vector<double>{2.0, 2.0 + 1e-10});
+        auto info = solve_mixed(A, B);
+        CHECK(info.fell_back);
+        CHECK(info.iterations == 0);
+        CHECK(B(0) == doctest::Approx(1.0));
+        CHECK(B(1) == doctest::Approx(1.0));
+    }
+
+    SUBCASE("Singular matrix") {
+        tens_t<double> A({2, 2}, std::vector<double>{1.0, 2.0, 2.0, 4.0});
+        tens_t<double> B({2}, std::vector<double>{1.0, 1.0});
+        CHECK_THROWS_AS(solve_mixed(A, B), std::runtime_error);
+    }
+}
+
 // NOLINTEND
\ No newline at end of file
@@ -1,4 +1,13 @@
 // NOLINTBEGIN
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
@@ -507,6 +516,25 @@ TEST_CASE("Matrix multiplication") {
             CHECK(c(1, 1) == doctest::Approx(71));
         }
     }
+
+    SUBCASE("Element types without BLAS") {
+        using cplx = std::complex<double>;
+        tensor<cplx, shape<2, 2>> a{cplx(1, 1), cplx(0, 2), cplx(3, 0), cplx(1, -1)};
+        tensor<cplx, shape<2, 2>> b{cplx(2, 0), cplx(0, 1), cplx(1, 1), cplx(4, 0)};
+        auto c = a * b;
+        CHECK(c(0, 0) == a(0, 0) * b(0, 0) + a(0, 1) * b(1, 0));
+        CHECK(c(1, 0) == a(1, 0) * b(0, 0) + a(1, 1) * b(1, 0));
+        CHECK(c(0, 1) == a(0, 0) * b(0, 1) + a(0, 1) * b(1, 1));
+        CHECK(c(1, 1) == a(1, 0) * b(0, 1) + a(1, 1) * b(1, 1));
+        auto ct = a.transpose() * b;
+        CHECK(ct(0, 1) == a(0, 0) * b(0, 1) + a(1, 0) * b(1, 1));
+
+        tensor<long double, dynamic, dynamic> x({2, 3}, std::vector<long double>{1, 4, 2, 5, 3, 6});
+        tensor<long double, dynamic, dynamic> y({3, 2}, std::vector<long double>{1, 4, 2, 5, 3, 6});
+        auto z = x * y;
+        CHECK(z(0, 0) == 15);
+        CHECK(z(1, 1) == 71);
+    }
 }
 #ifdef SQUINT_USE_CUDA
 TEST_CASE("Matrix multiplication device") {
@@ -769,4 +797,1213 @@ TEST_CASE("Tensor Ops Type Deduction") {
     static_assert(std::is_same_v<decltype(h), tensor<velocity, shape<2, 2>>>, "Type deduction failed");
 }
 
+TEST_CASE("Expiring operands reuse storage") {
+    SUBCASE("Fixed tensors") {
+        tensor<float, shape<2, 2>> a{1.0F, 2.0F, 3.0F, 4.0F};
+        tensor<float, shape<2, 2>> b{5.0F, 6.0F, 7.0F, 8.0F};
+
+        auto c = a.copy() + b;
+        static_assert(std::is_same_v<decltype(c), tensor<float, shape<2, 2>>>, "Type deduction failed");
+        CHECK(c(0, 0) == doctest::Approx(6.0F));
+        CHECK(c(1, 1) == doctest::Approx(12.0F));
+
+        auto d = b - std::move(c);
+        CHECK(d(0, 0) == doctest::Approx(-1.0F));
+        CHECK(d(1, 1) == doctest::Approx(-4.0F));
+
+        auto e = -std::move(d);
+        CHECK(e(0, 1) == doctest::Approx(3.0F));
+
+        auto f = 2.0F * (std::move(e) / 4.0F);
+        CHECK(f(0, 0) == doctest::Approx(0.5F));
+        CHECK(f(1, 1) == doctest::Approx(2.0F));
+    }
+
+    SUBCASE("Dynamic tensors") {
+        tensor<float, dynamic, dynamic> a({2, 3}, std::vector<float>{1, 2, 3, 4, 5, 6});
+        tensor<float, dynamic, dynamic> b({2, 3}, std::vector<float>{6, 5, 4, 3, 2, 1});
+
+        auto t = a.copy();
+        const auto *storage = t.data();
+        auto c = (std::move(t) + b) * 2.0F - a;
+        CHECK(c.data() == storage);
+        CHECK(c(0, 0) == doctest::Approx(13.0F));
+        CHECK(c(1, 2) == doctest::Approx(8.0F));
+    }
+
+    SUBCASE("Views and type changes still copy") {
+        tensor<length, shape<2, 2>> a{length(1.0F), length(2.0F), length(3.0F), length(4.0F)};
+        auto b = a.transpose() + a;
+        CHECK(b(0, 1) == length(5.0F));
+
+        auto t = a.copy();
+        const auto *storage = t.data();
+        auto c = std::move(t) * length(2.0F);
+        static_assert(std::is_same_v<decltype(c), tensor<area, shape<2, 2>>>, "Type deduction failed");
+        CHECK(c(1, 1).value() == doctest::Approx(8.0F));
+        CHECK(static_cast<const void *>(c.data()) != static_cast<const void *>(storage));
+    }
+}
+
+TEST_CASE("Sliding windows") {
+    SUBCASE("Overlapping window view") {
+        tensor<float, shape<6>> a{1, 2, 3, 4, 5, 6};
+        auto windows = sliding_window_view(a, {3});
+        CHECK(windows.shape() == std::vector<std::size_t>{4, 3});
+        CHECK(windows.data() == a.data());
+        CHECK(windows(0, 2) == 3);
+        CHECK(windows(3, 0) == 4);
+        CHECK(windows(3, 2) == 6);
+
+        auto strided = sliding_window_view(a, {2}, {2});
+        CHECK(strided.shape() == std::vector<std::size_t>{3, 2});
+        CHECK(strided(2, 1) == 6);
+
+        const auto &c = a;
+        auto const_windows = sliding_window_view(c, {3});
+        static_assert(std::is_const_v<std::remove_pointer_t<decltype(const_windows.data())>>);
+        CHECK(const_windows(1, 1) == 3);
+    }
+
+    SUBCASE("2D window view") {
+        tensor<float, dynamic, dynamic> a({3, 4}, std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+        auto windows = sliding_window_view(a, {2, 2});
+        CHECK(windows.shape() == std::vector<std::size_t>{2, 3, 2, 2});
+        CHECK(windows(1, 2, 0, 0) == a(1, 2));
+        CHECK(windows(1, 2, 1, 1) == a(2, 3));
+    }
+
+    SUBCASE("Window reductions") {
+        tensor<float, dynamic, dynamic> a({8}, std::vector<float>{3, 1, 4, 1, 5, 9, 2, 6});
+        auto sums = window_sum(a, {3});
+        auto means = window_mean(a, {3});
+        auto maxima = window_max(a, {3});
+        auto minima = window_min(a, {3}, {2});
+        REQUIRE(sums.shape() == std::vector<std::size_t>{6});
+        REQUIRE(minima.shape() == std::vector<std::size_t>{3});
+        std::vector<float> expected_sums{8, 6, 10, 15, 16, 17};
+        std::vector<float> expected_maxima{4, 4, 5, 9, 9, 9};
+        std::vector<float> expected_minima{1, 1, 2};
+        for (std::size_t i = 0; i < 6; ++i) {
+            CHECK(sums(i) == doctest::Approx(expected_sums[i]));
+            CHECK(means(i) == doctest::Approx(expected_sums[i] / 3.0F));
+            CHECK(maxima(i) == expected_maxima[i]);
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            CHECK(minima(i) == expected_minima[i]);
+        }
+    }
+
+    SUBCASE("2D reductions match the window view") {
+        auto a = tensor<float, dynamic, dynamic>::random(-1.0F, 1.0F, {7, 9});
+        auto sums = window_sum(a, {3, 2}, {2, 1});
+        auto maxima = window_max(a, {3, 2}, {2, 1});
+        auto windows = sliding_window_view(a, {3, 2}, {2, 1});
+        REQUIRE(sums.shape() == std::vector<std::size_t>{3, 8});
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 8; ++j) {
+                float sum = 0;
+                float max = windows(i, j, 0, 0);
+                for (std::size_t k = 0; k < 3; ++k) {
+                    for (std::size_t l = 0; l < 2; ++l) {
+                        sum += windows(i, j, k, l);
+                        max = std::max(max, windows(i, j, k, l));
+                    }
+                }
+                CHECK(sums(i, j) == doctest::Approx(sum));
+                CHECK(maxima(i, j) == max);
+            }
+        }
+    }
+
+    SUBCASE("Quantities") {
+        tensor<length, shape<4>> a{length(1.0F), length(2.0F), length(3.0F), length(4.0F)};
+        auto means = window_mean(a, {2});
+        static_assert(std::is_same_v<decltype(means)::value_type, length>);
+        CHECK(means(2).value() == doctest::Approx(3.5F));
+    }
+
+    SUBCASE("Long signals keep their precision") {
+        const std::size_t n = std::size_t{1} << 21;
+        std::vector<float> samples(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            samples[i] = 100.0F + static_cast<float>((i * 7919) % 1001) / 1000.0F - 0.5F;
+        }
+        tensor<float, dynamic, dynamic> a({n}, samples);
+        auto sums = window_sum(a, {3});
+        auto sparse = window_sum(a, {5}, {4});
+        for (std::size_t p : {std::size_t{0}, n / 2 + 1, n - 3}) {
+            CHECK(sums(p) == doctest::Approx(samples[p] + samples[p + 1] + samples[p + 2]).epsilon(1e-6));
+        }
+        const std::size_t last = sparse.shape()[0] - 1;
+        float expected = 0;
+        for (std::size_t k = 0; k < 5; ++k) {
+            expected += samples[last * 4 + k];
+        }
+        CHECK(sparse(last) == doctest::Approx(expected).epsilon(1e-6));
+    }
+
+    SUBCASE("Invalid windows") {
+        tensor<float, dynamic, dynamic, error_checking::enabled> a({4});
+        CHECK_THROWS_AS(sliding_window_view(a, {5}), std::invalid_argument);
+        CHECK_THROWS_AS(window_sum(a, {2, 2}), std::invalid_argument);
+        CHECK_THROWS_AS(window_max(a, {2}, {0}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Gram matrices") {
+    SUBCASE("Fixed matrices") {
+        tensor<double, shape<3, 2>> A({1, 2, 3, 4, 5, 6});
+        auto G = gram(A);
+        static_assert(std::is_same_v<decltype(G)::shape_type, shape<2, 2>>);
+        CHECK(G(0, 0) == doctest::Approx(14));
+        CHECK(G(0, 1) == doctest::Approx(32));
+        CHECK(G(1, 1) == doctest::Approx(77));
+        CHECK(G(1, 0) == 0);
+        auto full = gram(A, fill_mode::full);
+        CHECK(full(1, 0) == doctest::Approx(32));
+
+        auto O = outer_gram(A, fill_mode::full);
+        static_assert(std::is_same_v<decltype(O)::shape_type, shape<3, 3>>);
+        auto expected = A * A.transpose().copy();
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                CHECK(O(i, j) == doctest::Approx(expected(i, j)));
+            }
+        }
+    }
+
+    SUBCASE("Products with the own transpose use the symmetric kernel") {
+        tens_t<double> X({4, 3});
+        for (std::size_t j = 0; j < 3; ++j) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                X(i, j) = static_cast<double>(i * 3 + j) - 4.0;
+            }
+        }
+        auto Xt = X.transpose().copy();
+        auto general = Xt * X;
+        auto detected = X.transpose() * X;
+        auto outer = X * X.transpose();
+        auto outer_general = X * Xt;
+        REQUIRE(detected.shape() == std::vector<std::size_t>{3, 3});
+        REQUIRE(outer.shape() == std::vector<std::size_t>{4, 4});
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                CHECK(detected(i, j) == doctest::Approx(general(i, j)));
+            }
+        }
+        for (std::size_t i = 0; i < 4; ++i) {
+            for (std::size_t j = 0; j < 4; ++j) {
+                CHECK(outer(i, j) == doctest::Approx(outer_general(i, j)));
+            }
+        }
+
+        tens_t<double> row_major({4, 3}, layout::row_major);
+        for (std::size_t j = 0; j < 3; ++j) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                row_major(i, j) = X(i, j);
+            }
+        }
+        auto from_row_major = gram(row_major, fill_mode::full);
+        auto outer_row_major = outer_gram(row_major, fill_mode::full);
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                CHECK(from_row_major(i, j) == doctest::Approx(general(i, j)));
+            }
+        }
+        CHECK(outer_row_major(3, 1) == doctest::Approx(outer_general(3, 1)));
+    }
+
+    SUBCASE("Quantities") {
+        tens_t<length_t<double>> A({2, 2});
+        A(0, 0) = length_t<double>(1.0);
+        A(1, 0) = length_t<double>(2.0);
+        A(0, 1) = length_t<double>(3.0);
+        A(1, 1) = length_t<double>(4.0);
+        auto G = gram(A, fill_mode::full);
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(G(0, 0))>, area_t<double>>);
+        CHECK(G(1, 0).value() == doctest::Approx(11.0));
+    }
+
+    SUBCASE("Element types without SYRK") {
+        using cplx = std::complex<double>;
+        tensor<cplx, shape<2, 2>> C{cplx(1, 1), cplx(0, 2), cplx(3, 0), cplx(1, -1)};
+        auto G = gram(C, fill_mode::full);
+        CHECK(G(0, 1) == C(0, 0) * C(0, 1) + C(1, 0) * C(1, 1));
+        CHECK(G(1, 0) == G(0, 1));
+        CHECK(G(1, 1) == C(0, 1) * C(0, 1) + C(1, 1) * C(1, 1));
+
+        using d1 = dual<double, 1>;
+        tens_t<d1> D({2, 2}, std::vector<d1>{d1::variable(1.0, 0), 2.0, 3.0, 4.0}, layout::column_major);
+        auto H = gram(D, fill_mode::full);
+        CHECK(H(0, 0).value() == doctest::Approx(5.0));
+        CHECK(H(0, 0).derivative(0) == doctest::Approx(2.0));
+        CHECK(H(1, 0).value() == doctest::Approx(11.0));
+        CHECK(H(1, 0).derivative(0) == doctest::Approx(3.0));
+
+        tens_t<long double> L({3, 2}, std::vector<long double>{1, 2, 3, 4, 5, 6});
+        auto outer = outer_gram(L, fill_mode::full);
+        CHECK(outer(2, 0) == 3 + 24);
+    }
+}
+
+TEST_CASE("Matrix chain products") {
+    SUBCASE("Optimal order") {
+        constexpr auto split = detail::chain_splits<3>(std::array<std::size_t, 4>{10, 30, 5, 60});
+        static_assert(split[0 * 3 + 2] == 1); // (A B) C
+        constexpr auto vector_split = detail::chain_splits<3>(std::array<std::size_t, 4>{50, 50, 50, 1});
+        static_assert(vector_split[0 * 3 + 2] == 0); // A (B v)
+    }
+
+    SUBCASE("Fixed factors") {
+        tensor<double, shape<2, 3>> A({1, 2, 3, 4, 5, 6});
+        tensor<double, shape<3, 3>> B({1, 0, 2, -1, 3, 1, 0, 1, 1});
+        tensor<double, shape<3>> v{1, -2, 0.5};
+        auto result = multi_dot(A, B, v);
+        auto expected = (A * B) * v;
+        static_assert(std::is_same_v<decltype(result), decltype(expected)>);
+        for (std::size_t i = 0; i < 2; ++i) {
+            CHECK(result(i) == doctest::Approx(expected(i)));
+        }
+    }
+
+    SUBCASE("Dynamic and mixed factors") {
+        tens_t<double> A({4, 4});
+        tens_t<double> B({4, 4});
+        tens_t<double> C({4, 2});
+        for (std::size_t j = 0; j < 4; ++j) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                A(i, j) = static_cast<double>(i + j);
+                B(i, j) = static_cast<double>(i) - static_cast<double>(j);
+                if (j < 2) {
+                    C(i, j) = static_cast<double>(i * j) + 1.0;
+                }
+            }
+        }
+        tensor<double, shape<2>> w{1.0, 2.0};
+        auto result = multi_dot(A, B, C, w);
+        auto expected = ((A * B) * C) * w;
+        REQUIRE(result.shape() == expected.shape());
+        for (std::size_t i = 0; i < 4; ++i) {
+            CHECK(result(i) == doctest::Approx(expected(i)));
+        }
+    }
+
+    SUBCASE("Quantities") {
+        tensor<length_t<double>, shape<2, 2>> L({length_t<double>(1.0), length_t<double>(0.0),
+                                                 length_t<double>(0.0), length_t<double>(2.0)});
+        tensor<double, shape<2, 2>> R({0.0, 1.0, -1.0, 0.0});
+        tensor<duration_t<double>, shape<2>> t{duration_t<double>(1.0), duration_t<double>(3.0)};
+        auto product = multi_dot(L, R, t);
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(product(0))>,
+                                     decltype(length_t<double>() * duration_t<double>())>);
+        CHECK(product(0).value() == doctest::Approx(-3.0));
+        CHECK(product(1).value() == doctest::Approx(2.0));
+    }
+}
+
+TEST_CASE("Fused comparisons") {
+    SUBCASE("all_equal and any_not_equal") {
+        tensor<double, dynamic, dynamic> a({20, 50});
+        for (std::size_t j = 0; j < 50; ++j) {
+            for (std::size_t i = 0; i < 20; ++i) {
+                a(i, j) = static_cast<double>(i * 50 + j);
+            }
+        }
+        auto b = a.copy();
+        CHECK(all_equal(a, b));
+        CHECK_FALSE(any_not_equal(a, b));
+        b(19, 49) = -1.0;
+        CHECK_FALSE(all_equal(a, b));
+        CHECK(any_not_equal(a, b));
+        b(19, 49) = a(19, 49);
+        b(0, 0) = -1.0;
+        CHECK_FALSE(all_equal(a, b));
+
+        tensor<double, dynamic, dynamic> c({50, 20});
+        CHECK_FALSE(all_equal(a, c));
+        CHECK(any_not_equal(a, c));
+    }
+
+    SUBCASE("Different layouts and views") {
+        tensor<float, shape<2, 3>> a{1, 2, 3, 4, 5, 6};
+        tensor<float, shape<2, 3>, strides::row_major<shape<2, 3>>> b{1, 3, 5, 2, 4, 6};
+        CHECK(all_equal(a, b));
+        b(1, 2) = 0;
+        CHECK(any_not_equal(a, b));
+
+        tensor<float, shape<3, 2>> t{1, 3, 5, 2, 4, 6};
+        CHECK(all_equal(a, t.transpose()));
+        CHECK(all_equal(a.subview<2, 2>(0, 1), t.transpose().subview<2, 2>(0, 1)));
+        CHECK(approx_equal(a.subview<2, 1>(0, 2), t.transpose().subview<2, 1>(0, 2)));
+    }
+
+    SUBCASE("count_if") {
+        tensor<int, dynamic, dynamic> a({30, 30});
+        int value = 0;
+        for (auto &element : a) {
+            element = value++ - 450;
+        }
+        CHECK(count_if(a, [](int x) { return x < 0; }) == 450);
+        CHECK(count_if(a.transpose(), [](int x) { return x % 2 == 0; }) == 450);
+        CHECK(count_if(a.subview({10, 10}, {5, 5}), [](int x) { return x > 1000; }) == 0);
+    }
+
+    SUBCASE("approx_all_close") {
+        tensor<double, shape<3>> a{1.0, 100.0, 0.0};
+        tensor<double, shape<3>> b{1.0 + 1e-7, 100.0 + 5e-4, 1e-9};
+        CHECK(approx_all_close(a, b));
+        CHECK_FALSE(approx_all_close(a, b, 1e-8));
+        b(2) = std::numeric_limits<double>::quiet_NaN();
+        CHECK_FALSE(approx_all_close(a, b));
+
+        tensor<length, shape<2>> x{length(1.0F), length(2.0F)};
+        tensor<length, shape<2>> y{length(1.000001F), length(2.0F)};
+        CHECK(approx_all_close(x, y));
+        CHECK_FALSE(approx_all_close(x, y, 1e-8F, 0.0F));
+    }
+}
+
+TEST_CASE("Masked selection") {
+    SUBCASE("bit_mask") {
+        tensor<int, dynamic, dynamic> a({10, 13});
+        int value = 0;
+        for (auto &element : a) {
+            element = value++;
+        }
+        auto even = make_mask(a, [](int x) { return x % 2 == 0; });
+        CHECK(even.shape() == std::vector<std::size_t>{10, 13});
+        CHECK(even.size() == 130);
+        CHECK(even.words().size() == 3);
+        CHECK(even.count() == 65);
+        CHECK(even.test(4));
+        CHECK_FALSE(even.test(5));
+        CHECK((~even).count() == 65);
+        auto small = make_mask(a, [](int x) { return x < 10; });
+        CHECK((even & small).count() == 5);
+        CHECK((even | small).count() == 70);
+
+        bit_mask packed(a == a);
+        CHECK(packed.count() == 130);
+        packed.set(7, false);
+        CHECK(packed.count() == 129);
+        CHECK(bit_mask({3, 3}, true).count() == 9);
+    }
+
+    SUBCASE("where") {
+        tensor<float, shape<2, 3>> a{1, 2, 3, 4, 5, 6};
+        tensor<float, shape<2, 3>> b{6, 5, 4, 3, 2, 1};
+        auto larger = where(make_mask(a, [](float x) { return x > 3; }), a, -b);
+        tensor<float, shape<2, 3>> expected{-6, -5, -4, 4, 5, 6};
+        CHECK(all_equal(larger, expected));
+
+        tensor<std::uint8_t, shape<2, 3>> select{1, 0, 1, 0, 1, 0};
+        auto mixed = where(select, a, b);
+        CHECK(all_equal(mixed, tensor<float, shape<2, 3>>{1, 5, 3, 3, 5, 1}));
+
+        tensor<float, shape<3, 2>> t{1, 3, 5, 2, 4, 6};
+        auto from_view = where(select, t.transpose(), b);
+        CHECK(all_equal(from_view, mixed));
+        auto with_view = where(select.transpose().transpose(), a, b.transpose().transpose());
+        CHECK(all_equal(with_view, mixed));
+    }
+
+    SUBCASE("masked_assign") {
+        tensor<double, dynamic, dynamic> a({3, 2}, std::vector<double>{-1, 2, -3, 4, -5, 6});
+        masked_assign(a, make_mask(a, [](double x) { return x < 0; }), 0.0);
+        CHECK(all_equal(a, tensor<double, dynamic, dynamic>({3, 2}, std::vector<double>{0, 2, 0, 4, 0, 6})));
+
+        tensor<double, dynamic, dynamic> source({3, 2}, 9.0);
+        auto row_major = tensor<double, dynamic, dynamic>({3, 2}, std::vector<double>{1, 2, 3, 4, 5, 6},
+                                                          layout::row_major);
+        masked_assign(row_major, row_major == a, source);
+        CHECK(row_major(2, 1) == 9.0);
+        CHECK(row_major(0, 1) == 2.0);
+        CHECK(row_major(0, 0) == 1.0);
+        CHECK(compress(row_major == source, row_major).size() == 1);
+
+        auto column = a.subview({3, 1}, {0, 1});
+        masked_assign(column, bit_mask({3, 1}, true), 7.0);
+        CHECK(a(2, 1) == 7.0);
+        CHECK(a(2, 0) == 0.0);
+    }
+
+    SUBCASE("compress") {
+        tensor<int, shape<2, 3>> a{1, 2, 3, 4, 5, 6};
+        auto odd = compress(make_mask(a, [](int x) { return x % 2 != 0; }), a);
+        CHECK(odd.shape() == std::vector<std::size_t>{3});
+        CHECK(odd(0) == 1);
+        CHECK(odd(1) == 3);
+        CHECK(odd(2) == 5);
+        CHECK(compress(bit_mask({2, 3}), a).size() == 0);
+
+        tensor<int, shape<3, 2>> t{1, 3, 5, 2, 4, 6};
+        auto transposed = compress(a == t.transpose(), t.transpose());
+        CHECK(transposed.size() == 6);
+        CHECK(transposed(1) == 2);
+
+        tensor<int, dynamic, dynamic, error_checking::enabled> checked({2, 2}, 1);
+        CHECK_THROWS_AS(compress(bit_mask({3, 2}), checked), std::runtime_error);
+    }
+}
+
+TEST_CASE("Gather and scatter") {
+    SUBCASE("take rows and columns") {
+        tensor<double, dynamic, dynamic> vertices({4, 3}, std::vector<double>{0, 1, 2, 3, 10, 11, 12, 13, 20, 21, 22,
+                                                                             23});
+        std::vector<std::size_t> face{3, 0, 3};
+        auto corners = take(vertices, face, 0);
+        CHECK(corners.shape() == std::vector<std::size_t>{3, 3});
+        for (std::size_t j = 0; j < 3; ++j) {
+            for (std::size_t k = 0; k < 3; ++k) {
+                CHECK(corners(j, k) == vertices(face[j], k));
+            }
+        }
+
+        tensor<int, shape<2>> columns{2, 1};
+        auto selected = take(vertices, columns, 1);
+        CHECK(selected.shape() == std::vector<std::size_t>{4, 2});
+        CHECK(selected(1, 0) == 21);
+        CHECK(selected(3, 1) == 13);
+
+        auto transposed = take(vertices.transpose(), face, 1);
+        CHECK(all_equal(transposed, corners.transpose()));
+
+        tensor<double, dynamic, dynamic> row_major({4, 3}, 0.0, layout::row_major);
+        row_major = vertices;
+        CHECK(all_equal(take(row_major, face, 0), corners));
+
+        auto flat = take(vertices, std::vector<int>{5, 0, 11});
+        CHECK(flat.shape() == std::vector<std::size_t>{3});
+        CHECK(flat(0) == 11);
+        CHECK(flat(2) == 23);
+        CHECK(take(vertices.transpose(), std::vector<int>{1})(0) == 10);
+    }
+
+    SUBCASE("index_select into existing tensor") {
+        tensor<float, shape<2, 3, 2>> t;
+        float value = 0;
+        for (auto &element : t) {
+            element = value++;
+        }
+        tensor<float, shape<2, 2, 2>> result;
+        index_select(t, std::vector<std::size_t>{2, 0}, 1, result);
+        CHECK(result(1, 0, 1) == t(1, 2, 1));
+        CHECK(result(0, 1, 0) == t(0, 0, 0));
+    }
+
+    SUBCASE("scatter_add") {
+        tensor<double, dynamic, dynamic> out({3, 2}, 0.0);
+        tensor<double, dynamic, dynamic> values({4, 2}, std::vector<double>{1, 2, 3, 4, 10, 20, 30, 40});
+        std::vector<std::size_t> rows{2, 0, 2, 2};
+        scatter_add(out, rows, values, 0);
+        CHECK(out(0, 0) == 2);
+        CHECK(out(1, 0) == 0);
+        CHECK(out(2, 0) == 8);
+        CHECK(out(2, 1) == 80);
+
+        tensor<double, dynamic, dynamic> counts({100}, 0.0);
+        std::vector<std::size_t> bins;
+        for (std::size_t k = 0; k < 1000; ++k) {
+            bins.push_back((k * 37) % 100);
+        }
+        scatter_add(counts, bins, tensor<double, dynamic, dynamic>({1000}, 1.0), 0);
+        CHECK(sum(counts) == 1000);
+        CHECK(counts(0) == 10);
+
+        tensor<double, dynamic, dynamic> wide({2, 100}, 1.0);
+        tensor<double, dynamic, dynamic> updates({3, 100}, 2.0);
+        scatter_add(wide, std::vector<std::size_t>{1, 1, 0}, updates, 0);
+        CHECK(wide(1, 99) == 5.0);
+        CHECK(wide(0, 50) == 3.0);
+    }
+
+    SUBCASE("Error checking") {
+        tensor<double, dynamic, dynamic, error_checking::enabled> t({3, 2}, 1.0);
+        CHECK_THROWS_AS(take(t, std::vector<int>{3}, 0), std::out_of_range);
+        CHECK_THROWS_AS(take(t, std::vector<int>{-1}, 1), std::out_of_range);
+        CHECK_THROWS_AS(take(t, std::vector<int>{0}, 2), std::invalid_argument);
+        tensor<double, dynamic, dynamic, error_checking::enabled> values({2, 3}, 1.0);
+        CHECK_THROWS_AS(scatter_add(t, std::vector<int>{0, 1}, values, 0), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Concatenation and stacking") {
+    SUBCASE("Fixed tensors") {
+        tensor<int, shape<2, 3>> a{1, 2, 3, 4, 5, 6};
+        tensor<int, shape<1, 3>> b{7, 8, 9};
+        auto rows = concatenate<0>(a, b);
+        static_assert(std::is_same_v<decltype(rows), tensor<int, shape<3, 3>>>);
+        CHECK(rows(0, 1) == 3);
+        CHECK(rows(2, 0) == 7);
+        CHECK(rows(2, 2) == 9);
+
+        tensor<int, shape<2, 1>> c{10, 11};
+        auto columns = concatenate<1>(a, c, a);
+        static_assert(std::is_same_v<decltype(columns), tensor<int, shape<2, 7>>>);
+        CHECK(columns(1, 3) == 11);
+        CHECK(columns(0, 4) == 1);
+        CHECK(columns(1, 6) == 6);
+
+        tensor<int, shape<3>> u{1, 2, 3};
+        tensor<int, shape<3>> v{4, 5, 6};
+        auto as_columns = stack<1>(u, v);
+        static_assert(std::is_same_v<decltype(as_columns), tensor<int, shape<3, 2>>>);
+        CHECK(as_columns(2, 1) == 6);
+        auto as_rows = stack<0>(u, v);
+        static_assert(std::is_same_v<decltype(as_rows), tensor<int, shape<2, 3>>>);
+        CHECK(as_rows(1, 0) == 4);
+        CHECK(as_rows(0, 2) == 3);
+    }
+
+    SUBCASE("Dynamic tensors and mixed layouts") {
+        tensor<double, dynamic, dynamic> a({2, 3}, std::vector<double>{1, 2, 3, 4, 5, 6});
+        tensor<double, dynamic, dynamic> b({2, 3}, std::vector<double>{1, 2, 3, 4, 5, 6}, layout::row_major);
+        tensor<double, shape<3, 2>> t{10, 20, 30, 40, 50, 60};
+        auto joined = concatenate(1, a, b, t.transpose());
+        CHECK(joined.shape() == std::vector<std::size_t>{2, 9});
+        for (std::size_t i = 0; i < 2; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                CHECK(joined(i, j) == a(i, j));
+                CHECK(joined(i, j + 3) == b(i, j));
+                CHECK(joined(i, j + 6) == t(j, i));
+            }
+        }
+        auto stacked = stack(2, a, b);
+        CHECK(stacked.shape() == std::vector<std::size_t>{2, 3, 2});
+        CHECK(stacked(1, 2, 0) == a(1, 2));
+        CHECK(stacked(1, 2, 1) == b(1, 2));
+        auto middle = stack(1, a, b);
+        CHECK(middle.shape() == std::vector<std::size_t>{2, 2, 3});
+        CHECK(middle(0, 1, 2) == b(0, 2));
+    }
+
+    SUBCASE("concat_into") {
+        tensor<float, shape<4, 2>> out;
+        tensor<float, shape<1, 2>> first{1, 2};
+        tensor<float, dynamic, dynamic> rest({3, 2}, 5.0F);
+        concat_into(out, 0, first, rest);
+        CHECK(out(0, 1) == 2);
+        CHECK(out(3, 1) == 5);
+
+        tensor<float, dynamic, dynamic> big({4, 4}, 0.0F, layout::row_major);
+        auto block = big.subview({4, 2}, {0, 1});
+        concat_into(block, 0, first, rest);
+        CHECK(big(0, 2) == 2);
+        CHECK(big(0, 3) == 0);
+        CHECK(big(2, 1) == 5);
+    }
+
+    SUBCASE("Error checking") {
+        tensor<double, dynamic, dynamic, error_checking::enabled> a({2, 3}, 1.0);
+        tensor<double, dynamic, dynamic, error_checking::enabled> b({3, 2}, 1.0);
+        CHECK_THROWS_AS(concatenate(0, a, b), std::invalid_argument);
+        CHECK_THROWS_AS(stack(0, a, b), std::invalid_argument);
+        CHECK_THROWS_AS(stack(3, a, a), std::invalid_argument);
+        tensor<double, dynamic, dynamic, error_checking::enabled> out({3, 3}, 0.0);
+        CHECK_THROWS_AS(concat_into(out, 0, a), std::invalid_argument);
+        CHECK(concatenate(0, a, a).shape() == std::vector<std::size_t>{4, 3});
+    }
+}
+
+TEST_CASE("Sorting and selection") {
+    SUBCASE("sort along axes and views") {
+        tensor<double, dynamic, dynamic> a({3, 4}, std::vector<double>{3, 1, 2, 9, 7, 8, 4, 6, 5, 0, 11, 10});
+        auto by_column = a.copy();
+        sort(by_column, 0);
+        CHECK(by_column(0, 0) == 1);
+        CHECK(by_column(2, 0) == 3);
+        CHECK(by_column(0, 3) == 0);
+        CHECK(by_column(2, 3) == 11);
+
+        auto by_row = a.copy();
+        sort(by_row, 1, std::greater<>{});
+        CHECK(by_row(0, 0) == 9);
+        CHECK(by_row(0, 3) == 0);
+        CHECK(by_row(1, 0) == 11);
+
+        auto view = a.subview({2, 4}, {1, 0});
+        sort(view, 1);
+        CHECK(a(1, 0) == 1);
+        CHECK(a(1, 3) == 11);
+        CHECK(a(0, 0) == 3);
+
+        tensor<int, dynamic, dynamic> lines({100, 3});
+        for (std::size_t i = 0; i < 100; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                lines(i, j) = static_cast<int>((i * 37 + j * 11) % 101);
+            }
+        }
+        auto long_sorted = lines.copy();
+        sort(long_sorted, 0);
+        auto transposed = lines.copy();
+        auto view_t = transposed.transpose();
+        sort(view_t, 1);
+        for (std::size_t j = 0; j < 3; ++j) {
+            for (std::size_t i = 0; i + 1 < 100; ++i) {
+                CHECK(long_sorted(i, j) <= long_sorted(i + 1, j));
+            }
+        }
+        CHECK(all_equal(long_sorted, transposed));
+    }
+
+    SUBCASE("short lines are permuted, not rewritten") {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        // Sorted bit patterns identify the multiset of values, including signed zeros and NaN
+        auto bits = [](const auto &t) {
+            std::vector<std::uint64_t> out;
+            for (const double v : t) {
+                out.push_back(std::bit_cast<std::uint64_t>(v));
+            }
+            std::sort(out.begin(), out.end());
+            return out;
+        };
+        const std::vector<std::vector<double>> inputs{
+            {0.0, -0.0, -1.0}, {2.0, nan}, {0.0, -0.0, nan, 1.0}, {nan, 3.0, -0.0, 0.0}};
+        for (const auto &values : inputs) {
+            tensor<double, dynamic, dynamic> a({values.size()}, values);
+            auto ascending = a.copy();
+            sort(ascending);
+            CHECK(bits(ascending) == bits(a));
+            auto descending = a.copy();
+            sort(descending, 0, std::greater<>{});
+            CHECK(bits(descending) == bits(a));
+        }
+        tensor<double, dynamic, dynamic> zeros({3}, std::vector<double>{0.0, -0.0, -1.0});
+        sort(zeros);
+        CHECK(zeros(0) == -1.0);
+        CHECK(std::signbit(zeros(1)) != std::signbit(zeros(2)));
+    }
+
+    SUBCASE("argsort") {
+        tensor<float, shape<2, 3>> a{3, 1, 1, 5, 2, 0};
+        auto order = argsort(a, 1);
+        CHECK(order.shape() == std::vector<std::size_t>{2, 3});
+        CHECK(order(0, 0) == 1);
+        CHECK(order(0, 1) == 2);
+        CHECK(order(0, 2) == 0);
+        CHECK(order(1, 0) == 2);
+        CHECK(order(1, 1) == 0);
+        CHECK(order(1, 2) == 1);
+        auto stable = argsort(tensor<int, shape<4>>{2, 1, 2, 1});
+        CHECK(stable(0) == 1);
+        CHECK(stable(1) == 3);
+        CHECK(stable(2) == 0);
+    }
+
+    SUBCASE("partition") {
+        tensor<int, dynamic, dynamic> a({7, 2}, std::vector<int>{5, 3, 9, 1, 7, 2, 8, 14, 10, 12, 13, 11, 9, 8});
+        partition(a, 3, 0);
+        CHECK(a(3, 0) == 5);
+        CHECK(a(3, 1) == 11);
+        for (std::size_t i = 0; i < 3; ++i) {
+            CHECK(a(i, 0) <= 5);
+            CHECK(a(i + 4, 1) >= 11);
+        }
+        tensor<int, dynamic, dynamic, error_checking::enabled> checked({3}, 0);
+        CHECK_THROWS_AS(partition(checked, 3), std::invalid_argument);
+    }
+
+    SUBCASE("topk") {
+        tensor<double, dynamic, dynamic> scores({2, 1000});
+        for (std::size_t j = 0; j < 1000; ++j) {
+            scores(0, j) = static_cast<double>((j * 7919) % 1000);
+            scores(1, j) = -static_cast<double>(j);
+        }
+        auto best = topk(scores, 3, 1);
+        CHECK(best.values.shape() == std::vector<std::size_t>{2, 3});
+        CHECK(best.values(0, 0) == 999);
+        CHECK(best.values(0, 2) == 997);
+        CHECK(scores(0, best.indices(0, 1)) == 998);
+        CHECK(best.values(1, 0) == 0);
+        CHECK(best.indices(1, 2) == 2);
+
+        auto worst = topk(scores, 2, 1, false);
+        CHECK(worst.values(0, 0) == 0);
+        CHECK(worst.values(1, 0) == -999);
+        CHECK(worst.indices(1, 1) == 998);
+
+        tensor<int, shape<5>> ties{4, 1, 4, 2, 4};
+        auto tied = topk(ties, 2);
+        CHECK(tied.indices(0) == 0);
+        CHECK(tied.indices(1) == 2);
+    }
+}
+
+TEST_CASE("Statistics") {
+    // Observations with a large common offset, where a one-pass sum of squares loses precision
+    const std::size_t n = 1000;
+    tensor<double, dynamic, dynamic> X({n, 3});
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto v = static_cast<double>((i * 37) % 101);
+        X(i, 0) = 1e6 + v;
+        X(i, 1) = 1e6 - 2 * v + static_cast<double>(i % 7);
+        X(i, 2) = 5.0;
+    }
+    // Naive two-pass reference
+    tensor<double, dynamic, dynamic> expected({3, 3}, 0.0);
+    std::vector<double> mean(3, 0.0);
+    for (std::size_t j = 0; j < 3; ++j) {
+        for (std::size_t i = 0; i < n; ++i) {
+            mean[j] += X(i, j) / static_cast<double>(n);
+        }
+    }
+    for (std::size_t a = 0; a < 3; ++a) {
+        for (std::size_t b = 0; b < 3; ++b) {
+            for (std::size_t i = 0; i < n; ++i) {
+                expected(a, b) += (X(i, a) - mean[a]) * (X(i, b) - mean[b]) / static_cast<double>(n - 1);
+            }
+        }
+    }
+
+    SUBCASE("covariance and correlation") {
+        auto C = covariance(X);
+        CHECK(C.shape() == std::vector<std::size_t>{3, 3});
+        CHECK(approx_all_close(C, expected, 1e-9, 1e-9));
+        auto population = covariance(X, 0);
+        CHECK(population(0, 0) == doctest::Approx(expected(0, 0) * (n - 1) / n));
+
+        tensor<double, dynamic, dynamic> pair({n, 2});
+        for (std::size_t i = 0; i < n; ++i) {
+            pair(i, 0) = X(i, 0);
+            pair(i, 1) = X(i, 1);
+        }
+        auto R = correlation(pair);
+        CHECK(R(0, 0) == 1.0);
+        CHECK(R(0, 1) == doctest::Approx(expected(0, 1) / std::sqrt(expected(0, 0) * expected(1, 1))));
+        CHECK(R(0, 1) == R(1, 0));
+        CHECK(R(0, 1) < -0.9);
+
+        tensor<double, shape<2, 2>> tiny{1.0, 3.0, 2.0, 6.0};
+        CHECK(covariance(tiny)(0, 1) == doctest::Approx(4.0));
+        tensor<double, dynamic, dynamic, error_checking::enabled> one({1, 2}, 1.0);
+        CHECK_THROWS_AS(covariance(one), std::invalid_argument);
+    }
+
+    SUBCASE("accumulator") {
+        moment_accumulator<double> single(3);
+        moment_accumulator<double> other(3);
+        for (std::size_t i = 0; i < n; ++i) {
+            single.add(tensor<double, dynamic, dynamic>({3}, std::vector<double>{X(i, 0), X(i, 1), X(i, 2)}));
+        }
+        CHECK(single.count() == n);
+        CHECK(approx_all_close(single.covariance(), expected, 1e-9, 1e-9));
+        CHECK(single.mean()(0) == doctest::Approx(mean[0]));
+
+        moment_accumulator<double> first(3);
+        first.add(X.subview({400, 3}, {0, 0}));
+        other.add(X.subview({600, 3}, {400, 0}));
+        first.merge(other);
+        CHECK(first.count() == n);
+        CHECK(approx_all_close(first.covariance(), expected, 1e-9, 1e-9));
+        CHECK(approx_all_close(first.mean(), single.mean(), 1e-12, 1e-9));
+        CHECK_THROWS_AS(first.add(tensor<double, dynamic, dynamic>({2}, 0.0)), std::invalid_argument);
+        CHECK_THROWS_AS(first.merge(moment_accumulator<double>(2)), std::invalid_argument);
+        CHECK_THROWS_AS(moment_accumulator<double>(3).covariance(), std::invalid_argument);
+
+        moment_accumulator<long double> extended(3);
+        extended.add(X.subview({n, 3}, {0, 0}));
+        CHECK(static_cast<double>(extended.covariance()(0, 1)) == doctest::Approx(expected(0, 1)));
+    }
+
+    SUBCASE("moments") {
+        auto columns = moments(X, 0, 1);
+        CHECK(columns.mean.shape() == std::vector<std::size_t>{1, 3});
+        CHECK(columns.mean(0, 1) == doctest::Approx(mean[1]));
+        CHECK(columns.variance(0, 0) == doctest::Approx(expected(0, 0)));
+        CHECK(columns.variance(0, 2) == 0.0);
+
+        tensor<float, shape<2, 3>> a{1, 4, 2, 5, 3, 6};
+        auto [row_mean, row_variance] = moments(a, 1);
+        CHECK(row_mean.shape() == std::vector<std::size_t>{2, 1});
+        CHECK(row_mean(0, 0) == doctest::Approx(2.0F));
+        CHECK(row_mean(1, 0) == doctest::Approx(5.0F));
+        CHECK(row_variance(1, 0) == doctest::Approx(2.0F / 3.0F));
+        auto transposed = moments(a.transpose(), 0);
+        CHECK(transposed.mean(0, 1) == doctest::Approx(5.0F));
+
+        tensor<length, shape<4>> lengths{length(1.0F), length(2.0F), length(3.0F), length(4.0F)};
+        auto spread = moments(lengths);
+        CHECK(spread.mean(0) == length(2.5F));
+        static_assert(std::is_same_v<decltype(spread.variance)::value_type, decltype(length{} * length{})>);
+        CHECK(spread.variance(0).value() == doctest::Approx(1.25F));
+
+        CHECK_THROWS_AS(moments(a, 1, 3), std::invalid_argument);
+        CHECK(moments(a, 1, 2).variance(0, 0) == doctest::Approx(2.0F));
+    }
+}
+
+TEST_CASE("Histograms and quantiles") {
+    const std::size_t n = 100000;
+    tensor<double, dynamic, dynamic> values({n});
+    for (std::size_t i = 0; i < n; ++i) {
+        values(i) = static_cast<double>((i * 7919) % n) / static_cast<double>(n);
+    }
+
+    SUBCASE("histogram") {
+        auto h = histogram(values, 10, 0.0, 1.0);
+        CHECK(h.counts.shape() == std::vector<std::size_t>{10});
+        CHECK(h.edges.shape() == std::vector<std::size_t>{11});
+        CHECK(h.edges(10) == 1.0);
+        for (std::size_t b = 0; b < 10; ++b) {
+            CHECK(h.counts(b) == n / 10);
+        }
+
+        tensor<int, shape<2, 4>> small{0, 1, 2, 3, 4, 4, -1, 9};
+        auto edges_included = histogram(small, 4, 0.0, 4.0);
+        CHECK(edges_included.counts(0) == 1);
+        CHECK(edges_included.counts(3) == 3);
+        auto automatic = histogram(small, 2);
+        CHECK(automatic.edges(0) == -1.0);
+        CHECK(automatic.edges(2) == 9.0);
+        CHECK(automatic.counts(0) + automatic.counts(1) == 8);
+        auto rows = histogram(small.transpose().subview<2, 2>(0, 0), 4, 0.0, 4.0);
+        CHECK(rows.counts(0) == 1);
+        CHECK(rows.counts(1) == 1);
+        CHECK(rows.counts(2) == 1);
+        CHECK(rows.counts(3) == 1);
+        auto first_row = histogram(small.subview<1, 4>(0, 0), 4, 0.0, 4.0);
+        CHECK(first_row.counts(0) == 1);
+        CHECK(first_row.counts(1) == 0);
+        CHECK(first_row.counts(2) == 1);
+        CHECK(first_row.counts(3) == 1);
+
+        tensor<float, dynamic, dynamic, error_checking::enabled> constant({3}, 2.0F);
+        CHECK(histogram(constant, 1).counts(0) == 3);
+        CHECK_THROWS_AS(histogram(constant, 0), std::invalid_argument);
+        CHECK_THROWS_AS(histogram(constant, 4, 1.0, 1.0), std::invalid_argument);
+    }
+
+    SUBCASE("quantiles") {
+        auto estimates = approx_quantiles(values, {0.5, 0.99});
+        CHECK(estimates[0] == doctest::Approx(0.5).epsilon(0.01));
+        CHECK(estimates[1] == doctest::Approx(0.99).epsilon(0.01));
+        CHECK(approx_quantile(values.subview({1000}, {0}), 0.9) == doctest::Approx(0.9).epsilon(0.05));
+        auto extremes = approx_quantiles(values, {0.0, 1.0});
+        CHECK(extremes[0] == 0.0);
+        CHECK(extremes[1] == static_cast<double>(n - 1) / static_cast<double>(n));
+
+        p2_quantile<float> median(0.5);
+        CHECK_THROWS_AS(median.value(), std::invalid_argument);
+        median.add(3.0F);
+        median.add(1.0F);
+        CHECK(median.value() == 2.0F);
+        median.add(2.0F);
+        CHECK(median.count() == 3);
+        CHECK(median.value() == 2.0F);
+        CHECK(approx_quantile(tensor<int, shape<3>>{5, 1, 3}, 1.0) == 5.0);
+        CHECK_THROWS_AS(p2_quantile<double>(1.5), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Interpolation") {
+    SUBCASE("interp1d") {
+        tensor<double, shape<4>> xp{0.0, 1.0, 2.0, 4.0};
+        tensor<double, shape<4>> fp{0.0, 10.0, 30.0, 70.0};
+        tensor<double, shape<2, 3>> x{-1.0, 0.5, 1.0, 3.0, 4.0, 5.0};
+        auto y = interp1d(xp, fp, x);
+        CHECK(y.shape() == std::vector<std::size_t>{2, 3});
+        CHECK(y(0, 0) == 0.0);
+        CHECK(y(1, 0) == doctest::Approx(5.0));
+        CHECK(y(0, 1) == doctest::Approx(10.0));
+        CHECK(y(1, 1) == doctest::Approx(50.0));
+        CHECK(y(0, 2) == doctest::Approx(70.0));
+        CHECK(y(1, 2) == 70.0);
+
+        // Sorted and unsorted queries agree
+        const std::size_t n = 10000;
+        tensor<double, dynamic, dynamic> sorted({n});
+        tensor<double, dynamic, dynamic> shuffled({n});
+        for (std::size_t i = 0; i < n; ++i) {
+            sorted(i) = 4.0 * static_cast<double>(i) / static_cast<double>(n);
+            shuffled(i) = 4.0 * static_cast<double>((i * 7919) % n) / static_cast<double>(n);
+        }
+        auto a = interp1d(xp, fp, sorted);
+        auto b = interp1d(xp, fp, shuffled);
+        for (std::size_t i = 0; i < n; i += 97) {
+            CHECK(a((i * 7919) % n) == doctest::Approx(b(i)));
+        }
+
+        tensor<temperature, shape<3>> kelvin{temperature(250.0F), temperature(300.0F), temperature(350.0F)};
+        tensor<density, shape<3>> rho{density(1.2F), density(1.0F), density(0.9F)};
+        auto looked_up = interp1d(kelvin, rho, tensor<temperature, shape<2>>{temperature(275.0F), temperature(340.0F)});
+        static_assert(std::is_same_v<decltype(looked_up)::value_type, density>);
+        CHECK(looked_up(0).value() == doctest::Approx(1.1F));
+        CHECK(looked_up(1).value() == doctest::Approx(0.92F));
+
+        tensor<double, dynamic, dynamic, error_checking::enabled> descending({3}, std::vector<double>{2.0, 1.0, 0.0});
+        tensor<double, dynamic, dynamic, error_checking::enabled> values({3}, 0.0);
+        CHECK_THROWS_AS(interp1d(descending, values, x), std::invalid_argument);
+        tensor<double, dynamic, dynamic, error_checking::enabled> short_values({2}, 0.0);
+        CHECK_THROWS_AS(interp1d(values, short_values, x), std::invalid_argument);
+    }
+
+    SUBCASE("interp2d") {
+        tensor<double, shape<3>> xp{0.0, 1.0, 2.0};
+        tensor<double, shape<2>> yp{0.0, 10.0};
+        // f(x, y) = x + y / 10 is reproduced exactly by bilinear interpolation
+        tensor<double, shape<3, 2>> fp{0.0, 1.0, 2.0, 1.0, 2.0, 3.0};
+        tensor<double, shape<4>> x{0.5, 1.5, 2.0, -1.0};
+        tensor<double, shape<4>> y{5.0, 2.0, 10.0, 20.0};
+        auto z = interp2d(xp, yp, fp, x, y);
+        CHECK(z(0) == doctest::Approx(1.0));
+        CHECK(z(1) == doctest::Approx(1.7));
+        CHECK(z(2) == doctest::Approx(3.0));
+        CHECK(z(3) == doctest::Approx(1.0));
+        tensor<double, dynamic, dynamic, error_checking::enabled> checked_xp({3}, std::vector<double>{0.0, 1.0, 2.0});
+        CHECK_THROWS_AS(interp2d(checked_xp, yp, fp, x, tensor<double, shape<3>>{}), std::invalid_argument);
+    }
+
+    SUBCASE("cubic spline") {
+        // A natural spline reproduces a straight line
+        tensor<double, shape<5>> xp{0.0, 1.0, 3.0, 4.0, 7.0};
+        tensor<double, shape<5>> line{1.0, 3.0, 7.0, 9.0, 15.0};
+        cubic_spline straight(xp, line);
+        CHECK(straight(2.0) == doctest::Approx(5.0));
+        CHECK(straight(8.0) == doctest::Approx(17.0));
+
+        const std::size_t n = 41;
+        tensor<double, dynamic, dynamic> knots({n});
+        tensor<double, dynamic, dynamic> samples({n});
+        for (std::size_t i = 0; i < n; ++i) {
+            knots(i) = 0.1 * static_cast<double>(i);
+            samples(i) = std::sin(knots(i));
+        }
+        cubic_spline<double, double> sine(knots, samples);
+        tensor<double, shape<2, 2>> queries{0.05, 1.234, 2.5, 3.25};
+        auto values = sine(queries);
+        CHECK(values.shape() == std::vector<std::size_t>{2, 2});
+        for (std::size_t i = 0; i < 2; ++i) {
+            for (std::size_t j = 0; j < 2; ++j) {
+                CHECK(values(i, j) == doctest::Approx(std::sin(queries(i, j))).epsilon(1e-4));
+                CHECK(values(i, j) == sine(queries(i, j)));
+            }
+        }
+        CHECK(sine(0.0) == doctest::Approx(0.0));
+        CHECK(sine(4.0) == doctest::Approx(std::sin(4.0)));
+
+        tensor<length, shape<2>> positions{length(0.0F), length(2.0F)};
+        tensor<temperature, shape<2>> temperatures{temperature(300.0F), temperature(310.0F)};
+        cubic_spline profile(positions, temperatures);
+        CHECK(profile(length(1.0F)).value() == doctest::Approx(305.0F));
+        CHECK_THROWS_AS(cubic_spline(line, xp.subview<2>(0)), std::invalid_argument);
+    }
+}
+
+TEST_CASE("ODE integration") {
+    SUBCASE("rk4 with quantities") {
+        // Exponential decay of lengths, dy/dt = -y / tau
+        const duration tau(2.0F);
+        auto decay = [&](duration /*t*/, const tensor<length, shape<3>> &y, tensor<velocity, shape<3>> &dydt) {
+            for (std::size_t i = 0; i < 3; ++i) {
+                dydt(i) = -y(i) / tau;
+            }
+        };
+        tensor<length, shape<3>> y{length(1.0F), length(2.0F), length(4.0F)};
+        integrate_rk4(decay, y, duration(0.0F), duration(1.0F), 20);
+        const float factor = std::exp(-0.5F);
+        CHECK(y(0).value() == doctest::Approx(factor));
+        CHECK(y(2).value() == doctest::Approx(4.0F * factor));
+
+        // The right-hand side may also return the derivative
+        tensor<double, shape<2>> z{1.0, 0.0};
+        rk4_stepper<tensor<double, shape<2>>, double> stepper(z);
+        auto rotation = [](double /*t*/, const tensor<double, shape<2>> &s) {
+            return tensor<double, shape<2>>{s(1), -s(0)};
+        };
+        for (int i = 0; i < 100; ++i) {
+            stepper.step(rotation, 0.01 * i, z, 0.01);
+        }
+        CHECK(z(0) == doctest::Approx(std::cos(1.0)).epsilon(1e-8));
+        CHECK(z(1) == doctest::Approx(-std::sin(1.0)).epsilon(1e-8));
+    }
+
+    SUBCASE("adaptive") {
+        // A batch of independent oscillators x'' = -w^2 x, one per column of a {2, n} state
+        const std::size_t n = 50;
+        tensor<double, dynamic, dynamic> y({2, n});
+        for (std::size_t j = 0; j < n; ++j) {
+            y(0, j) = 1.0;
+            y(1, j) = 0.0;
+        }
+        auto oscillators = [&](double /*t*/, const tensor<double, dynamic, dynamic> &s,
+                               tensor<double, dynamic, dynamic> &dsdt) {
+            for (std::size_t j = 0; j < n; ++j) {
+                const double w = 1.0 + 0.1 * static_cast<double>(j);
+                dsdt(0, j) = s(1, j);
+                dsdt(1, j) = -w * w * s(0, j);
+            }
+        };
+        auto stats = integrate_adaptive(oscillators, y, 0.0, 3.0, 1e-9, 1e-12);
+        CHECK(stats.accepted > 0);
+        CHECK(stats.evaluations == 1 + 6 * (stats.accepted + stats.rejected));
+        for (std::size_t j = 0; j < n; j += 7) {
+            const double w = 1.0 + 0.1 * static_cast<double>(j);
+            CHECK(y(0, j) == doctest::Approx(std::cos(3.0 * w)).epsilon(1e-6));
+            CHECK(y(1, j) == doctest::Approx(-w * std::sin(3.0 * w)).epsilon(1e-6));
+        }
+
+        // Integrating backwards returns to the initial state, and looser tolerances take fewer steps
+        auto loose = integrate_adaptive(oscillators, y, 3.0, 0.0, 1e-4, 1e-7);
+        CHECK(loose.accepted < stats.accepted);
+        CHECK(y(0, n - 1) == doctest::Approx(1.0).epsilon(1e-3));
+
+        // Idle systems stacked next to an active one do not change its steps
+        const std::size_t systems = 1000;
+        auto fast = [](double /*t*/, const tensor<double, dynamic, dynamic> &s,
+                       tensor<double, dynamic, dynamic> &dsdt) {
+            for (std::size_t j = 0; j < s.shape()[1]; ++j) {
+                const double w = j == 0 ? 20.0 : 0.0;
+                dsdt(0, j) = s(1, j);
+                dsdt(1, j) = -w * w * s(0, j);
+            }
+        };
+        tensor<double, dynamic, dynamic> single({2, 1}, std::vector<double>{1.0, 0.0});
+        tensor<double, dynamic, dynamic> batch({2, systems});
+        for (std::size_t j = 0; j < systems; ++j) {
+            batch(0, j) = 1.0;
+            batch(1, j) = 0.0;
+        }
+        auto alone = integrate_adaptive(fast, single, 0.0, 10.0);
+        auto together = integrate_adaptive(fast, batch, 0.0, 10.0);
+        CHECK(together.accepted == alone.accepted);
+        CHECK(together.rejected == alone.rejected);
+        CHECK(batch(0, 0) == single(0, 0));
+        CHECK(batch(1, 0) == single(1, 0));
+        CHECK(batch(0, systems - 1) == 1.0);
+        CHECK(std::abs(single(0, 0) - std::cos(200.0)) < 1e-4);
+
+        tensor<double, dynamic, dynamic, error_checking::enabled> checked({2}, 1.0);
+        dormand_prince_stepper<decltype(checked), double> stepper(checked);
+        tensor<double, dynamic, dynamic, error_checking::enabled> other({3}, 1.0);
+        auto zero = [](double /*t*/, const auto & /*s*/, auto &dsdt) { dsdt *= 0.0; };
+        CHECK_THROWS_AS(stepper.integrate(zero, other, 0.0, 1.0, 0.1), std::invalid_argument);
+        CHECK(stepper.integrate(zero, checked, 0.0, 1.0, 0.1).rejected == 0);
+        CHECK_THROWS_AS((dormand_prince_stepper<decltype(checked), double>(checked, 0.0, 0.0)), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Automatic differentiation") {
+    using d2 = dual<double, 2>;
+
+    SUBCASE("dual numbers") {
+        const auto x = d2::variable(2.0, 0);
+        const auto y = d2::variable(3.0, 1);
+        const auto f = x * x * y + sin(x) / y - 1.0;
+        CHECK(f.value() == doctest::Approx(12.0 + std::sin(2.0) / 3.0 - 1.0));
+        CHECK(f.derivative(0) == doctest::Approx(2 * 2.0 * 3.0 + std::cos(2.0) / 3.0));
+        CHECK(f.derivative(1) == doctest::Approx(4.0 - std::sin(2.0) / 9.0));
+        const auto g = sqrt(exp(x) + log(y));
+        CHECK(g.derivative(0) == doctest::Approx(std::exp(2.0) / (2 * g.value())));
+        CHECK(pow(y, 2.0).derivative(1) == doctest::Approx(6.0));
+        CHECK(2.0 / x == d2(1.0));
+        CHECK((2.0 / x).derivative(0) == doctest::Approx(-0.5));
+        CHECK(x < y);
+
+        // Integer literals convert to the element type on either side
+        CHECK(2 * x == 2.0 * x);
+        CHECK((x * 3).derivative(0) == 3.0);
+        CHECK((1 - x).derivative(0) == -1.0);
+        CHECK((x / 2).derivative(0) == 0.5);
+        CHECK((x + 1).value() == 3.0);
+        CHECK((4 / x).derivative(0) == doctest::Approx(-1.0));
+        CHECK(pow(y, 2).derivative(1) == doctest::Approx(6.0));
+
+        // Quantities of dual numbers carry units and derivatives together
+        using dual_length = quantity<d2, dimensions::L>;
+        const dual_length width(x);
+        const dual_length height(y);
+        const auto area = width * height;
+        static_assert(std::is_same_v<decltype(area), const quantity<d2, dim_mult_t<dimensions::L, dimensions::L>>>);
+        CHECK(area.value().value() == 6.0);
+        CHECK(area.value().derivative(0) == 3.0);
+        CHECK((area / width).value().derivative(1) == doctest::Approx(1.0));
+    }
+
+    SUBCASE("tensors of dual numbers") {
+        tensor<d2, shape<2, 2>> A{d2::variable(1.0, 0), 2.0, 3.0, d2::variable(4.0, 1)};
+        tensor<double, shape<2>> v{1.0, 1.0};
+        auto w = A * v;
+        static_assert(std::is_same_v<decltype(w), tensor<d2, shape<2, 1>>>);
+        CHECK(w(0, 0).value() == 4.0);
+        CHECK(w(0, 0).derivative(0) == 1.0);
+        CHECK(w(1, 0).derivative(1) == 1.0);
+
+        // Product rule against a direct element-wise evaluation
+        tensor<d2, dynamic, dynamic> B({2, 3});
+        tensor<d2, dynamic, dynamic> C({3, 2});
+        for (std::size_t i = 0; i < 2; ++i) {
+            for (std::size_t j = 0; j < 3; ++j) {
+                B(i, j) = d2(1.0 + i + 2.0 * j, {static_cast<double>(i), 1.0});
+                C(j, i) = d2(0.5 * j - i, {2.0, static_cast<double>(j)});
+            }
+        }
+        auto D = B * C;
+        CHECK(D.shape() == std::vector<std::size_t>{2, 2});
+        for (std::size_t i = 0; i < 2; ++i) {
+            for (std::size_t j = 0; j < 2; ++j) {
+                d2 expected;
+                for (std::size_t p = 0; p < 3; ++p) {
+                    expected += B(i, p) * C(p, j);
+                }
+                CHECK(D(i, j).value() == doctest::Approx(expected.value()));
+                CHECK(D(i, j).derivative(0) == doctest::Approx(expected.derivative(0)));
+                CHECK(D(i, j).derivative(1) == doctest::Approx(expected.derivative(1)));
+            }
+        }
+        auto transposed = B.transpose() * dual_values(B);
+        CHECK(transposed(2, 1).derivative(0) == doctest::Approx(B(1, 2).derivative(0) * B(1, 1).value()));
+        CHECK(dual_derivatives(B, 0)(1, 2) == 1.0);
+
+        auto sum = B + B;
+        CHECK(sum(1, 1).derivative(1) == 2.0);
+        auto scaled = B * 3.0;
+        CHECK(scaled(1, 0).derivative(0) == 3.0);
+    }
+
+    SUBCASE("jacobian") {
+        // f(x) = A x + x0^2 for a 3x5 matrix A, differentiated in chunks of two variables
+        tensor<double, dynamic, dynamic> A({3, 5});
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 5; ++j) {
+                A(i, j) = static_cast<double>(i * 5 + j);
+            }
+        }
+        tensor<double, dynamic, dynamic> x({5}, std::vector<double>{1.0, 2.0, 3.0, 4.0, 5.0});
+        std::size_t calls = 0;
+        auto f = [&](const auto &z) {
+            ++calls;
+            auto y = A * z;
+            for (std::size_t i = 0; i < 3; ++i) {
+                y(i, 0) += z(0) * z(0);
+            }
+            return y;
+        };
+        auto J = jacobian<2>(f, x);
+        auto literal = jacobian(
+            [](const auto &z) {
+                auto y = 2 * z;
+                y(0) = 1 - y(0) * 3;
+                return y;
+            },
+            x);
+        CHECK(literal.value(0, 0) == -5.0);
+        CHECK(literal.jacobian(0, 0) == -6.0);
+        CHECK(literal.jacobian(3, 3) == 2.0);
+        CHECK(literal.jacobian(3, 2) == 0.0);
+        CHECK(calls == 3);
+        CHECK(J.value.shape() == std::vector<std::size_t>{3, 1});
+        CHECK(J.jacobian.shape() == std::vector<std::size_t>{3, 5});
+        CHECK(J.value(0, 0) == doctest::Approx(40.0 + 1.0));
+        for (std::size_t i = 0; i < 3; ++i) {
+            CHECK(J.jacobian(i, 0) == doctest::Approx(A(i, 0) + 2.0));
+            for (std::size_t j = 1; j < 5; ++j) {
+                CHECK(J.jacobian(i, j) == A(i, j));
+            }
+        }
+        auto single = jacobian(f, x);
+        CHECK(approx_equal(single.jacobian, J.jacobian));
+    }
+}
+
 // NOLINTEND
\ No newline at end of file
@@ -574,6 +574,215 @@ TEST_CASE("Tensor Shape Manipulation") {
     }
 }
 
+TEST_CASE("Dynamic Tensor Growth") {
+    using dyn_tensor = squint::tensor<float, squint::dynamic, squint::dynamic>;
+
+    SUBCASE("Append columns to column-major tensor") {
+        dyn_tensor t({3, 0});
+        CHECK(t.growth_axis() == 1);
+        t.reserve(4);
+        CHECK(t.capacity() >= 4);
+        const auto *storage = t.data();
+        for (int j = 0; j < 4; ++j) {
+            squint::tensor<float, squint::shape<3>> column{static_cast<float>(j), static_cast<float>(10 * j),
+                                                           static_cast<float>(100 * j)};
+            t.append(column);
+        }
+        CHECK(t.data() == storage);
+        CHECK(t.shape() == std::vector<std::size_t>{3, 4});
+        CHECK(t.strides() == std::vector<std::size_t>{1, 3});
+        CHECK(t(1, 2) == 20);
+        CHECK(t(2, 3) == 300);
+
+        dyn_tensor block({3, 2}, std::vector<float>{1, 2, 3, 4, 5, 6});
+        t.append(block);
+        CHECK(t.shape() == std::vector<std::size_t>{3, 6});
+        CHECK(t(0, 4) == 1);
+        CHECK(t(2, 5) == 6);
+        CHECK(t(2, 3) == 300);
+    }
+
+    SUBCASE("Append rows to row-major tensor") {
+        dyn_tensor t({0, 3}, squint::layout::row_major);
+        CHECK(t.growth_axis() == 0);
+        for (int i = 0; i < 100; ++i) {
+            squint::tensor<float, squint::shape<3>> row{static_cast<float>(i), static_cast<float>(i + 1),
+                                                        static_cast<float>(i + 2)};
+            t.append_row(row);
+        }
+        CHECK(t.shape() == std::vector<std::size_t>{100, 3});
+        CHECK(t.strides() == std::vector<std::size_t>{3, 1});
+        CHECK(t(42, 0) == 42);
+        CHECK(t(99, 2) == 101);
+        t.shrink_to_fit();
+        CHECK(t.capacity() == 100);
+    }
+
+    SUBCASE("Append rows to column-major tensor") {
+        dyn_tensor t({2, 3}, std::vector<float>{1, 2, 3, 4, 5, 6});
+        squint::tensor<float, squint::shape<3>> row{7, 8, 9};
+        t.append_row(row);
+        CHECK(t.shape() == std::vector<std::size_t>{3, 3});
+        CHECK(t.strides() == std::vector<std::size_t>{1, 3});
+        CHECK(t(0, 0) == 1);
+        CHECK(t(1, 0) == 2);
+        CHECK(t(2, 0) == 7);
+        CHECK(t(0, 2) == 5);
+        CHECK(t(1, 2) == 6);
+        CHECK(t(2, 2) == 9);
+
+        dyn_tensor rows({2, 3}, std::vector<float>{10, 11, 12, 13, 14, 15});
+        t.append_row(rows);
+        CHECK(t.shape() == std::vector<std::size_t>{5, 3});
+        CHECK(t(3, 0) == 10);
+        CHECK(t(4, 2) == 15);
+        CHECK(t(2, 1) == 8);
+    }
+
+    SUBCASE("Layouts whose strides coincide") {
+        dyn_tensor t({1, 1}, std::vector<float>{1}, squint::layout::row_major);
+        CHECK(t.growth_axis() == 0);
+        squint::tensor<float, squint::shape<1>> row{2};
+        t.append(row);
+        CHECK(t.shape() == std::vector<std::size_t>{2, 1});
+        CHECK(t(1, 0) == 2);
+        dyn_tensor copied = t;
+        CHECK(copied.growth_axis() == 0);
+        dyn_tensor c({1, 1}, std::vector<float>{1});
+        CHECK(c.growth_axis() == 1);
+    }
+
+    SUBCASE("Appending a view of the tensor itself") {
+        dyn_tensor t({2, 2}, std::vector<float>{1, 2, 3, 4});
+        for (int i = 0; i < 6; ++i) {
+            t.append(t.subview({2, 1}, {0, 0}));
+        }
+        CHECK(t.shape() == std::vector<std::size_t>{2, 8});
+        CHECK(t(0, 7) == 1);
+        CHECK(t(1, 7) == 2);
+        t.append(t);
+        CHECK(t.shape() == std::vector<std::size_t>{2, 16});
+        CHECK(t(1, 9) == 4);
+        t.append_row(t.subview({1, 16}, {1, 0}));
+        CHECK(t.shape() == std::vector<std::size_t>{3, 16});
+        CHECK(t(2, 1) == 4);
+        CHECK(t(1, 1) == 4);
+    }
+
+    SUBCASE("Tensors with strides other than those of their layout") {
+        // Column-major by layout, but the last two axes are stored interleaved
+        const std::vector<std::size_t> strides{1, 4, 2};
+        auto fill = [](dyn_tensor &t) {
+            for (std::size_t i = 0; i < 2; ++i) {
+                for (std::size_t j = 0; j < 3; ++j) {
+                    for (std::size_t k = 0; k < 2; ++k) {
+                        t(i, j, k) = static_cast<float>(100 * i + 10 * j + k);
+                    }
+                }
+            }
+        };
+        auto unchanged = [](const dyn_tensor &t) {
+            bool same = true;
+            for (std::size_t i = 0; i < 2; ++i) {
+                for (std::size_t j = 0; j < 3; ++j) {
+                    for (std::size_t k = 0; k < 2; ++k) {
+                        same = same && t(i, j, k) == static_cast<float>(100 * i + 10 * j + k);
+                    }
+                }
+            }
+            return same;
+        };
+        dyn_tensor t(std::vector<std::size_t>{2, 3, 2}, strides);
+        fill(t);
+        t.append(squint::tensor<float, squint::shape<2, 3>>::ones());
+        CHECK(t.shape() == std::vector<std::size_t>{2, 3, 3});
+        CHECK(unchanged(t));
+        CHECK(t(1, 2, 2) == 1);
+        dyn_tensor r(std::vector<std::size_t>{2, 3, 2}, strides);
+        fill(r);
+        r.append_row(squint::tensor<float, squint::shape<3, 2>>::ones());
+        CHECK(r.shape() == std::vector<std::size_t>{3, 3, 2});
+        CHECK(unchanged(r));
+        CHECK(r(2, 1, 1) == 1);
+    }
+
+    SUBCASE("Shape mismatch") {
+        squint::tensor<float, squint::dynamic, squint::dynamic, squint::error_checking::enabled> t({3, 2});
+        squint::tensor<float, squint::shape<2>> wrong_column{1, 2};
+        squint::tensor<float, squint::shape<3>> wrong_row{1, 2, 3};
+        CHECK_THROWS_AS(t.append(wrong_column), std::invalid_argument);
+        CHECK_THROWS_AS(t.append_row(wrong_row), std::invalid_argument);
+        CHECK(t.shape() == std::vector<std::size_t>{3, 2});
+    }
+}
+
+TEST_CASE("Ring Buffer") {
+    SUBCASE("Window and segments") {
+        squint::ring_buffer<float> buffer(2, 3);
+        CHECK(buffer.empty());
+        for (int k = 0; k < 5; ++k) {
+            squint::tensor<float, squint::shape<2>> sample{static_cast<float>(k), static_cast<float>(10 * k)};
+            buffer.push(sample);
+        }
+        CHECK(buffer.full());
+        CHECK(buffer.size() == 3);
+        CHECK(buffer(0, 0) == 2);
+        CHECK(buffer(1, 2) == 40);
+        CHECK(buffer.latest()(1) == 40);
+
+        auto [older, newer] = buffer.segments();
+        CHECK(older.shape() == std::vector<std::size_t>{2, 1});
+        CHECK(newer.shape() == std::vector<std::size_t>{2, 2});
+        CHECK(older(0, 0) == 2);
+        CHECK(newer(0, 0) == 3);
+        CHECK(newer(1, 1) == 40);
+    }
+
+    SUBCASE("Running statistics") {
+        squint::ring_buffer<double> buffer(1, 4);
+        std::vector<double> samples{1, 5, 2, 8, 3, 9, 4, 6};
+        for (std::size_t k = 0; k < samples.size(); ++k) {
+            buffer.push(squint::tensor<double, squint::shape<1>>{samples[k]});
+            const std::size_t first = k >= 3 ? k - 3 : 0;
+            double mean = 0;
+            for (std::size_t i = first; i <= k; ++i) {
+                mean += samples[i];
+            }
+            mean /= static_cast<double>(k - first + 1);
+            double variance = 0;
+            for (std::size_t i = first; i <= k; ++i) {
+                variance += (samples[i] - mean) * (samples[i] - mean);
+            }
+            variance /= static_cast<double>(k - first + 1);
+            CHECK(buffer.mean()(0) == doctest::Approx(mean));
+            CHECK(buffer.sum()(0) == doctest::Approx(mean * static_cast<double>(k - first + 1)));
+            CHECK(buffer.variance()(0) == doctest::Approx(variance));
+        }
+        buffer.recompute_statistics();
+        CHECK(buffer.mean()(0) == doctest::Approx(5.5));
+        buffer.clear();
+        CHECK(buffer.empty());
+        CHECK(buffer.mean()(0) == 0);
+    }
+
+    SUBCASE("Quantities") {
+        squint::ring_buffer<squint::length> buffer(1, 2);
+        buffer.push(squint::tensor<squint::length, squint::shape<1>>{squint::length(1.0F)});
+        buffer.push(squint::tensor<squint::length, squint::shape<1>>{squint::length(3.0F)});
+        auto variance = buffer.variance();
+        static_assert(std::is_same_v<decltype(variance)::value_type, squint::area>);
+        CHECK(variance(0).value() == doctest::Approx(1.0F));
+        CHECK(buffer.mean()(0).value() == doctest::Approx(2.0F));
+    }
+
+    SUBCASE("Invalid samples") {
+        squint::ring_buffer<float> buffer(3, 2);
+        squint::tensor<float, squint::shape<2>> sample{1, 2};
+        CHECK_THROWS_AS(buffer.push(sample), std::invalid_argument);
+        CHECK_THROWS_AS(squint::ring_buffer<float>(0, 2), std::invalid_argument);
+    }
+}
+
 TEST_CASE("Tensor Iteration Methods") {
     squint::tensor<float, squint::shape<2, 3>> t{1, 4, 2, 5, 3, 6};
 